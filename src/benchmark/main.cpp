@@ -0,0 +1,272 @@
+/**
+ * @file main.cpp
+ * @brief Heartbeat and state snapshot cost benchmark
+ *
+ * Compares the former name-based heartbeat (manager mutex plus a strcmp
+ * scan over the task table) with TaskManager::heartbeat(), once on an idle
+ * system and once while a task on the other core heartbeats continuously.
+ *
+ * Then compares reading a status snapshot through SeqLock with copying it
+ * under a mutex, as the status readers did before, idle and while the
+ * other core writes it back to back. Every read is checked for a torn
+ * copy. Results are printed in CPU cycles per call.
+ */
+
+#include <Arduino.h>
+#include "config.h"
+#include "seqlock.h"
+#include "task_manager.h"
+
+namespace {
+    constexpr uint32_t ITERATIONS = 100000;
+    constexpr uint8_t BENCH_CORE = 1;
+    constexpr uint8_t LOAD_CORE = 0;
+
+    /**
+     * @brief Copy of the lookup the name-based heartbeat performed
+     *
+     * Every slot is active, and the benchmarked task sits in the last one,
+     * as the worst case of the scan.
+     */
+    class LegacyRegistry {
+    public:
+        LegacyRegistry() : mutex(xSemaphoreCreateMutex()) {
+            for (size_t i = 0; i < Config::TaskManager::MAX_TASKS; i++) {
+                snprintf(names[i], sizeof(names[i]), "Task%u", static_cast<unsigned>(i));
+                lastRunTime[i] = 0;
+            }
+        }
+
+        const char* lastName() const { return names[Config::TaskManager::MAX_TASKS - 1]; }
+
+        void updateTaskRunTime(const char* taskName) {
+            if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
+                for (size_t i = 0; i < Config::TaskManager::MAX_TASKS; i++) {
+                    if (strcmp(names[i], taskName) == 0) {
+                        lastRunTime[i] = millis();
+                        break;
+                    }
+                }
+                xSemaphoreGive(mutex);
+            }
+        }
+
+    private:
+        SemaphoreHandle_t mutex;
+        char names[Config::TaskManager::MAX_TASKS][16];
+        volatile uint32_t lastRunTime[Config::TaskManager::MAX_TASKS];
+    };
+
+    /**
+     * @brief Stand-in for FanController::Snapshot, about its size with two fans
+     *
+     * The writer stores the same sequence number in every word, so a copy
+     * mixing two writes shows up as differing words.
+     */
+    struct Payload {
+        uint32_t words[32];
+
+        void fill(uint32_t value) {
+            for (uint32_t& word : words) word = value;
+        }
+
+        bool isTorn() const {
+            for (uint32_t word : words) {
+                if (word != words[0]) return true;
+            }
+            return false;
+        }
+    };
+
+    /**
+     * @brief Mutex-guarded copy, as the status readers took it before SeqLock
+     */
+    class MutexPayload {
+    public:
+        MutexPayload() : mutex(xSemaphoreCreateMutex()), data{} {}
+
+        void write(const Payload& value) {
+            if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
+                data = value;
+                xSemaphoreGive(mutex);
+            }
+        }
+
+        Payload read() {
+            Payload copy = {};
+            if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
+                copy = data;
+                xSemaphoreGive(mutex);
+            }
+            return copy;
+        }
+
+    private:
+        SemaphoreHandle_t mutex;
+        Payload data;
+    };
+
+    // What the task on the other core does during a pass
+    enum class Load : uint8_t {
+        NONE,
+        LEGACY_HEARTBEAT,
+        HEARTBEAT,
+        SEQLOCK_WRITE,
+        MUTEX_WRITE,
+        SEQLOCK_READ,
+    };
+
+    TaskManager taskManager;
+    LegacyRegistry legacy;
+    SeqLock<Payload> seqPayload;
+    MutexPayload mutexPayload;
+    TaskManager::TaskId benchId;
+    TaskManager::TaskId loadId;
+    volatile Load load = Load::NONE;
+
+    float cyclesPerCall(uint32_t start, uint32_t end) {
+        return static_cast<float>(end - start) / ITERATIONS;
+    }
+
+    /**
+     * @param contended Keep the other core heartbeating the same way: the
+     *                  legacy pass then contends for the mutex, the slot
+     *                  pass writes a neighbouring heartbeat slot
+     */
+    void runPass(const char* label, bool contended) {
+        load = contended ? Load::LEGACY_HEARTBEAT : Load::NONE;
+        uint32_t start = ESP.getCycleCount();
+        for (uint32_t i = 0; i < ITERATIONS; i++) {
+            legacy.updateTaskRunTime(legacy.lastName());
+        }
+        float legacyCycles = cyclesPerCall(start, ESP.getCycleCount());
+
+        load = contended ? Load::HEARTBEAT : Load::NONE;
+        start = ESP.getCycleCount();
+        for (uint32_t i = 0; i < ITERATIONS; i++) {
+            taskManager.heartbeat(benchId);
+        }
+        float slotCycles = cyclesPerCall(start, ESP.getCycleCount());
+        load = Load::NONE;
+
+        Serial.printf("%-12s legacy %8.1f cycles/call   slot %6.1f cycles/call   %5.1fx\r\n",
+                      label, legacyCycles, slotCycles, legacyCycles / slotCycles);
+    }
+
+    /**
+     * @param contended Keep the other core writing the payload back to back:
+     *                  the worst case for the seqlock readers, which retry
+     *                  on every overlapping write
+     */
+    void runReadPass(const char* label, bool contended) {
+        uint32_t torn = 0;
+
+        load = contended ? Load::MUTEX_WRITE : Load::NONE;
+        uint32_t start = ESP.getCycleCount();
+        for (uint32_t i = 0; i < ITERATIONS; i++) {
+            torn += mutexPayload.read().isTorn();
+        }
+        float mutexCycles = cyclesPerCall(start, ESP.getCycleCount());
+
+        load = contended ? Load::SEQLOCK_WRITE : Load::NONE;
+        start = ESP.getCycleCount();
+        for (uint32_t i = 0; i < ITERATIONS; i++) {
+            torn += seqPayload.read().isTorn();
+        }
+        float seqCycles = cyclesPerCall(start, ESP.getCycleCount());
+        load = Load::NONE;
+
+        Serial.printf("%-12s mutex  %8.1f cycles/read   seqlock %6.1f cycles/read   %5.1fx   torn %u\r\n",
+                      label, mutexCycles, seqCycles, mutexCycles / seqCycles, static_cast<unsigned>(torn));
+    }
+
+    /**
+     * @brief Writer cost while the other core reads the payload back to back
+     */
+    void runWritePass(const char* label) {
+        Payload value;
+
+        load = Load::SEQLOCK_READ;
+        uint32_t start = ESP.getCycleCount();
+        for (uint32_t i = 0; i < ITERATIONS; i++) {
+            value.fill(i);
+            seqPayload.write(value);
+        }
+        float seqCycles = cyclesPerCall(start, ESP.getCycleCount());
+        load = Load::NONE;
+
+        Serial.printf("%-12s seqlock write %6.1f cycles/call\r\n", label, seqCycles);
+    }
+
+    // Load for the contended passes, on the other core
+    void loadTask(void*) {
+        Payload value;
+        uint32_t sequence = 0;
+
+        while (true) {
+            switch (load) {
+                case Load::NONE:
+                    vTaskDelay(1);
+                    break;
+                case Load::LEGACY_HEARTBEAT:
+                    legacy.updateTaskRunTime(legacy.lastName());
+                    break;
+                case Load::HEARTBEAT:
+                    taskManager.heartbeat(loadId);
+                    break;
+                case Load::SEQLOCK_WRITE:
+                    value.fill(++sequence);
+                    seqPayload.write(value);
+                    break;
+                case Load::MUTEX_WRITE:
+                    value.fill(++sequence);
+                    mutexPayload.write(value);
+                    break;
+                case Load::SEQLOCK_READ:
+                    seqPayload.read();
+                    break;
+            }
+        }
+    }
+
+    void benchTask(void*) {
+        Serial.printf("\r\nHeartbeat benchmark, %u iterations, %u MHz, %u task slots\r\n",
+                      static_cast<unsigned>(ITERATIONS), static_cast<unsigned>(getCpuFrequencyMhz()),
+                      static_cast<unsigned>(Config::TaskManager::MAX_TASKS));
+
+        runPass("idle", false);
+        runPass("contended", true);
+
+        Serial.printf("\r\nSnapshot benchmark, %u byte payload\r\n",
+                      static_cast<unsigned>(sizeof(Payload)));
+
+        runReadPass("idle", false);
+        runReadPass("contended", true);
+        runWritePass("contended");
+
+        vTaskDelete(nullptr);
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    if (taskManager.begin() != ESP_OK) {
+        Serial.println("TaskManager init failed");
+        return;
+    }
+
+    // The passes are short enough that the load spinning at priority 1
+    // does not trip the idle task watchdog
+    TaskManager::TaskConfig loadConfig("BenchLoad", 2048, 1, LOAD_CORE);
+    TaskManager::TaskConfig benchConfig("BenchMain", 4096, 1, BENCH_CORE);
+    if (taskManager.createTask(loadConfig, loadTask, nullptr, &loadId) != ESP_OK ||
+        taskManager.createTask(benchConfig, benchTask, nullptr, &benchId) != ESP_OK) {
+        Serial.println("Benchmark task creation failed");
+    }
+}
+
+void loop() {
+    vTaskDelay(portMAX_DELAY);
+}
@@ -0,0 +1,37 @@
+/**
+ * @file bitbang_onewire.cpp
+ * @brief OneWire transport on top of the OneWire library
+ */
+
+#include "bitbang_onewire.h"
+
+BitBangOneWire::BitBangOneWire(uint8_t pin)
+    : oneWire(pin) {
+}
+
+bool BitBangOneWire::reset() {
+    return oneWire.reset();
+}
+
+bool BitBangOneWire::write(const uint8_t* data, size_t length, bool holdHigh) {
+    // Only the last byte may leave the line driven high
+    for (size_t i = 0; i < length; i++) {
+        oneWire.write(data[i], holdHigh && i == length - 1);
+    }
+    return true;
+}
+
+bool BitBangOneWire::read(uint8_t* data, size_t length) {
+    oneWire.read_bytes(data, length);
+    return true;
+}
+
+bool BitBangOneWire::writeBit(bool bit) {
+    oneWire.write_bit(bit);
+    return true;
+}
+
+bool BitBangOneWire::readBit(bool& bit) {
+    bit = oneWire.read_bit();
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Arduino.h>
+#include <OneWire.h>
+#include "onewire_transport.h"
+
+/**
+ * @brief OneWire transport timed on the CPU by the OneWire library
+ *
+ * Every slot runs with interrupts masked for up to 70 us, and a
+ * scratchpad read keeps the CPU busy for several milliseconds. Kept for
+ * parasite powered buses, which need the strong pull-up this backend can
+ * drive after a conversion command.
+ */
+class BitBangOneWire : public OneWireTransport {
+public:
+    explicit BitBangOneWire(uint8_t pin);
+
+    // Prevent copying
+    BitBangOneWire(const BitBangOneWire&) = delete;
+    BitBangOneWire& operator=(const BitBangOneWire&) = delete;
+
+    bool begin() override { return true; }
+    bool reset() override;
+    bool write(const uint8_t* data, size_t length, bool holdHigh = false) override;
+    bool read(uint8_t* data, size_t length) override;
+    bool writeBit(bool bit) override;
+    bool readBit(bool& bit) override;
+    const char* getName() const override { return "bitbang"; }
+
+private:
+    OneWire oneWire;
+};
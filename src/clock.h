@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Monotonic microsecond time source
+ *
+ * Timing-driven logic takes a Clock instead of calling esp_timer directly,
+ * so tests can step it through time with a fake. SystemClock in
+ * system_clock.h is the firmware implementation.
+ */
+class Clock {
+public:
+    virtual ~Clock() = default;
+
+    /**
+     * @return Microseconds since boot, wrapping; compare by subtraction
+     */
+    virtual uint32_t nowUs() const = 0;
+};
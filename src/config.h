@@ -1,9 +1,19 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-#include <Arduino.h>
+#include <cstddef>
 #include <cstdint>
+
+#ifdef ARDUINO
+#include <Arduino.h>
 #include "secrets.h"
+#else
+// Host builds (env:native) have no framework: the task settings only need
+// the FreeRTOS scalar types, and the template stands in for the secrets
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+#include "secrets.template.h"
+#endif
 
 #define MQTT_BASE_TOPIC "fan_controller"
 #define MQTT_TOPIC(suffix) MQTT_BASE_TOPIC "/" suffix
@@ -38,6 +48,24 @@ namespace Config {
             RUNNING_WITHOUT_WIFI
         };
 
+        /**
+         * @brief Supervisor action once a task misses its deadline
+         */
+        enum class TaskPolicy {
+            LOG,        // Report only
+            RESTART,    // Delete and recreate the task, reboot after repeated restarts
+            REBOOT      // Restart the system
+        };
+
+        /**
+         * @brief Where a task's stack and TCB are allocated
+         */
+        enum class TaskMemory {
+            HEAP,               // From the heap when the task is created, the default
+            STATIC_INTERNAL,    // Reserved once from the internal RAM pool
+            STATIC_PSRAM        // Stack from the PSRAM pool, TCB internal; the task must not touch flash
+        };
+
         constexpr uint8_t STATUS_LED_PIN = 33;
 
         namespace Debug {
@@ -51,6 +79,7 @@ namespace Config {
             constexpr bool NTP = false;
             constexpr bool INITIALIZER = false;
             constexpr bool PERSISTENT = false;
+            constexpr bool HISTORY = false;
         }
     }
 
@@ -69,6 +98,11 @@ namespace Config {
             constexpr uint32_t STACK_SIZE = 4096;
             constexpr UBaseType_t TASK_PRIORITY = 2;
             constexpr BaseType_t TASK_CORE = 0;
+            constexpr uint32_t PERIOD_MS = 1000;
+            constexpr uint32_t DEADLINE_MS = 10000;
+            constexpr System::TaskPolicy POLICY = System::TaskPolicy::RESTART;
+            constexpr bool WATCHDOG = true;
+            constexpr System::TaskMemory MEMORY = System::TaskMemory::HEAP;
         }
     }
 
@@ -83,12 +117,17 @@ namespace Config {
         constexpr uint32_t RETRY_DELAY_MS = 3000;        // 3 seconds
         constexpr uint8_t BACKOFF_FACTOR = 2;
         constexpr uint8_t MAX_SYNC_ATTEMPTS = 3;
+        constexpr uint32_t START_DELAY_MS = 5000;        // Lets WiFi connect before the first sync
 
         namespace Task {
             constexpr uint32_t STACK_SIZE = 4096;
             constexpr UBaseType_t TASK_PRIORITY = 1;
             constexpr BaseType_t TASK_CORE = 1;
-
+            constexpr uint32_t PERIOD_MS = 100;
+            constexpr uint32_t DEADLINE_MS = 15000;      // A sync blocks up to SYNC_TIMEOUT_MS
+            constexpr System::TaskPolicy POLICY = System::TaskPolicy::RESTART;
+            constexpr bool WATCHDOG = true;
+            constexpr System::TaskMemory MEMORY = System::TaskMemory::HEAP;
         }
     }
 
@@ -104,13 +143,91 @@ namespace Config {
         constexpr uint32_t READ_INTERVAL_MS = 2000;      // 2 seconds
         constexpr uint8_t MAX_RETRIES = 3;
         constexpr uint8_t SMOOTH_SAMPLES = 5;         // Rolling average samples
+        constexpr uint8_t MEDIAN_SAMPLES = 3;         // Spike rejection window, odd
         constexpr float DEFAULT_VALUE = 25.0f;
+        constexpr uint8_t MAX_SENSORS = 8;               // Probes cached on the bus
         constexpr uint32_t READ_TIMEOUT_MS = 1000;       // 1 second
+
+        /**
+         * @brief DS18B20 resolution, 9 bits (0.5°C, 94 ms) to 12 bits (0.0625°C, 750 ms)
+         *
+         * The sample period scales with the conversion time, READ_INTERVAL_MS
+         * at 12 bits down to an eighth of it at 9 bits.
+         */
+        namespace Resolution {
+            constexpr uint8_t MIN_BITS = 9;
+            constexpr uint8_t MAX_BITS = 12;
+            constexpr uint8_t DEFAULT_BITS = 12;         // At boot, and fixed when not adaptive
+            constexpr bool ADAPTIVE = true;              // Coarse and fast during transients
+            constexpr float FAST_RATE = 0.5f;            // °C/s, drop straight to MIN_BITS above
+            constexpr float STABLE_RATE = 0.05f;         // °C/s, counts toward a step up below
+            constexpr uint8_t STABLE_SAMPLES = 4;        // Stable samples per one-bit step up
+            constexpr uint32_t POLL_MS = 10;             // Conversion-complete poll period
+        }
+
+        /**
+         * @brief OneWire link to the probes
+         *
+         * The RMT transport times the slots in hardware and never masks
+         * interrupts. The bit-banged one masks them for every slot but can
+         * drive the strong pull-up parasite powered probes need.
+         *
+         * The RMT transport is experimental and off by default: until it
+         * has been proven on hardware, default builds still mask interrupts
+         * during probe reads. Tracked under Known Limitations in the README.
+         */
+        namespace Bus {
+            constexpr bool USE_RMT = false;              // Experimental
+            constexpr uint8_t RMT_TX_CHANNEL = 0;        // ESP32-S3 TX channels 0-3
+            constexpr uint8_t RMT_RX_CHANNEL = 4;        // ESP32-S3 RX channels 4-7
+            constexpr uint32_t RMT_TIMEOUT_MS = 10;      // Per burst, a byte takes ~0.6 ms
+
+            // Count the tach edges one fan's GPIO interrupt loses during each
+            // probe readout. The fan moves from its PCNT unit to GpioTachSource,
+            // and the freed unit counts the same pin in hardware as reference.
+            // GPIO interrupts are latched, so only an edge arriving while one
+            // is still pending is lost; expect 0 unless readouts mask for long.
+            constexpr bool MEASURE_TACH_LOSS = false;
+            constexpr uint8_t MEASURE_FAN_CHANNEL = 0;   // One of the PCNT counted fans
+        }
+
+        namespace Trend {
+            constexpr uint32_t WINDOW_MS = 20000;        // Least-squares fit window
+            constexpr size_t MAX_SAMPLES = 80;           // Window at the fastest sample rate
+            constexpr size_t MIN_SAMPLES = 4;            // Before a slope is reported
+        }
+
+        namespace Acquisition {
+            constexpr uint8_t HISTOGRAM_BUCKETS = 16;    // Log2 buckets per phase
+            constexpr uint32_t HISTOGRAM_BASE_US = 128;  // Upper bound of the first bucket
+        }
+
+        /**
+         * @brief Binary trace of every acquisition cycle on LittleFS, see trace_format.h
+         *
+         * RECORD appends the live probes to FILE. REPLAY feeds FILE back
+         * instead of the probes, at REPLAY_SPEED times the recorded pace
+         * (0 = as fast as the acquisition cycle steps).
+         */
+        namespace Trace {
+            constexpr bool RECORD = false;
+            constexpr bool REPLAY = false;               // Takes precedence over RECORD
+            constexpr char FILE[] = "/temp_trace.bin";
+            constexpr size_t MAX_BYTES = 1024 * 1024;    // Recording stops here
+            constexpr uint16_t FLUSH_RECORDS = 32;       // Records per flush to flash
+            constexpr float REPLAY_SPEED = 1.0f;
+            constexpr bool REPLAY_LOOP = true;           // Restart at the end of the trace
+        }
         
         namespace Task {
             constexpr uint32_t STACK_SIZE = 4096;
             constexpr UBaseType_t TASK_PRIORITY = 3;
             constexpr BaseType_t TASK_CORE = 1;
+            constexpr uint32_t PERIOD_MS = READ_INTERVAL_MS;   // Longest gap between acquisition steps
+            constexpr uint32_t DEADLINE_MS = 10000;
+            constexpr System::TaskPolicy POLICY = System::TaskPolicy::REBOOT;  // Fan control depends on it
+            constexpr bool WATCHDOG = true;
+            constexpr System::TaskMemory MEMORY = System::TaskMemory::HEAP;
         }
     }
 
@@ -126,6 +243,23 @@ namespace Config {
             constexpr uint8_t CHANNEL = 0;
         }
 
+        namespace Channels {
+            struct Pins {
+                uint8_t pwmPin;                       // PWM output GPIO
+                uint8_t tachPin;                      // Tachometer input GPIO
+                uint8_t ledcChannel;                  // LEDC channel driving pwmPin
+            };
+
+            // One entry per fan, all driven by the same control loop. The
+            // first Tach::PCNT_UNITS fans count tach pulses in hardware,
+            // further fans fall back to GPIO edge interrupts.
+            constexpr Pins PINS[] = {
+                {PWM::PWM_PIN, PWM::TACH_PIN, PWM::CHANNEL},
+            };
+            constexpr uint8_t COUNT = sizeof(PINS) / sizeof(PINS[0]);
+            static_assert(COUNT >= 1 && COUNT <= 8, "ESP32-S3 LEDC supports 1-8 fan channels");
+        }
+
         namespace Speed {
             constexpr uint8_t MIN_PERCENT = 10;
             constexpr uint8_t MAX_PERCENT = 100;
@@ -133,11 +267,43 @@ namespace Config {
             constexpr uint8_t MAX_PWM = 255;          // 100% duty
         }
 
+        namespace Curve {
+            struct Point {
+                uint8_t speed;                        // Speed percentage (0-100)
+                uint8_t pwm;                          // Raw PWM duty
+            };
+
+            // Measured with the calibration environment, single source
+            // for both speed->PWM and PWM->speed lookup tables
+            constexpr Point DEFAULT_POINTS[] = {
+                {0, 0},
+                {5, 25},
+                {10, 37},
+                {20, 61},
+                {30, 85},
+                {40, 109},
+                {50, 134},
+                {60, 158},
+                {70, 182},
+                {80, 206},
+                {90, 230},
+                {100, 255}
+            };
+        }
+
         namespace RPM {
             constexpr uint16_t MINIMUM = 200;
             constexpr uint16_t MAXIMUM = 3300;
             constexpr uint8_t PULSES_PER_REV = 2;
-            constexpr uint32_t UPDATE_INTERVAL = 1000;  // 1 second
+            constexpr uint32_t UPDATE_INTERVAL = 1000;  // Supervision; readings follow the revolutions
+            constexpr uint32_t EVENT_INTERVAL_US = 100000;  // Min spacing of revolution-driven readings
+            constexpr uint32_t TIMEOUT_MS = 1000;       // No revolution within this reads as 0 RPM
+        }
+
+        namespace Tach {
+            constexpr uint8_t PCNT_UNITS = 4;                     // ESP32-S3 pulse counter units
+            constexpr uint32_t GPIO_MIN_EDGE_US = 1000;            // Glitch rejection for GPIO tach inputs
+            constexpr uint16_t GLITCH_FILTER_APB_CYCLES = 1023;  // ~12.8us at 80MHz (hardware max)
         }
 
         namespace Control {
@@ -148,13 +314,54 @@ namespace Config {
             constexpr float MIN_TRIGGER_TEMP = 25.0f;         // Min trigger temp for fan
             constexpr float MAX_TRIGGER_TEMP = 60.0f;         // Max trigger temp for fan
             constexpr uint32_t MUTEX_TIMEOUT_MS = 1000;
-            constexpr uint8_t STALL_RETRY_COUNT = 3;
-            constexpr uint32_t EVENT_CHECK_INTERVAL = 1000;
+
+            namespace PID {
+                constexpr float KP = 10.0f;                // % per °C of error
+                constexpr float KI = 0.2f;                 // % per °C per second
+                constexpr float KD = 20.0f;                // % per °C/s (on measurement)
+                constexpr float MAX_GAIN = 1000.0f;        // Upper bound accepted over MQTT
+                // One control step per sensor reading, the period is measured
+                // between readings as the sensor resolution changes it
+                constexpr uint32_t SAMPLE_PERIOD_MS = Config::Temperature::READ_INTERVAL_MS;
+                constexpr uint32_t MAX_SAMPLE_PERIOD_MS = 2 * Config::Temperature::READ_INTERVAL_MS;
+            }
+
+            // Speed added ahead of a rising temperature, never subtracted
+            namespace FeedForward {
+                constexpr float GAIN = 5.0f;               // % per °C/min of rise
+                constexpr float MAX_SPEED = 30.0f;         // % cap on the added speed
+                constexpr float LOOKAHEAD_S = 60.0f;       // Start early if the trend crosses MIN_TRIGGER_TEMP within
+            }
+        }
+
+        namespace Stall {
+            constexpr uint8_t SAMPLES = 3;                    // Consecutive low readings before a kick
+            constexpr uint8_t TOLERANCE_PERCENT = 40;         // Allowed shortfall against the calibrated RPM
+            constexpr uint32_t GRACE_MS = 3000;               // No checks while the fan follows a new duty
+            constexpr uint32_t KICK_MS = 2000;                // Full duty spin-up pulse
+            constexpr uint32_t BACKOFF_INITIAL_MS = 5000;     // Off time after the first failed kick
+            constexpr uint32_t BACKOFF_MAX_MS = 300000;       // Off time doubles up to this
+            constexpr uint32_t BACKOFF_RESET_MS = 60000;      // Clean running time that resets the backoff
+        }
+
+        namespace Calibration {
+            constexpr uint8_t MAX_POINTS = 32;                // Stored curve points incl. 0% and 100%
+            constexpr uint8_t START_STEP = 4;                 // PWM increment while searching start duty
+            constexpr uint8_t SWEEP_STEP = 16;                // PWM decrement of the coarse RPM sweep
+            constexpr uint8_t STALL_STEP = 2;                 // PWM decrement while searching stall duty
+            constexpr uint32_t KICK_MS = 2000;                // Full duty before the stall search
+            constexpr uint32_t SETTLE_MIN_MS = 2000;          // Minimum dwell per step
+            constexpr uint32_t SETTLE_TIMEOUT_MS = 15000;     // Accept the reading after this
+            constexpr uint8_t SETTLE_SAMPLES = 2;             // Consecutive stable RPM samples
+            constexpr uint8_t SETTLE_TOLERANCE_PERCENT = 2;   // Allowed change between samples
+            constexpr uint16_t SETTLE_MIN_TOLERANCE_RPM = 20;
         }
 
         namespace NightMode {
             constexpr uint8_t START_HOUR = 22;
+            constexpr uint8_t START_MINUTE = 0;
             constexpr uint8_t END_HOUR = 7;
+            constexpr uint8_t END_MINUTE = 0;
             constexpr uint8_t MAX_SPEED_PERCENT = 40;             // 40% maximum at night
         }
 
@@ -162,6 +369,11 @@ namespace Config {
             constexpr uint32_t STACK_SIZE = 4096;
             constexpr UBaseType_t TASK_PRIORITY = 3;
             constexpr BaseType_t TASK_CORE = 1;
+            constexpr uint32_t PERIOD_MS = RPM::UPDATE_INTERVAL;   // Event driven, at least this often
+            constexpr uint32_t DEADLINE_MS = 5000;
+            constexpr System::TaskPolicy POLICY = System::TaskPolicy::REBOOT;
+            constexpr bool WATCHDOG = true;
+            constexpr System::TaskMemory MEMORY = System::TaskMemory::HEAP;
         }
 
         enum class Mode {
@@ -198,6 +410,11 @@ namespace Config {
             constexpr uint32_t STACK_SIZE = 8192;
             constexpr UBaseType_t TASK_PRIORITY = 4;
             constexpr BaseType_t TASK_CORE = 1;
+            constexpr uint32_t PERIOD_MS = 50;
+            constexpr uint32_t DEADLINE_MS = 15000;      // Connect blocks up to the 5 s socket timeout
+            constexpr System::TaskPolicy POLICY = System::TaskPolicy::RESTART;
+            constexpr bool WATCHDOG = true;
+            constexpr System::TaskMemory MEMORY = System::TaskMemory::STATIC_INTERNAL;  // Restarts need 8 KB contiguous
         }
 
         namespace Topics {
@@ -207,22 +424,165 @@ namespace Config {
             namespace Status {
                 constexpr char SYSTEM[] = MQTT_TOPIC("status/system");
                 constexpr char NIGHT_MODE[] = MQTT_TOPIC("status/night_mode");
+                constexpr char PID[] = MQTT_TOPIC("status/pid");
+                constexpr char CALIBRATION[] = MQTT_TOPIC("status/calibration");
+                constexpr char FAN_FORMAT[] = MQTT_TOPIC("status/fan/%u");  // Per channel
+                constexpr char SENSORS[] = MQTT_TOPIC("status/sensors");
+                constexpr char HISTORY[] = MQTT_TOPIC("status/history");    // Query replies
+                constexpr char CPU[] = MQTT_TOPIC("status/cpu");
+                constexpr char STACKS[] = MQTT_TOPIC("status/stacks");
+                constexpr char TIMING[] = MQTT_TOPIC("status/timing");      // Query replies
             }
             namespace Control {
                 constexpr char MODE[] = MQTT_TOPIC("control/mode/set");
                 constexpr char NIGHT_MODE[] = MQTT_TOPIC("control/night_mode/set");
                 constexpr char NIGHT_SETTINGS[] = MQTT_TOPIC("control/night_settings/set");
                 constexpr char RECOVERY[] = MQTT_TOPIC("control/recovery/set");
+                constexpr char PID[] = MQTT_TOPIC("control/pid/set");
+                constexpr char CALIBRATION[] = MQTT_TOPIC("control/calibration/set");
+                constexpr char HISTORY[] = MQTT_TOPIC("control/history/get");
+                constexpr char TIMING[] = MQTT_TOPIC("control/timing/get");
+                constexpr char FAN_PREFIX[] = MQTT_TOPIC("control/fan/");  // control/fan/<n>/set
+                constexpr char FAN_SUFFIX[] = "/set";
+                constexpr char FAN_WILDCARD[] = MQTT_TOPIC("control/fan/+/set");
             }
         }
     }
 
+    /**
+     * @brief Temperature and RPM history kept in PSRAM
+     */
+    namespace History {
+        namespace Raw {
+            constexpr uint32_t PERIOD_S = 1;
+            constexpr size_t POINTS = 600;               // 10 minutes
+        }
+        namespace Minute {
+            constexpr uint32_t PERIOD_S = 60;
+            constexpr size_t POINTS = 1440;              // 24 hours
+        }
+        namespace Hour {
+            constexpr uint32_t PERIOD_S = 3600;
+            constexpr size_t POINTS = 720;               // 30 days
+        }
+
+        constexpr float TEMPERATURE_SCALE = 100.0f;      // Stored in 0.01°C
+        constexpr size_t QUERY_MAX_POINTS = 30;          // Per MQTT reply
+
+        namespace Task {
+            constexpr uint32_t STACK_SIZE = 3072;
+            constexpr UBaseType_t TASK_PRIORITY = 1;
+            constexpr BaseType_t TASK_CORE = 1;
+            constexpr uint32_t PERIOD_MS = Raw::PERIOD_S * 1000;
+            constexpr uint32_t DEADLINE_MS = 10000;
+            constexpr System::TaskPolicy POLICY = System::TaskPolicy::LOG;
+            constexpr bool WATCHDOG = false;
+            constexpr System::TaskMemory MEMORY = System::TaskMemory::STATIC_PSRAM;  // Aggregates in PSRAM only
+        }
+    }
+
     /**
      * @brief Task Manager configuration
      */
     namespace TaskManager {
         constexpr size_t MAX_TASKS = 10;
         constexpr size_t STACK_WARNING_THRESHOLD = 200;
+        constexpr size_t CACHE_LINE_SIZE = 32;           // ESP32-S3 data cache line, one heartbeat each
+        constexpr uint32_t DEFAULT_DEADLINE_MS = 30000;  // Tasks without a deadline of their own
+
+        namespace Supervisor {
+            constexpr uint32_t CHECK_INTERVAL_MS = 1000;
+            constexpr uint8_t MAX_RESTARTS = 3;          // Consecutive restarts before a reboot
+        }
+
+        /**
+         * @brief Hardware task watchdog, logs the stalled tasks when the
+         * supervisor itself stalls; above every watched task's deadline
+         */
+        namespace Watchdog {
+            constexpr uint32_t TIMEOUT_S = 30;
+            constexpr uint32_t FEED_INTERVAL_MS = 1000;  // Heartbeats feed it at most this often
+            constexpr bool WATCH_LOOP = true;            // Also watch the Arduino loop task
+        }
+
+        /**
+         * @brief Pools for statically allocated tasks, in internal .bss and
+         * PSRAM; reserved at startup and never returned to the heap
+         *
+         * Tasks opt in through their MEMORY. The pools are sized at compile
+         * time from the tasks that opted in and are created in this build
+         * (task_manager.cpp), so heap tasks cost nothing here.
+         */
+        namespace StaticAllocation {
+            constexpr size_t ALIGNMENT = 16;
+        }
+
+        /**
+         * @brief Stack high-water history and recommended stack sizes
+         */
+        namespace StackSizing {
+            constexpr uint8_t MARGIN_PERCENT = 25;       // Added to the observed peak
+            constexpr uint32_t ROUND_BYTES = 256;
+            constexpr uint32_t MIN_BYTES = 1024;
+            constexpr uint8_t BUDGET_PERCENT = 90;       // Peak share of the stack that is reported
+            constexpr uint32_t REPORT_INTERVAL_MS = 30 * 60 * 1000;
+#ifdef STACK_BUDGET_ENFORCE
+            constexpr bool ENFORCE = true;               // Abort once a task exceeds its budget
+#else
+            constexpr bool ENFORCE = false;
+#endif
+        }
+
+        /**
+         * @brief Per-task histograms of the loop period and execution time
+         *
+         * Log-linear buckets: linear below 2^SUB_BUCKET_BITS units, then
+         * 2^SUB_BUCKET_BITS buckets per power of two. 64 buckets of 32 us
+         * resolve up to about 3.7 s within 25%; two per task, 5 KB in all.
+         */
+        namespace LoopTiming {
+            constexpr uint32_t UNIT_US = 32;             // Width of the first buckets
+            constexpr uint8_t SUB_BUCKET_BITS = 2;
+            constexpr uint8_t BUCKETS = 64;              // The last one holds everything longer
+            constexpr uint32_t REPORT_INTERVAL_MS = 5 * 60 * 1000;
+        }
+    }
+
+    /**
+     * @brief Cooperative executor, running the low-rate network services
+     * (WiFi, NTP) as jobs of one task instead of a task each
+     *
+     * Temperature acquisition and fan control keep their own tasks. A job
+     * that blocks on a probe readout would hold up every other job, and a
+     * stall of the shared task would take the fan down with it.
+     */
+    namespace Executor {
+#ifdef EXECUTOR_ENABLED
+        constexpr bool ENABLED = true;                   // ili9341_executor environment
+#else
+        constexpr bool ENABLED = false;
+#endif
+        constexpr size_t MAX_JOBS = 8;                   // One event bit each
+        constexpr uint32_t MAX_SLEEP_MS = 500;           // Heartbeat at least this often
+
+        namespace Task {
+            constexpr uint32_t STACK_SIZE = 4096;        // Deepest job, jobs run one at a time
+            constexpr UBaseType_t TASK_PRIORITY = 2;     // The WiFi priority
+            constexpr BaseType_t TASK_CORE = 0;          // With the network stack
+            constexpr uint32_t PERIOD_MS = 0;            // Wakes when a job is due
+            constexpr uint32_t DEADLINE_MS = 10000;      // The tightest job deadline, WiFi's
+            constexpr System::TaskPolicy POLICY = System::TaskPolicy::RESTART;
+            constexpr bool WATCHDOG = true;
+            constexpr System::TaskMemory MEMORY = System::TaskMemory::HEAP;
+        }
+    }
+
+    /**
+     * @brief CPU utilization from the FreeRTOS run-time counters
+     */
+    namespace CpuMonitor {
+        constexpr uint32_t WINDOW_MS = 5000;             // Sampling window
+        constexpr size_t MAX_TASKS = 24;                 // Tracked tasks, system tasks included
     }
 
     /**
@@ -240,12 +600,22 @@ namespace Config {
             constexpr BaseType_t TASK_CORE = 0;
             constexpr uint32_t TASK_DELAY = 16;
             constexpr uint32_t UPDATE_INTERVAL = 100;
+            constexpr uint32_t PERIOD_MS = 1;
+            constexpr uint32_t DEADLINE_MS = 5000;
+            constexpr System::TaskPolicy POLICY = System::TaskPolicy::REBOOT;  // May stall holding the UI mutex
+            constexpr bool WATCHDOG = true;
+            constexpr System::TaskMemory MEMORY = System::TaskMemory::HEAP;
         }
 
         namespace DisplayUpdate {
             constexpr uint32_t STACK_SIZE = 4096;
             constexpr UBaseType_t TASK_PRIORITY = 2;
             constexpr BaseType_t TASK_CORE = 1;
+            constexpr uint32_t PERIOD_MS = DisplayRender::TASK_DELAY;
+            constexpr uint32_t DEADLINE_MS = 5000;
+            constexpr System::TaskPolicy POLICY = System::TaskPolicy::REBOOT;
+            constexpr bool WATCHDOG = true;
+            constexpr System::TaskMemory MEMORY = System::TaskMemory::HEAP;
         
             namespace Queue {
                 constexpr uint8_t SIZE = 5;
@@ -259,7 +629,8 @@ namespace Config {
                 constexpr float HEIGHT_TO_SCREEN_RATIO = 0.18f;
                 constexpr float SIDE_PADDING_RATIO = 0.01f;
                 constexpr float ICON_GAP_RATIO = 0.1f;
-
+                constexpr float SENSOR_WIDTH_RATIO = 0.6f;    // Per-probe strip, scrolls when full
+                constexpr uint8_t SENSOR_ID_CHARS = 4;        // Trailing ROM digits shown per probe
             }
 
             namespace Meters {
@@ -269,7 +640,7 @@ namespace Config {
                 constexpr float BOTTOM_OFFSET_RATIO = 0.08f;
                 
                 namespace Animation {
-                    constexpr u_int16_t SPEED_MS = 2000;
+                    constexpr uint16_t SPEED_MS = 2000;
                 }
 
                 namespace Temperature {
@@ -292,6 +663,19 @@ namespace Config {
             }
         }
 
+        /**
+         * @brief CPU diagnostics screen, toggled by a double click
+         */
+        namespace Diagnostics {
+            constexpr float MARGIN_TO_WIDTH_RATIO = 0.03f;
+            constexpr float TITLE_TO_SCREEN_RATIO = 0.14f;
+            constexpr float CORE_ROW_TO_SCREEN_RATIO = 0.11f;
+            constexpr float BAR_TO_WIDTH_RATIO = 0.55f;
+            constexpr uint8_t TASK_ROWS = 6;                  // Busiest tasks listed
+            constexpr uint8_t BUSY_THRESHOLD = 50;            // Core load shown as a warning
+            constexpr uint8_t CRITICAL_THRESHOLD = 85;
+        }
+
     }
 }
 
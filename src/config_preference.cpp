@@ -39,14 +39,20 @@ bool ConfigPreference::saveFanSettings(const FanSettings& settings) {
 
     prefs.putUChar("fanMode", settings.fanMode);
     DEBUG_LOG_PERSISTENT("SAVE CONFIG: FanMode=%d\n", settings.fanMode);
-    DEBUG_LOG_PERSISTENT("SAVE CONFIG: ManSpeed=%d\n", settings.manualSpeed);
+    DEBUG_LOG_PERSISTENT("SAVE CONFIG: ManSpeed=%d\n", settings.manualSpeed[0]);
     DEBUG_LOG_PERSISTENT("SAVE CONFIG: NightMode=%d\n", settings.nightModeEnabled);
 
     // Rest of the save operations...
-    prefs.putUChar("manSpeed", settings.manualSpeed);
+    char key[16];
+    for (uint8_t channel = 0; channel < Config::Fan::Channels::COUNT; channel++) {
+        prefs.putUChar(channelKey(key, sizeof(key), "manSpeed", channel), 
+                       settings.manualSpeed[channel]);
+    }
     prefs.putBool("nightMode", settings.nightModeEnabled);
     prefs.putUChar("nightStart", settings.nightStartHour);
     prefs.putUChar("nightEnd", settings.nightEndHour);
+    prefs.putUChar("nightStartMin", settings.nightStartMinute);
+    prefs.putUChar("nightEndMin", settings.nightEndMinute);
     prefs.putUChar("nightMaxSpeed", settings.nightMaxSpeed);
 
     return true;
@@ -62,8 +68,12 @@ bool ConfigPreference::loadFanSettings(FanSettings& settings) {
     settings.fanMode = prefs.getUChar("fanMode", 0);  // 0 = AUTO mode
     DEBUG_LOG_PERSISTENT("LOAD CONFIG: FanMode=%d\n", settings.fanMode);
     
-    settings.manualSpeed = prefs.getUChar("manSpeed", Config::Fan::Speed::MIN_PERCENT);
-    DEBUG_LOG_PERSISTENT("LOAD CONFIG: ManSpeed=%d\n", settings.manualSpeed);
+    char key[16];
+    for (uint8_t channel = 0; channel < Config::Fan::Channels::COUNT; channel++) {
+        settings.manualSpeed[channel] = prefs.getUChar(channelKey(key, sizeof(key), "manSpeed", channel), 
+                                                       Config::Fan::Speed::MIN_PERCENT);
+    }
+    DEBUG_LOG_PERSISTENT("LOAD CONFIG: ManSpeed=%d\n", settings.manualSpeed[0]);
     
     settings.nightModeEnabled = prefs.getBool("nightMode", false);
     DEBUG_LOG_PERSISTENT("LOAD CONFIG: NightMode=%d\n", settings.nightModeEnabled);
@@ -74,6 +84,8 @@ bool ConfigPreference::loadFanSettings(FanSettings& settings) {
     }
     settings.nightStartHour = prefs.getUChar("nightStart", Config::Fan::NightMode::START_HOUR);
     settings.nightEndHour = prefs.getUChar("nightEnd", Config::Fan::NightMode::END_HOUR);
+    settings.nightStartMinute = prefs.getUChar("nightStartMin", Config::Fan::NightMode::START_MINUTE);
+    settings.nightEndMinute = prefs.getUChar("nightEndMin", Config::Fan::NightMode::END_MINUTE);
     settings.nightMaxSpeed = prefs.getUChar("nightMaxSpeed", Config::Fan::NightMode::MAX_SPEED_PERCENT);
 
     return true;
@@ -81,13 +93,126 @@ bool ConfigPreference::loadFanSettings(FanSettings& settings) {
 
 void ConfigPreference::setDefaultFanSettings(FanSettings& settings) {
     settings.fanMode = 0;  // AUTO mode
-    settings.manualSpeed = Config::Fan::Speed::MIN_PERCENT;
+    for (uint8_t channel = 0; channel < Config::Fan::Channels::COUNT; channel++) {
+        settings.manualSpeed[channel] = Config::Fan::Speed::MIN_PERCENT;
+    }
     settings.nightModeEnabled = false;
     settings.nightStartHour = Config::Fan::NightMode::START_HOUR;
     settings.nightEndHour = Config::Fan::NightMode::END_HOUR;
+    settings.nightStartMinute = Config::Fan::NightMode::START_MINUTE;
+    settings.nightEndMinute = Config::Fan::NightMode::END_MINUTE;
     settings.nightMaxSpeed = Config::Fan::NightMode::MAX_SPEED_PERCENT;
 }
 
+bool ConfigPreference::savePidSettings(const PidSettings& settings) {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked() || !initialized) return false;
+
+    prefs.putFloat("pidKp", settings.kp);
+    prefs.putFloat("pidKi", settings.ki);
+    prefs.putFloat("pidKd", settings.kd);
+    prefs.putFloat("pidTarget", settings.targetTemp);
+    DEBUG_LOG_PERSISTENT("SAVE CONFIG: PID Kp=%.3f Ki=%.3f Kd=%.3f Target=%.1f\n",
+                         settings.kp, settings.ki, settings.kd, settings.targetTemp);
+
+    return true;
+}
+
+bool ConfigPreference::loadPidSettings(PidSettings& settings) {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked() || !initialized) {
+        setDefaultPidSettings(settings);
+        return false;
+    }
+
+    settings.kp = prefs.getFloat("pidKp", Config::Fan::Control::PID::KP);
+    settings.ki = prefs.getFloat("pidKi", Config::Fan::Control::PID::KI);
+    settings.kd = prefs.getFloat("pidKd", Config::Fan::Control::PID::KD);
+    settings.targetTemp = prefs.getFloat("pidTarget", Config::Fan::Control::DEFAULT_TARGET);
+    DEBUG_LOG_PERSISTENT("LOAD CONFIG: PID Kp=%.3f Ki=%.3f Kd=%.3f Target=%.1f\n",
+                         settings.kp, settings.ki, settings.kd, settings.targetTemp);
+
+    return true;
+}
+
+void ConfigPreference::setDefaultPidSettings(PidSettings& settings) {
+    settings.kp = Config::Fan::Control::PID::KP;
+    settings.ki = Config::Fan::Control::PID::KI;
+    settings.kd = Config::Fan::Control::PID::KD;
+    settings.targetTemp = Config::Fan::Control::DEFAULT_TARGET;
+}
+
+bool ConfigPreference::saveCurveSettings(uint8_t channel, const CurveSettings& settings) {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked() || !initialized) return false;
+
+    if (settings.count < 2 || settings.count > Config::Fan::Calibration::MAX_POINTS) {
+        return false;
+    }
+
+    char key[16];
+    size_t length = settings.count * sizeof(settings.points[0]);
+    if (prefs.putBytes(channelKey(key, sizeof(key), "curvePts", channel), 
+                       settings.points, length) != length) {
+        return false;
+    }
+    prefs.putUChar(channelKey(key, sizeof(key), "curveMinPwm", channel), settings.minStartPWM);
+    prefs.putUChar(channelKey(key, sizeof(key), "curveStallPwm", channel), settings.stallPWM);
+    prefs.putUShort(channelKey(key, sizeof(key), "curveMaxRpm", channel), settings.maxRPM);
+    DEBUG_LOG_PERSISTENT("SAVE CONFIG: Fan %d curve points=%d MinPWM=%d StallPWM=%d MaxRPM=%d\n",
+                         channel, settings.count, settings.minStartPWM, settings.stallPWM, settings.maxRPM);
+
+    return true;
+}
+
+bool ConfigPreference::loadCurveSettings(uint8_t channel, CurveSettings& settings) {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked() || !initialized) return false;
+
+    // No stored curve means the built-in default applies
+    char key[16];
+    size_t length = prefs.getBytesLength(channelKey(key, sizeof(key), "curvePts", channel));
+    if (length == 0 || 
+        length % sizeof(settings.points[0]) != 0 || 
+        length > sizeof(settings.points)) {
+        return false;
+    }
+
+    prefs.getBytes(key, settings.points, length);
+    settings.count = length / sizeof(settings.points[0]);
+    settings.minStartPWM = prefs.getUChar(channelKey(key, sizeof(key), "curveMinPwm", channel), 
+                                          Config::Fan::Speed::MIN_PWM);
+    settings.stallPWM = prefs.getUChar(channelKey(key, sizeof(key), "curveStallPwm", channel), 
+                                       Config::Fan::Speed::MIN_PWM);
+    settings.maxRPM = prefs.getUShort(channelKey(key, sizeof(key), "curveMaxRpm", channel), 
+                                      Config::Fan::RPM::MAXIMUM);
+    DEBUG_LOG_PERSISTENT("LOAD CONFIG: Fan %d curve points=%d MinPWM=%d StallPWM=%d MaxRPM=%d\n",
+                         channel, settings.count, settings.minStartPWM, settings.stallPWM, settings.maxRPM);
+
+    return true;
+}
+
+bool ConfigPreference::clearCurveSettings(uint8_t channel) {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked() || !initialized) return false;
+
+    char key[16];
+    prefs.remove(channelKey(key, sizeof(key), "curvePts", channel));
+    prefs.remove(channelKey(key, sizeof(key), "curveMinPwm", channel));
+    prefs.remove(channelKey(key, sizeof(key), "curveStallPwm", channel));
+    prefs.remove(channelKey(key, sizeof(key), "curveMaxRpm", channel));
+    return true;
+}
+
+const char* ConfigPreference::channelKey(char* buffer, size_t size, const char* base, uint8_t channel) {
+    if (channel == 0) {
+        snprintf(buffer, size, "%s", base);
+    } else {
+        snprintf(buffer, size, "%s%u", base, channel);
+    }
+    return buffer;
+}
+
 bool ConfigPreference::resetToDefaults() {
     MutexGuard guard(mutex);
     if (!guard.isLocked() || !initialized) return false;
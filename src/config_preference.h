@@ -14,19 +14,41 @@ public:
     // Use uint8_t for mode to avoid circular dependency
     struct FanSettings {
         uint8_t fanMode;  // Will store static_cast of FanController::Mode
-        uint8_t manualSpeed;
+        uint8_t manualSpeed[Config::Fan::Channels::COUNT];
         bool nightModeEnabled;
         uint8_t nightStartHour;
+        uint8_t nightStartMinute;
         uint8_t nightEndHour;
+        uint8_t nightEndMinute;
         uint8_t nightMaxSpeed;
     };
 
+    struct PidSettings {
+        float kp;
+        float ki;
+        float kd;
+        float targetTemp;
+    };
+
+    struct CurveSettings {
+        Config::Fan::Curve::Point points[Config::Fan::Calibration::MAX_POINTS];
+        uint8_t count;
+        uint8_t minStartPWM;
+        uint8_t stallPWM;
+        uint16_t maxRPM;
+    };
+
     ConfigPreference();
     ~ConfigPreference();
 
     bool begin();
     bool saveFanSettings(const FanSettings& settings);
     bool loadFanSettings(FanSettings& settings);
+    bool savePidSettings(const PidSettings& settings);
+    bool loadPidSettings(PidSettings& settings);
+    bool saveCurveSettings(uint8_t channel, const CurveSettings& settings);
+    bool loadCurveSettings(uint8_t channel, CurveSettings& settings);
+    bool clearCurveSettings(uint8_t channel);
     bool resetToDefaults();
 
 private:
@@ -35,6 +57,10 @@ private:
     bool initialized;
 
     void setDefaultFanSettings(FanSettings& settings);
+    void setDefaultPidSettings(PidSettings& settings);
+
+    // Per-channel key, channel 0 keeps the unsuffixed key of single-fan builds
+    static const char* channelKey(char* buffer, size_t size, const char* base, uint8_t channel);
 };
 
 #endif // CONFIG_PREFERENCE_H
\ No newline at end of file
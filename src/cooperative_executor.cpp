@@ -0,0 +1,185 @@
+/**
+ * @file cooperative_executor.cpp
+ * @brief Implementation of the single-task cooperative job executor
+ */
+
+#include "cooperative_executor.h"
+#include "debug_log.h"
+#include <algorithm>
+
+/*******************************************************************************
+ * Construction / Destruction
+ ******************************************************************************/
+
+CooperativeExecutor::CooperativeExecutor(TaskManager& tm)
+    : taskManager(tm)
+    , mutex(xSemaphoreCreateMutex())
+    , events(xEventGroupCreate())
+    , jobCount(0)
+    , started(false) {
+}
+
+CooperativeExecutor::~CooperativeExecutor() {
+    if (mutex) {
+        vSemaphoreDelete(mutex);
+    }
+    if (events) {
+        vEventGroupDelete(events);
+    }
+}
+
+/*******************************************************************************
+ * Jobs
+ ******************************************************************************/
+
+esp_err_t CooperativeExecutor::addJob(const char* name, JobFunction function, void* context,
+                                      uint32_t firstDelayMs, uint8_t* id) {
+    if (id) {
+        *id = INVALID_JOB;
+    }
+
+    if (!mutex || !events || !function) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    uint8_t index = jobCount.load(std::memory_order_relaxed);
+    if (index >= MAX_JOBS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    Job& job = jobs[index];
+    job = Job();
+    job.name = name;
+    job.function = function;
+    job.context = context;
+    job.dueUs = esp_timer_get_time() + static_cast<int64_t>(firstDelayMs) * 1000;
+
+    if (!started) {
+        TaskManager::TaskConfig taskConfig("Executor",
+                                           Config::Executor::Task::STACK_SIZE,
+                                           Config::Executor::Task::TASK_PRIORITY,
+                                           Config::Executor::Task::TASK_CORE,
+                                           Config::Executor::Task::PERIOD_MS,
+                                           Config::Executor::Task::DEADLINE_MS,
+                                           Config::Executor::Task::POLICY,
+                                           Config::Executor::Task::WATCHDOG,
+                                           Config::Executor::Task::MEMORY);
+        esp_err_t err = taskManager.createTask(taskConfig, executorTask, this, &taskId);
+        if (err != ESP_OK) {
+            return err;
+        }
+        started = true;
+    }
+
+    // The executor only sees the job from here on
+    jobCount.store(index + 1, std::memory_order_release);
+    xEventGroupSetBits(events, RESCHEDULE);
+    if (id) {
+        *id = index;
+    }
+
+    DEBUG_LOG_TASK_MANAGER("Executor: job %s added, first run in %lu ms", name, firstDelayMs);
+    return ESP_OK;
+}
+
+void CooperativeExecutor::notify(uint8_t id) {
+    if (id >= MAX_JOBS || !events) return;
+    xEventGroupSetBits(events, 1 << id);
+}
+
+size_t CooperativeExecutor::getJobStats(JobStats* stats, size_t maxJobs) const {
+    if (!stats) return 0;
+
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return 0;
+
+    size_t count = std::min<size_t>(jobCount.load(std::memory_order_acquire), maxJobs);
+    for (size_t i = 0; i < count; i++) {
+        const Job& job = jobs[i];
+        stats[i].name = job.name;
+        stats[i].runs = job.runs;
+        stats[i].notifiedRuns = job.notifiedRuns;
+        stats[i].lastExecUs = job.lastExecUs;
+        stats[i].meanExecUs = job.runs ? job.totalExecUs / job.runs : 0;
+        stats[i].maxExecUs = job.maxExecUs;
+        stats[i].maxLateUs = job.maxLateUs;
+    }
+    return count;
+}
+
+/*******************************************************************************
+ * Task Implementation
+ ******************************************************************************/
+
+void CooperativeExecutor::executorTask(void* parameters) {
+    static_cast<CooperativeExecutor*>(parameters)->run();
+}
+
+void CooperativeExecutor::run() {
+    const EventBits_t allBits = ((1 << MAX_JOBS) - 1) | RESCHEDULE;
+
+    while (true) {
+        // Sleep until the earliest job is due, a notify() or the heartbeat
+        uint8_t count = jobCount.load(std::memory_order_acquire);
+        int64_t sleepUs = earliestDue(count) - esp_timer_get_time();
+        uint32_t sleepMs = sleepUs <= 0 ? 0
+            : static_cast<uint32_t>(std::min<int64_t>((sleepUs + 999) / 1000, Config::Executor::MAX_SLEEP_MS));
+
+        EventBits_t notified = xEventGroupWaitBits(events, allBits, pdTRUE, pdFALSE,
+                                                   pdMS_TO_TICKS(sleepMs));
+        taskManager.heartbeat(taskId);
+
+        count = jobCount.load(std::memory_order_acquire);
+        int64_t now = esp_timer_get_time();
+        for (uint8_t i = 0; i < count; i++) {
+            bool wasNotified = notified & (1 << i);
+            if (wasNotified || jobs[i].dueUs <= now) {
+                runJob(i, wasNotified && jobs[i].dueUs > now);
+            }
+        }
+        taskManager.workDone(taskId);
+    }
+}
+
+void CooperativeExecutor::runJob(uint8_t index, bool notified) {
+    Job& job = jobs[index];
+
+    int64_t start = esp_timer_get_time();
+    uint32_t lateUs = !notified && start > job.dueUs ? static_cast<uint32_t>(start - job.dueUs) : 0;
+    uint32_t delayMs = job.function(job.context);
+    int64_t end = esp_timer_get_time();
+
+    job.dueUs = delayMs == WAIT_FOR_EVENT ? NEVER : end + static_cast<int64_t>(delayMs) * 1000;
+
+    uint32_t execUs = static_cast<uint32_t>(end - start);
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return;
+
+    job.runs++;
+    if (notified) {
+        job.notifiedRuns++;
+    }
+    job.lastExecUs = execUs;
+    job.totalExecUs += execUs;
+    if (execUs > job.maxExecUs) {
+        job.maxExecUs = execUs;
+    }
+    if (lateUs > job.maxLateUs) {
+        job.maxLateUs = lateUs;
+    }
+}
+
+int64_t CooperativeExecutor::earliestDue(uint8_t count) const {
+    int64_t earliest = NEVER;
+    for (uint8_t i = 0; i < count; i++) {
+        if (jobs[i].dueUs < earliest) {
+            earliest = jobs[i].dueUs;
+        }
+    }
+    return earliest;
+}
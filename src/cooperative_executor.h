@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "config.h"
+#include "task_manager.h"
+#include "mutex_guard.h"
+
+/**
+ * @brief Runs short periodic and event-triggered jobs in one task
+ *
+ * Each job returns the delay until its next run. The task sleeps until
+ * the earliest due job or a notify(), then runs every job that is due or
+ * notified, one after the other. Jobs never preempt each other, so a job
+ * must not block: one that does delays every other job and, past the
+ * executor's deadline, trips the supervisor.
+ *
+ * Features:
+ * - One stack and one heartbeat for all jobs
+ * - Periodic, variable-delay and event-triggered jobs
+ * - notify() from any task, coalesced until the job runs
+ * - Per-job run count, execution time and lateness
+ *
+ * With at most MAX_JOBS jobs the earliest deadline is found by a scan of
+ * the job table, which lets the task sleep until exactly that time
+ * instead of ticking a wheel.
+ */
+class CooperativeExecutor {
+public:
+    using JobFunction = uint32_t (*)(void* context);
+
+    static constexpr size_t MAX_JOBS = Config::Executor::MAX_JOBS;
+    static constexpr uint32_t WAIT_FOR_EVENT = UINT32_MAX;   ///< Job delay: run only when notified
+    static constexpr uint8_t INVALID_JOB = 0xFF;
+
+    struct JobStats {
+        const char* name;
+        uint32_t runs;
+        uint32_t notifiedRuns;  ///< Runs triggered by notify()
+        uint32_t lastExecUs;
+        uint32_t meanExecUs;
+        uint32_t maxExecUs;
+        uint32_t maxLateUs;     ///< Start past the due time
+    };
+
+    explicit CooperativeExecutor(TaskManager& taskManager);
+    ~CooperativeExecutor();
+
+    // Prevent copying
+    CooperativeExecutor(const CooperativeExecutor&) = delete;
+    CooperativeExecutor& operator=(const CooperativeExecutor&) = delete;
+
+    /**
+     * @brief Add a job; the executor task starts with the first one
+     * @param function Runs the job, returns the delay until its next run
+     *                 in ms, 0 to run again right away or WAIT_FOR_EVENT
+     * @param firstDelayMs Delay before the first run
+     * @param id Receives the job for notify(); INVALID_JOB on failure
+     */
+    esp_err_t addJob(const char* name, JobFunction function, void* context,
+                     uint32_t firstDelayMs, uint8_t* id = nullptr);
+
+    /**
+     * @brief Run the job as soon as the executor is free, from any task
+     */
+    void notify(uint8_t id);
+
+    /**
+     * @return Number of entries written
+     */
+    size_t getJobStats(JobStats* stats, size_t maxJobs) const;
+
+private:
+    static constexpr int64_t NEVER = INT64_MAX;
+    static_assert(MAX_JOBS < 24, "One event group bit per job, plus RESCHEDULE");
+    static constexpr EventBits_t RESCHEDULE = 1 << MAX_JOBS;   // A job was added, recompute the sleep
+
+    struct Job {
+        const char* name;
+        JobFunction function;
+        void* context;
+        int64_t dueUs;          // Executor task only
+        uint32_t runs;
+        uint32_t notifiedRuns;
+        uint32_t lastExecUs;
+        uint64_t totalExecUs;
+        uint32_t maxExecUs;
+        uint32_t maxLateUs;
+
+        Job()
+            : name("")
+            , function(nullptr)
+            , context(nullptr)
+            , dueUs(NEVER)
+            , runs(0)
+            , notifiedRuns(0)
+            , lastExecUs(0)
+            , totalExecUs(0)
+            , maxExecUs(0)
+            , maxLateUs(0) {}
+    };
+
+    TaskManager& taskManager;
+    TaskManager::TaskId taskId;
+    SemaphoreHandle_t mutex;        // Job table additions and statistics
+    EventGroupHandle_t events;      // Bit n notifies job n
+    Job jobs[MAX_JOBS];
+    std::atomic<uint8_t> jobCount;  // Published once a job is complete
+    bool started;
+
+    static void executorTask(void* parameters);
+    void run();
+    void runJob(uint8_t index, bool notified);
+    int64_t earliestDue(uint8_t count) const;
+};
@@ -0,0 +1,159 @@
+/**
+ * @file cpu_monitor.cpp
+ * @brief Implementation of the run-time stats based CPU utilization sampler
+ */
+
+#include "cpu_monitor.h"
+#include "debug_log.h"
+#include <algorithm>
+#include <string.h>
+
+/*******************************************************************************
+ * Construction / Destruction
+ ******************************************************************************/
+
+CpuMonitor::CpuMonitor()
+    : mutex(xSemaphoreCreateMutex())
+    , ready(false)
+    , previousCount(0)
+    , previousTotal(0)
+    , previousMs(0) {
+}
+
+CpuMonitor::~CpuMonitor() {
+    if (mutex) {
+        vSemaphoreDelete(mutex);
+    }
+}
+
+/*******************************************************************************
+ * Sampling
+ ******************************************************************************/
+
+bool CpuMonitor::begin() {
+#if configGENERATE_RUN_TIME_STATS
+    if (!mutex) {
+        return false;
+    }
+
+    uint32_t total;
+    UBaseType_t count = readCounters(total);
+    if (!count || !total) {
+        DEBUG_LOG_TASK_MANAGER("CPU monitor: run-time counters unavailable");
+        return false;
+    }
+
+    for (UBaseType_t i = 0; i < count; i++) {
+        previous[i] = Counter{status[i].xHandle, status[i].ulRunTimeCounter};
+    }
+    previousCount = count;
+    previousTotal = total;
+    previousMs = millis();
+    ready = true;
+    return true;
+#else
+    DEBUG_LOG_TASK_MANAGER("CPU monitor: built without configGENERATE_RUN_TIME_STATS");
+    return false;
+#endif
+}
+
+bool CpuMonitor::sample() {
+#if configGENERATE_RUN_TIME_STATS
+    if (!ready) return false;
+
+    uint32_t total;
+    UBaseType_t count = readCounters(total);
+    uint32_t elapsed = total - previousTotal;
+    if (!count || !elapsed) {
+        return false;
+    }
+
+    Snapshot next;
+    next.windowMs = millis() - previousMs;
+    next.taskCount = count;
+    for (uint8_t core = 0; core < portNUM_PROCESSORS; core++) {
+        next.corePercent[core] = 100.0f;
+    }
+
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t& task = status[i];
+        TaskUsage& usage = next.tasks[i];
+        // Unsigned, so a counter that wrapped within the window still diffs right
+        uint32_t delta = task.ulRunTimeCounter - previousRunTime(task.xHandle);
+
+        strlcpy(usage.name, task.pcTaskName, sizeof(usage.name));
+        usage.percent = 100.0f * delta / elapsed;
+        usage.idle = isIdleTask(task.xHandle, usage.core);
+        if (!usage.idle) {
+#if configTASKLIST_INCLUDE_COREID
+            usage.core = task.xCoreID < portNUM_PROCESSORS ? task.xCoreID : NO_AFFINITY;
+#else
+            usage.core = NO_AFFINITY;
+#endif
+        } else {
+            next.corePercent[usage.core] = std::max(0.0f, 100.0f - usage.percent);
+        }
+    }
+
+    std::sort(next.tasks, next.tasks + count, [](const TaskUsage& a, const TaskUsage& b) {
+        return a.percent > b.percent;
+    });
+
+    // The next window starts here
+    for (UBaseType_t i = 0; i < count; i++) {
+        previous[i] = Counter{status[i].xHandle, status[i].ulRunTimeCounter};
+    }
+    previousCount = count;
+    previousTotal = total;
+    previousMs += next.windowMs;
+
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return false;
+    next.sequence = latest.sequence + 1;
+    latest = next;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CpuMonitor::getSnapshot(Snapshot& snapshot) const {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked() || latest.sequence == 0) return false;
+
+    snapshot = latest;
+    return true;
+}
+
+/*******************************************************************************
+ * Utility Methods
+ ******************************************************************************/
+
+UBaseType_t CpuMonitor::readCounters(uint32_t& total) {
+    total = 0;
+    UBaseType_t count = uxTaskGetSystemState(status, MAX_TASKS, &total);
+    if (!count) {
+        DEBUG_LOG_TASK_MANAGER("CPU monitor: more than %u tasks", (unsigned)MAX_TASKS);
+    }
+    return count;
+}
+
+uint32_t CpuMonitor::previousRunTime(TaskHandle_t handle) const {
+    for (uint8_t i = 0; i < previousCount; i++) {
+        if (previous[i].handle == handle) {
+            return previous[i].runTime;
+        }
+    }
+    // New in this window, it ran for all of its counter
+    return 0;
+}
+
+bool CpuMonitor::isIdleTask(TaskHandle_t handle, int8_t& core) {
+    for (uint8_t i = 0; i < portNUM_PROCESSORS; i++) {
+        if (handle == xTaskGetIdleTaskHandleForCPU(i)) {
+            core = i;
+            return true;
+        }
+    }
+    return false;
+}
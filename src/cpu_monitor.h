@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "config.h"
+#include "mutex_guard.h"
+
+/**
+ * @brief Per-task and per-core CPU utilization from the FreeRTOS run-time stats
+ *
+ * Each sample() reads the run-time counters of every task with
+ * uxTaskGetSystemState() and diffs them against the previous sample, so a
+ * snapshot covers exactly one window. Task shares are percent of one core;
+ * a core's load is 100 minus the share of its IDLE task.
+ *
+ * Features:
+ * - System tasks included, IDLE and the WiFi/LwIP tasks alike
+ * - Tasks created or restarted within the window are measured from their start
+ * - Fixed buffers, nothing allocated while sampling
+ * - Thread-safe snapshot; sampled by the caller, typically once per window
+ *
+ * Run-time counters are 32 bit and wrap after about 71 minutes at 1 MHz;
+ * diffs are wrap-safe as long as a window stays below that.
+ */
+class CpuMonitor {
+public:
+    static constexpr size_t MAX_TASKS = Config::CpuMonitor::MAX_TASKS;
+    static constexpr int8_t NO_AFFINITY = -1;
+
+    struct TaskUsage {
+        char name[configMAX_TASK_NAME_LEN];
+        int8_t core;            ///< Pinned core, NO_AFFINITY if it runs on either
+        bool idle;              ///< One of the IDLE tasks
+        float percent;          ///< Share of one core over the window
+    };
+
+    struct Snapshot {
+        uint32_t sequence;      ///< Incremented per window, 0 before the first
+        uint32_t windowMs;
+        uint8_t taskCount;
+        TaskUsage tasks[MAX_TASKS];             ///< Busiest first
+        float corePercent[portNUM_PROCESSORS];  ///< Load of each core
+
+        Snapshot() : sequence(0), windowMs(0), taskCount(0), tasks{}, corePercent{} {}
+    };
+
+    CpuMonitor();
+    ~CpuMonitor();
+
+    // Prevent copying
+    CpuMonitor(const CpuMonitor&) = delete;
+    CpuMonitor& operator=(const CpuMonitor&) = delete;
+
+    /**
+     * @brief Take the baseline of the first window
+     * @return false if the firmware was built without run-time stats
+     */
+    bool begin();
+
+    /**
+     * @brief Close the current window and start the next
+     * @return false if the counters could not be read
+     */
+    bool sample();
+
+    /**
+     * @return false before the first complete window
+     */
+    bool getSnapshot(Snapshot& snapshot) const;
+
+    bool isAvailable() const { return ready; }
+
+private:
+    struct Counter {
+        TaskHandle_t handle;
+        uint32_t runTime;
+    };
+
+    SemaphoreHandle_t mutex;
+    bool ready;
+
+    // Sampler state, only touched by sample()
+    TaskStatus_t status[MAX_TASKS];
+    Counter previous[MAX_TASKS];
+    uint8_t previousCount;
+    uint32_t previousTotal;
+    uint32_t previousMs;
+
+    Snapshot latest;
+
+    /**
+     * @brief Read every task's counter
+     * @return Number of tasks, 0 if they do not fit the buffer
+     */
+    UBaseType_t readCounters(uint32_t& total);
+    uint32_t previousRunTime(TaskHandle_t handle) const;
+    static bool isIdleTask(TaskHandle_t handle, int8_t& core);
+};
@@ -19,6 +19,7 @@ DashboardScreen::DashboardScreen()
     , wifiLabel(nullptr)
     , mqttLabel(nullptr)
     , nightLabel(nullptr)
+    , sensorsLabel(nullptr)
     , speedMeter(nullptr)
     , speedLabel(nullptr)
     , currentSpeedIndicator(nullptr)
@@ -92,13 +93,15 @@ void DashboardScreen::init(uint16_t width, uint16_t height) {
 }
 
 void DashboardScreen::update(float temp, int fanSpeed, int targetSpeed, FanController::Mode mode,
-                      bool wifiConnected, bool mqttConnected, bool nightModeEnabled, bool nightModeActive) {
+                      bool wifiConnected, bool mqttConnected, bool nightModeEnabled, bool nightModeActive,
+                      const TemperatureSource::Reading* sensors, uint8_t sensorCount) {
     if (!initialized) return;
 
     updateTemperatureDisplay(temp);
     updateStatusIndicators(wifiConnected, mqttConnected, nightModeEnabled, nightModeActive);
     updateSpeedDisplay(fanSpeed, targetSpeed);
     updateModeDisplay(mode);
+    updateSensorsDisplay(sensors, sensorCount);
 }
 
 bool DashboardScreen::isInitialized() const {
@@ -139,6 +142,15 @@ void DashboardScreen::createTopStatusBar(uint16_t height) {
     // Right side indicator
     nightLabel = createStatusLabel(topBar, LV_ALIGN_RIGHT_MID, -sideMargin, 0, MY_MOON_SYMBOL);
 
+    // Center per-probe strip, hidden until a second probe is found
+    sensorsLabel = createStatusLabel(topBar, LV_ALIGN_CENTER, 0, 0, "");
+    lv_obj_set_width(sensorsLabel, displayWidth * Config::Display::Dashboard::TopBar::SENSOR_WIDTH_RATIO);
+    lv_label_set_long_mode(sensorsLabel, LV_LABEL_LONG_SCROLL_CIRCULAR);
+    lv_obj_set_style_text_align(sensorsLabel, LV_TEXT_ALIGN_CENTER, LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(sensorsLabel, &lv_font_montserrat_12, LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(sensorsLabel, lv_color_hex(DisplayColors::TEXT_SECONDARY), LV_STATE_DEFAULT);
+    lv_obj_add_flag(sensorsLabel, LV_OBJ_FLAG_HIDDEN);
+
     // Set fonts
     lv_obj_set_style_text_font(wifiLabel, iconFont, LV_STATE_DEFAULT);
     lv_obj_set_style_text_font(mqttLabel, &fa_tower_broadcast_16, LV_STATE_DEFAULT);
@@ -427,6 +439,32 @@ void DashboardScreen::updateStatusIndicators(bool wifiConnected, bool mqttConnec
     lastStatus.nightModeActive = nightModeActive;
 }
 
+void DashboardScreen::updateSensorsDisplay(const TemperatureSource::Reading* sensors, uint8_t sensorCount) {
+    // A single probe is already shown on the temperature meter
+    if (sensorCount < 2) {
+        lv_obj_add_flag(sensorsLabel, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+
+    // Each probe is tagged with the tail of its ROM code, e.g. "3a7f 24.5°"
+    char text[TemperatureSource::MAX_SENSORS * 16];
+    size_t len = 0;
+    const size_t tagOffset = TemperatureSource::ID_LENGTH - 1 - Config::Display::Dashboard::TopBar::SENSOR_ID_CHARS;
+    for (uint8_t i = 0; i < sensorCount && len < sizeof(text); i++) {
+        const TemperatureSource::Reading& sensor = sensors[i];
+        if (sensor.valid) {
+            len += snprintf(text + len, sizeof(text) - len, "%s%s %.1f°",
+                            i ? "  " : "", sensor.id + tagOffset, sensor.tempC);
+        } else {
+            len += snprintf(text + len, sizeof(text) - len, "%s%s --",
+                            i ? "  " : "", sensor.id + tagOffset);
+        }
+    }
+
+    lv_label_set_text(sensorsLabel, text);
+    lv_obj_clear_flag(sensorsLabel, LV_OBJ_FLAG_HIDDEN);
+}
+
 void DashboardScreen::updateSpeedDisplay(int fanSpeed, int targetSpeed) {
     if (!currentSpeedAnimationInProgress && fanSpeed != currentSpeedValue) {
         lv_anim_t anim;
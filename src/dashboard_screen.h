@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include "lvgl.h"
 #include "fan_controller.h"
+#include "temperature_source.h"
 #include "fonts/icons.h"
 
 /**
@@ -11,6 +12,7 @@
  * 
  * Features:
  * - Temperature display with animated arc
+ * - Per-probe readings when more than one sensor is on the bus
  * - Status indicators for WiFi, MQTT, and night mode
  * - Fan speed and mode display
  * - Thread-safe UI updates
@@ -27,7 +29,8 @@ public:
 
     // Core display interface
     void update(float temp, int fanSpeed, int targetSpeed, FanController::Mode mode,
-               bool wifiConnected, bool mqttConnected, bool nightModeEnabled, bool nightModeActive);
+               bool wifiConnected, bool mqttConnected, bool nightModeEnabled, bool nightModeActive,
+               const TemperatureSource::Reading* sensors, uint8_t sensorCount);
     lv_obj_t* getScreen() { return screen; }
     SemaphoreHandle_t getUIMutex() const { return uiMutex; }
     bool isInitialized() const;
@@ -50,6 +53,7 @@ private:
     lv_obj_t* wifiLabel;
     lv_obj_t* mqttLabel;
     lv_obj_t* nightLabel;
+    lv_obj_t* sensorsLabel;
     lv_meter_indicator_t* temperatureIndicator;
     lv_obj_t* speedMeter;
     lv_obj_t* tempMeter;
@@ -86,6 +90,7 @@ private:
                               bool nightModeEnabled, bool nightModeActive);
     void updateSpeedDisplay(int fanSpeed, int targetSpeed);
     void updateModeDisplay(FanController::Mode mode);
+    void updateSensorsDisplay(const TemperatureSource::Reading* sensors, uint8_t sensorCount);
 
     // Animation handling
     static void set_temp_value(void* obj, int32_t v) {
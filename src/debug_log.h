@@ -3,16 +3,25 @@
 
 #include <config.h>
 
+#ifdef ARDUINO
+#define DEBUG_LOG_PRINT(enabled, prefix, msg, ...) if (enabled) { Serial.print(prefix " "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
+#else
+// Host builds (env:native) have no Serial, the tests show stdout
+#include <cstdio>
+#define DEBUG_LOG_PRINT(enabled, prefix, msg, ...) if (enabled) { printf(prefix " "); printf(msg, ##__VA_ARGS__); printf("\n"); }
+#endif
+
 // Create component-specific debug macros
-#define DEBUG_LOG_MAIN(msg, ...) if (Config::System::Debug::MAIN) { Serial.print("[MAIN] "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
-#define DEBUG_LOG_INIT(msg, ...) if (Config::System::Debug::INITIALIZER) { Serial.print("[INIT] "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
-#define DEBUG_LOG_WIFI(msg, ...) if (Config::System::Debug::WIFI) { Serial.print("[WIFI] "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
-#define DEBUG_LOG_MQTT(msg, ...) if (Config::System::Debug::MQTT) { Serial.print("[MQTT] "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
-#define DEBUG_LOG_NTP(msg, ...) if (Config::System::Debug::NTP) { Serial.print("[NTP] "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
-#define DEBUG_LOG_TEMP(msg, ...) if (Config::System::Debug::TEMP) { Serial.print("[TEMP] "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
-#define DEBUG_LOG_FAN(msg, ...) if (Config::System::Debug::FAN) { Serial.print("[FAN] "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
-#define DEBUG_LOG_DISPLAY(msg, ...) if (Config::System::Debug::SCREEN) { Serial.print("[DISP] "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
-#define DEBUG_LOG_TASK_MANAGER(msg, ...) if (Config::System::Debug::TASK_MANAGER) { Serial.print("[TASK] "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
-#define DEBUG_LOG_PERSISTENT(msg, ...) if (Config::System::Debug::PERSISTENT) { Serial.print("[PERS] "); Serial.printf(msg, ##__VA_ARGS__); Serial.println(); }
+#define DEBUG_LOG_MAIN(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::MAIN, "[MAIN]", msg, ##__VA_ARGS__)
+#define DEBUG_LOG_INIT(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::INITIALIZER, "[INIT]", msg, ##__VA_ARGS__)
+#define DEBUG_LOG_WIFI(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::WIFI, "[WIFI]", msg, ##__VA_ARGS__)
+#define DEBUG_LOG_MQTT(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::MQTT, "[MQTT]", msg, ##__VA_ARGS__)
+#define DEBUG_LOG_NTP(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::NTP, "[NTP]", msg, ##__VA_ARGS__)
+#define DEBUG_LOG_TEMP(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::TEMP, "[TEMP]", msg, ##__VA_ARGS__)
+#define DEBUG_LOG_FAN(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::FAN, "[FAN]", msg, ##__VA_ARGS__)
+#define DEBUG_LOG_DISPLAY(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::SCREEN, "[DISP]", msg, ##__VA_ARGS__)
+#define DEBUG_LOG_TASK_MANAGER(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::TASK_MANAGER, "[TASK]", msg, ##__VA_ARGS__)
+#define DEBUG_LOG_PERSISTENT(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::PERSISTENT, "[PERS]", msg, ##__VA_ARGS__)
+#define DEBUG_LOG_HISTORY(msg, ...) DEBUG_LOG_PRINT(Config::System::Debug::HISTORY, "[HIST]", msg, ##__VA_ARGS__)
 
-#endif // DEBUG_LOG_H
\ No newline at end of file
+#endif // DEBUG_LOG_H
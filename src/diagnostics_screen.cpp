@@ -0,0 +1,200 @@
+#include "diagnostics_screen.h"
+#include "display_colors.h"
+#include "debug_log.h"
+
+namespace {
+    constexpr uint8_t COLUMN_TASK = 0;
+    constexpr uint8_t COLUMN_CORE = 1;
+    constexpr uint8_t COLUMN_CPU = 2;
+    constexpr uint8_t COLUMNS = 3;
+}
+
+/*******************************************************************************
+ * Construction
+ ******************************************************************************/
+
+DiagnosticsScreen::DiagnosticsScreen()
+    : displayWidth(0)
+    , displayHeight(0)
+    , screen(nullptr)
+    , windowLabel(nullptr)
+    , coreBars{}
+    , coreLabels{}
+    , taskTable(nullptr)
+    , shownSequence(0)
+{
+}
+
+/*******************************************************************************
+ * Core UI
+ ******************************************************************************/
+
+bool DiagnosticsScreen::show() {
+    if (!screen) {
+        createUI();
+        if (!screen) {
+            DEBUG_LOG_DISPLAY("Failed to create diagnostics screen");
+            return false;
+        }
+    }
+
+    lv_scr_load(screen);
+    return true;
+}
+
+void DiagnosticsScreen::createUI() {
+    screen = lv_obj_create(NULL);
+    if (!screen) return;
+
+    lv_obj_set_scrollbar_mode(screen, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_clear_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+
+    // Match the other screens' gradient background
+    lv_obj_set_style_bg_color(screen, lv_color_hex(DisplayColors::BG_DARK), LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_grad_color(screen, lv_color_hex(DisplayColors::BG_LIGHT), LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_grad_dir(screen, LV_GRAD_DIR_VER, LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, LV_STATE_DEFAULT);
+
+    uint16_t margin = displayWidth * Config::Display::Diagnostics::MARGIN_TO_WIDTH_RATIO;
+    uint16_t titleHeight = displayHeight * Config::Display::Diagnostics::TITLE_TO_SCREEN_RATIO;
+    uint16_t rowHeight = displayHeight * Config::Display::Diagnostics::CORE_ROW_TO_SCREEN_RATIO;
+
+    // Title and window length
+    lv_obj_t* titleLabel = lv_label_create(screen);
+    lv_label_set_text(titleLabel, "CPU");
+    lv_obj_align(titleLabel, LV_ALIGN_TOP_LEFT, margin, titleHeight * 0.2);
+    lv_obj_set_style_text_font(titleLabel, &lv_font_montserrat_16, LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(titleLabel, lv_color_hex(DisplayColors::TEXT_PRIMARY), LV_STATE_DEFAULT);
+
+    windowLabel = lv_label_create(screen);
+    lv_label_set_text(windowLabel, "Sampling...");
+    lv_obj_align(windowLabel, LV_ALIGN_TOP_RIGHT, -margin, titleHeight * 0.3);
+    lv_obj_set_style_text_font(windowLabel, &lv_font_montserrat_12, LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(windowLabel, lv_color_hex(DisplayColors::TEXT_SECONDARY), LV_STATE_DEFAULT);
+
+    for (uint8_t core = 0; core < portNUM_PROCESSORS; core++) {
+        createCoreRow(core, titleHeight + core * rowHeight, rowHeight);
+    }
+
+    uint16_t tableY = titleHeight + portNUM_PROCESSORS * rowHeight;
+    createTaskTable(tableY, displayHeight - tableY);
+}
+
+void DiagnosticsScreen::createCoreRow(uint8_t core, uint16_t yOffset, uint16_t height) {
+    uint16_t margin = displayWidth * Config::Display::Diagnostics::MARGIN_TO_WIDTH_RATIO;
+    uint16_t barWidth = displayWidth * Config::Display::Diagnostics::BAR_TO_WIDTH_RATIO;
+
+    lv_obj_t* nameLabel = lv_label_create(screen);
+    lv_label_set_text_fmt(nameLabel, "Core %u", core);
+    lv_obj_align(nameLabel, LV_ALIGN_TOP_LEFT, margin, yOffset + height * 0.15);
+    lv_obj_set_style_text_font(nameLabel, &lv_font_montserrat_12, LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(nameLabel, lv_color_hex(DisplayColors::TEXT_SECONDARY), LV_STATE_DEFAULT);
+
+    lv_obj_t* bar = lv_bar_create(screen);
+    lv_obj_set_size(bar, barWidth, height * 0.5);
+    lv_obj_align(bar, LV_ALIGN_TOP_MID, 0, yOffset + height * 0.25);
+    lv_bar_set_range(bar, 0, 100);
+    lv_bar_set_value(bar, 0, LV_ANIM_OFF);
+    lv_obj_set_style_bg_color(bar, lv_color_hex(DisplayColors::METER), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(bar, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(bar, lv_color_hex(DisplayColors::SPEED_GOOD), LV_PART_INDICATOR);
+    coreBars[core] = bar;
+
+    lv_obj_t* valueLabel = lv_label_create(screen);
+    lv_label_set_text(valueLabel, "--");
+    lv_obj_align(valueLabel, LV_ALIGN_TOP_RIGHT, -margin, yOffset + height * 0.15);
+    lv_obj_set_style_text_font(valueLabel, &lv_font_montserrat_12, LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(valueLabel, lv_color_hex(DisplayColors::TEXT_PRIMARY), LV_STATE_DEFAULT);
+    coreLabels[core] = valueLabel;
+}
+
+void DiagnosticsScreen::createTaskTable(uint16_t yOffset, uint16_t height) {
+    uint16_t margin = displayWidth * Config::Display::Diagnostics::MARGIN_TO_WIDTH_RATIO;
+    uint16_t tableWidth = displayWidth - margin * 2;
+
+    taskTable = lv_table_create(screen);
+    lv_table_set_col_cnt(taskTable, COLUMNS);
+    lv_table_set_row_cnt(taskTable, Config::Display::Diagnostics::TASK_ROWS + 1);
+    lv_table_set_col_width(taskTable, COLUMN_TASK, tableWidth * 0.56);
+    lv_table_set_col_width(taskTable, COLUMN_CORE, tableWidth * 0.2);
+    lv_table_set_col_width(taskTable, COLUMN_CPU, tableWidth * 0.24);
+    lv_obj_set_size(taskTable, tableWidth, height);
+    lv_obj_align(taskTable, LV_ALIGN_TOP_LEFT, margin, yOffset);
+    lv_obj_clear_flag(taskTable, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scrollbar_mode(taskTable, LV_SCROLLBAR_MODE_OFF);
+
+    // Dense, borderless rows on the screen background
+    lv_obj_set_style_bg_opa(taskTable, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_width(taskTable, 0, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(taskTable, 0, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(taskTable, LV_OPA_TRANSP, LV_PART_ITEMS);
+    lv_obj_set_style_border_width(taskTable, 0, LV_PART_ITEMS);
+    lv_obj_set_style_pad_top(taskTable, 1, LV_PART_ITEMS);
+    lv_obj_set_style_pad_bottom(taskTable, 1, LV_PART_ITEMS);
+    lv_obj_set_style_pad_left(taskTable, 0, LV_PART_ITEMS);
+    lv_obj_set_style_pad_right(taskTable, 0, LV_PART_ITEMS);
+    lv_obj_set_style_text_font(taskTable, &lv_font_montserrat_12, LV_PART_ITEMS);
+    lv_obj_set_style_text_color(taskTable, lv_color_hex(DisplayColors::TEXT_PRIMARY), LV_PART_ITEMS);
+
+    lv_table_set_cell_value(taskTable, 0, COLUMN_TASK, "Task");
+    lv_table_set_cell_value(taskTable, 0, COLUMN_CORE, "Core");
+    lv_table_set_cell_value(taskTable, 0, COLUMN_CPU, "CPU");
+}
+
+/*******************************************************************************
+ * Status Updates
+ ******************************************************************************/
+
+void DiagnosticsScreen::update(const CpuMonitor::Snapshot& usage) {
+    if (!screen || usage.sequence == shownSequence) return;
+    shownSequence = usage.sequence;
+
+    lv_label_set_text_fmt(windowLabel, "%lu tasks, %lu s window",
+                          (unsigned long)usage.taskCount,
+                          (unsigned long)((usage.windowMs + 500) / 1000));
+
+    for (uint8_t core = 0; core < portNUM_PROCESSORS; core++) {
+        float percent = usage.corePercent[core];
+        lv_bar_set_value(coreBars[core], static_cast<int32_t>(percent + 0.5f), LV_ANIM_OFF);
+        lv_obj_set_style_bg_color(coreBars[core], loadColor(percent), LV_PART_INDICATOR);
+        lv_label_set_text_fmt(coreLabels[core], "%d%%", static_cast<int>(percent + 0.5f));
+    }
+
+    // Busiest first; the IDLE tasks are already the core bars
+    uint8_t row = 1;
+    for (uint8_t i = 0; i < usage.taskCount && row <= Config::Display::Diagnostics::TASK_ROWS; i++) {
+        const CpuMonitor::TaskUsage& task = usage.tasks[i];
+        if (task.idle) continue;
+
+        lv_table_set_cell_value(taskTable, row, COLUMN_TASK, task.name);
+        if (task.core == CpuMonitor::NO_AFFINITY) {
+            lv_table_set_cell_value(taskTable, row, COLUMN_CORE, "any");
+        } else {
+            lv_table_set_cell_value_fmt(taskTable, row, COLUMN_CORE, "%d", task.core);
+        }
+        // LVGL's printf has no float support
+        int tenths = static_cast<int>(task.percent * 10.0f + 0.5f);
+        lv_table_set_cell_value_fmt(taskTable, row, COLUMN_CPU, "%d.%d%%", tenths / 10, tenths % 10);
+        row++;
+    }
+    for (; row <= Config::Display::Diagnostics::TASK_ROWS; row++) {
+        for (uint8_t column = 0; column < COLUMNS; column++) {
+            lv_table_set_cell_value(taskTable, row, column, "");
+        }
+    }
+}
+
+void DiagnosticsScreen::showUnavailable() {
+    if (!screen) return;
+    lv_label_set_text(windowLabel, "Run-time stats unavailable");
+}
+
+lv_color_t DiagnosticsScreen::loadColor(float percent) {
+    if (percent >= Config::Display::Diagnostics::CRITICAL_THRESHOLD) {
+        return lv_color_hex(DisplayColors::SPEED_CRITICAL);
+    }
+    if (percent >= Config::Display::Diagnostics::BUSY_THRESHOLD) {
+        return lv_color_hex(DisplayColors::SPEED_WARNING);
+    }
+    return lv_color_hex(DisplayColors::SPEED_GOOD);
+}
@@ -0,0 +1,70 @@
+#ifndef DIAGNOSTICS_SCREEN_H
+#define DIAGNOSTICS_SCREEN_H
+
+#include <Arduino.h>
+#include "lvgl.h"
+#include "cpu_monitor.h"
+
+/**
+ * @brief Diagnostics screen with the CPU load per core and per task
+ *
+ * Features:
+ * - Load bar per core, coloured by threshold
+ * - Busiest tasks with their core and share of one core
+ * - Created on first use, then kept and reloaded
+ *
+ * Not thread-safe; the caller holds the dashboard UI mutex, the lock
+ * the render task takes around lv_timer_handler().
+ */
+class DiagnosticsScreen {
+public:
+    DiagnosticsScreen();
+
+    /**
+     * @brief Initialize display dimensions
+     */
+    void init(uint16_t width, uint16_t height) {
+        displayWidth = width;
+        displayHeight = height;
+    }
+
+    /**
+     * @brief Create the screen and make it the active one
+     */
+    bool show();
+
+    /**
+     * @brief Refresh from a CPU snapshot, only when it is a new window
+     */
+    void update(const CpuMonitor::Snapshot& usage);
+
+    /**
+     * @brief Show that the firmware has no run-time stats
+     */
+    void showUnavailable();
+
+    lv_obj_t* getScreen() { return screen; }
+
+private:
+    // Display dimensions
+    uint16_t displayWidth;
+    uint16_t displayHeight;
+
+    // UI Elements
+    lv_obj_t* screen;
+    lv_obj_t* windowLabel;
+    lv_obj_t* coreBars[portNUM_PROCESSORS];
+    lv_obj_t* coreLabels[portNUM_PROCESSORS];
+    lv_obj_t* taskTable;
+
+    uint32_t shownSequence;
+
+    // UI Creation Methods
+    void createUI();
+    void createCoreRow(uint8_t core, uint16_t yOffset, uint16_t height);
+    void createTaskTable(uint16_t yOffset, uint16_t height);
+
+    static lv_color_t loadColor(float percent);
+};
+
+#endif // DIAGNOSTICS_SCREEN_H
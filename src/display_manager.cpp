@@ -14,6 +14,7 @@ DisplayManager::DisplayManager(TaskManager& tm, TempSensor& ts, FanController& f
     , fanController(fc)
     , wifiManager(wm)
     , mqttManager(mm)
+    , cpuMonitor(nullptr)
     , driver(nullptr)
     , initialized(false)
     , needsScreenTransition(false)
@@ -58,6 +59,7 @@ bool DisplayManager::begin(DisplayDriver* displayDriver) {
 
     bootUI.init(driver->width(), driver->height());
     dashboardUI.init(driver->width(), driver->height());
+    diagnosticsUI.init(driver->width(), driver->height());
 
     // Make sure we're in a clean state before creating first screen
     lv_timer_handler();
@@ -70,10 +72,15 @@ bool DisplayManager::begin(DisplayDriver* displayDriver) {
         "DisplayRender",
         Config::Display::DisplayRender::STACK_SIZE,
         Config::Display::DisplayRender::TASK_PRIORITY,
-        Config::Display::DisplayRender::TASK_CORE
+        Config::Display::DisplayRender::TASK_CORE,
+        Config::Display::DisplayRender::PERIOD_MS,
+        Config::Display::DisplayRender::DEADLINE_MS,
+        Config::Display::DisplayRender::POLICY,
+        Config::Display::DisplayRender::WATCHDOG,
+        Config::Display::DisplayRender::MEMORY
     };
 
-    esp_err_t err = taskManager.createTask(renderConfig, displayRenderTask, this);
+    esp_err_t err = taskManager.createTask(renderConfig, displayRenderTask, this, &renderTaskId);
     if (err != ESP_OK) {
         DEBUG_LOG_DISPLAY("DisplayManager: DisplayRender task creation failed with error %d", err);
         return false;
@@ -83,10 +90,15 @@ bool DisplayManager::begin(DisplayDriver* displayDriver) {
         "DisplayUpdate",
         Config::Display::DisplayUpdate::STACK_SIZE,
         Config::Display::DisplayUpdate::TASK_PRIORITY,
-        Config::Display::DisplayUpdate::TASK_CORE
+        Config::Display::DisplayUpdate::TASK_CORE,
+        Config::Display::DisplayUpdate::PERIOD_MS,
+        Config::Display::DisplayUpdate::DEADLINE_MS,
+        Config::Display::DisplayUpdate::POLICY,
+        Config::Display::DisplayUpdate::WATCHDOG,
+        Config::Display::DisplayUpdate::MEMORY
     };
 
-    err = taskManager.createTask(updateConfig, displayUpdateTask, this);
+    err = taskManager.createTask(updateConfig, displayUpdateTask, this, &updateTaskId);
     if (err != ESP_OK) {
         DEBUG_LOG_DISPLAY("DisplayManager: DisplayUpdate task creation failed with error %d", err);
         return false;
@@ -115,6 +127,8 @@ void DisplayManager::processDisplayRender() {
     TickType_t xLastWakeTime = xTaskGetTickCount();
 
     while (true) {
+        taskManager.heartbeat(renderTaskId);
+
         // Don't try to render during transitions
         if (!needsScreenTransition) {
             bool locked = false;
@@ -134,6 +148,7 @@ void DisplayManager::processDisplayRender() {
             vTaskDelay(pdMS_TO_TICKS(10));
         }
 
+        taskManager.workDone(renderTaskId);
         vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(1));
     }
 }
@@ -143,7 +158,7 @@ void DisplayManager::processDisplayUpdates() {
     DisplayUpdateCommand cmd;
     
     while (true) {
-        taskManager.updateTaskRunTime("DisplayUpdate");
+        taskManager.heartbeat(updateTaskId);
 
         // Check for display events
         DisplayEventMessage event;
@@ -156,6 +171,16 @@ void DisplayManager::processDisplayUpdates() {
                         updateActivityTime();
                     }
                     break;
+                case DisplayEvent::TOGGLE_DIAGNOSTICS:
+                    if (!screenOn) {
+                        handleScreenPowerChange(true);
+                    } else {
+                        updateActivityTime();
+                    }
+                    switchDiagnostics();
+                    break;
+                default:
+                    break;
             }
         }
 
@@ -227,6 +252,18 @@ void DisplayManager::processDisplayUpdates() {
         }   
              // Process screen-specific logic
         switch (currentState) {
+            case DisplayState::DIAGNOSTICS: {
+                MutexGuard diagGuard(dashboardUI.getUIMutex(), pdMS_TO_TICKS(100));
+                if (!diagGuard.isLocked()) {
+                    DEBUG_LOG_DISPLAY("Failed to acquire mutex for diagnostics updates - skipping cycle");
+                    break;
+                }
+
+                // The dashboard is not shown; it catches up when switched back
+                while (xQueueReceive(DisplayUpdateCommandQueue, &cmd, 0) == pdTRUE) {}
+                updateDiagnosticsValues();
+                break;
+            }
             case DisplayState::DASHBOARD:
                 DEBUG_LOG_DISPLAY("Starting dashboard update cycle");
                 
@@ -252,7 +289,9 @@ void DisplayManager::processDisplayUpdates() {
                             cmd.wifiConnected,
                             cmd.mqttConnected,
                             cmd.nightModeEnabled,
-                            cmd.nightModeActive
+                            cmd.nightModeActive,
+                            cmd.sensors,
+                            cmd.sensorCount
                         );
                     } catch (...) {
                         DEBUG_LOG_DISPLAY("Exception during dashboard update");
@@ -270,10 +309,58 @@ void DisplayManager::processDisplayUpdates() {
                 break;
         }
 
+        taskManager.workDone(updateTaskId);
         vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(Config::Display::DisplayRender::TASK_DELAY));
     }
 }
 
+void DisplayManager::switchDiagnostics() {
+    if (currentState != DisplayState::DASHBOARD && currentState != DisplayState::DIAGNOSTICS) {
+        DEBUG_LOG_DISPLAY("Diagnostics unavailable before the dashboard");
+        return;
+    }
+
+    bool toDiagnostics = currentState == DisplayState::DASHBOARD;
+    {
+        MutexGuard guard(dashboardUI.getUIMutex(), pdMS_TO_TICKS(1000));
+        if (!guard.isLocked()) {
+            DEBUG_LOG_DISPLAY("Failed to acquire UI mutex for diagnostics toggle");
+            return;
+        }
+
+        if (toDiagnostics) {
+            if (!diagnosticsUI.show()) return;
+            updateDiagnosticsValues();
+            currentState = DisplayState::DIAGNOSTICS;
+        } else {
+            lv_scr_load(dashboardUI.getScreen());
+            currentState = DisplayState::DASHBOARD;
+        }
+    }
+
+    DEBUG_LOG_DISPLAY("Switched to %s screen", toDiagnostics ? "diagnostics" : "dashboard");
+    if (!toDiagnostics) {
+        updateDashboardValues();
+    }
+}
+
+/**
+ * Refresh the diagnostics screen from the latest CPU window
+ * Caller holds the dashboard UI mutex
+ */
+void DisplayManager::updateDiagnosticsValues() {
+    if (!cpuMonitor || !cpuMonitor->isAvailable()) {
+        diagnosticsUI.showUnavailable();
+        return;
+    }
+
+    // Static, the snapshot is too large for the task stack
+    static CpuMonitor::Snapshot usage;
+    if (cpuMonitor->getSnapshot(usage)) {
+        diagnosticsUI.update(usage);
+    }
+}
+
 void DisplayManager::switchToDashboardUI() {
     DEBUG_LOG_DISPLAY("Attempting to switch to dashboard. Initialized: %d, Current State: %d", 
                      initialized, static_cast<int>(currentState));
@@ -324,18 +411,26 @@ void DisplayManager::updateBootStatusDetail(const char* component,
 void DisplayManager::updateDashboardValues() {
     if (!initialized) return;
 
-    // Create a command with current state
+    FanController::Snapshot fan = fanController.getSnapshot();
+
+    // Create a command with current state, the dashboard shows the first fan
     DisplayUpdateCommand cmd(
         tempSensor.getSmoothedTemp(),
-        fanController.getCurrentSpeed(),
-        fanController.getTargetSpeed(),
-        fanController.getControlMode(),
+        fan.currentSpeed[0],
+        fan.targetSpeed[0],
+        fan.mode,
         wifiManager.isConnected(),
         mqttManager.isConnected(),
-        fanController.isNightModeEnabled(),
-        fanController.isNightModeActive()
+        fan.nightModeEnabled,
+        fan.nightModeActive
     );
 
+    for (uint8_t i = 0; i < tempSensor.getSensorCount(); i++) {
+        if (tempSensor.getSensorReading(i, cmd.sensors[cmd.sensorCount])) {
+            cmd.sensorCount++;
+        }
+    }
+
     if (xQueueSend(DisplayUpdateCommandQueue, &cmd, 0) != pdTRUE) {
         DEBUG_LOG_DISPLAY("Failed to queue dashboard update command");
     } else {
@@ -499,4 +594,16 @@ void DisplayManager::handleButtonPress() {
     if (xQueueSend(displayEventQueue, &msg, pdMS_TO_TICKS(100)) != pdTRUE) {
         DEBUG_LOG_DISPLAY("Failed to queue button press event");
     }
-}
\ No newline at end of file
+}
+
+void DisplayManager::toggleDiagnostics() {
+    if (!initialized || !displayEventQueue) {
+        DEBUG_LOG_DISPLAY("Cannot toggle diagnostics - not initialized");
+        return;
+    }
+
+    DisplayEventMessage msg{DisplayEvent::TOGGLE_DIAGNOSTICS};
+    if (xQueueSend(displayEventQueue, &msg, pdMS_TO_TICKS(100)) != pdTRUE) {
+        DEBUG_LOG_DISPLAY("Failed to queue diagnostics toggle");
+    }
+}
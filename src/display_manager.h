@@ -12,6 +12,7 @@
 #include "display_driver.h"
 #include "dashboard_screen.h"
 #include "boot_screen.h"
+#include "diagnostics_screen.h"
 #include "debug_log.h"
 
 // System components
@@ -19,6 +20,7 @@
 #include "temp_sensor.h"
 #include "wifi_manager.h"
 #include "mqtt_manager.h"
+#include "cpu_monitor.h"
 
 /*******************************************************************************
  * Display Manager Class
@@ -33,7 +35,8 @@ public:
     bool begin(DisplayDriver* displayDriver);
     enum class DisplayState {
         BOOT,
-        DASHBOARD
+        DASHBOARD,
+        DIAGNOSTICS
     };
 
     void updateBootStatus(const char* component, BootScreen::ComponentStatus status);
@@ -62,12 +65,22 @@ public:
 
     void handleButtonPress();
 
+    /**
+     * @brief Switch between the dashboard and the diagnostics screen
+     */
+    void toggleDiagnostics();
+
+    void registerCpuMonitor(CpuMonitor* monitor) { cpuMonitor = monitor; }
+
 private:
     TaskManager& taskManager;
+    TaskManager::TaskId renderTaskId;
+    TaskManager::TaskId updateTaskId;
     TempSensor& tempSensor;
     FanController& fanController;
     WifiManager& wifiManager;
     MqttManager& mqttManager;
+    CpuMonitor* cpuMonitor;
 
     DisplayDriver* driver;
     bool initialized;
@@ -75,6 +88,7 @@ private:
     DisplayState currentState;
     DashboardScreen dashboardUI;
     BootScreen bootUI;
+    DiagnosticsScreen diagnosticsUI;
 
     // LVGL and uiUpdate task handling
     static void displayRenderTask(void* parameters);
@@ -82,6 +96,8 @@ private:
     static void displayUpdateTask(void* parameters);
     void processDisplayUpdates();
     void updateDashboardValues();
+    void switchDiagnostics();
+    void updateDiagnosticsValues();
 
     struct DisplayUpdateCommand {
         enum class CommandType {
@@ -97,6 +113,8 @@ private:
         bool mqttConnected;
         bool nightModeEnabled;
         bool nightModeActive;
+        uint8_t sensorCount;
+        TemperatureSource::Reading sensors[TemperatureSource::MAX_SENSORS];
 
         DisplayUpdateCommand() {} // Default constructor
         
@@ -111,7 +129,8 @@ private:
             , wifiConnected(wifi)
             , mqttConnected(mqtt)
             , nightModeEnabled(nightEnabled)
-            , nightModeActive(nightActive) {}
+            , nightModeActive(nightActive)
+            , sensorCount(0) {}
     };
 
     QueueHandle_t DisplayUpdateCommandQueue;
@@ -133,7 +152,8 @@ private:
     
     enum class DisplayEvent {
         BUTTON_PRESS,
-        CHECK_TIMEOUT
+        CHECK_TIMEOUT,
+        TOGGLE_DIAGNOSTICS
     };
 
     struct DisplayEventMessage {
@@ -0,0 +1,242 @@
+/**
+ * @file fan_calibrator.cpp
+ * @brief Implementation of the non-blocking fan calibration sweep
+ */
+
+#include "fan_calibrator.h"
+
+namespace {
+    namespace Cal = Config::Fan::Calibration;
+
+    constexpr uint8_t FULL_PWM = 255;
+    constexpr uint16_t NO_SAMPLE = UINT16_MAX;
+}
+
+/*******************************************************************************
+ * Construction
+ ******************************************************************************/
+
+FanCalibrator::FanCalibrator()
+    : phase(Phase::IDLE)
+    , pwm(0)
+    , stepStartMs(0)
+    , lastRPM(NO_SAMPLE)
+    , stableSamples(0)
+    , kicking(false)
+    , lastRunningPWM(0)
+    , samples{}
+    , sampleCount(0)
+    , result{} {
+}
+
+/*******************************************************************************
+ * Control
+ ******************************************************************************/
+
+void FanCalibrator::start(uint32_t nowMs) {
+    sampleCount = 0;
+    result = Result{};
+    kicking = false;
+    lastRunningPWM = 0;
+    phase = Phase::SPIN_DOWN;
+    enterStep(0, nowMs);
+}
+
+void FanCalibrator::abort() {
+    if (isActive()) {
+        phase = Phase::FAILED;
+    }
+}
+
+bool FanCalibrator::isActive() const {
+    return phase != Phase::IDLE && phase != Phase::DONE && phase != Phase::FAILED;
+}
+
+uint8_t FanCalibrator::update(uint32_t nowMs, uint16_t rpm) {
+    switch (phase) {
+        case Phase::SPIN_DOWN:
+            if (!isSettled(nowMs, rpm)) break;
+            if (rpm == 0) {
+                phase = Phase::FIND_START;
+                enterStep(Cal::START_STEP, nowMs);
+            } else {
+                // Fan keeps turning at zero duty, there is no start threshold
+                result.minStartPWM = 0;
+                phase = Phase::SWEEP;
+                enterStep(FULL_PWM, nowMs);
+            }
+            break;
+
+        case Phase::FIND_START:
+            if (!isSettled(nowMs, rpm)) break;
+            if (rpm > 0) {
+                result.minStartPWM = pwm;
+                phase = Phase::SWEEP;
+                enterStep(FULL_PWM, nowMs);
+            } else if (pwm > FULL_PWM - Cal::START_STEP) {
+                // Not even full duty produced tach pulses
+                phase = Phase::FAILED;
+                pwm = 0;
+            } else {
+                enterStep(pwm + Cal::START_STEP, nowMs);
+            }
+            break;
+
+        case Phase::SWEEP:
+            if (!isSettled(nowMs, rpm)) break;
+            if (rpm == 0) {
+                if (sampleCount == 0) {
+                    phase = Phase::FAILED;
+                    pwm = 0;
+                    break;
+                }
+                // Stopped between this duty and the last running one. Spin
+                // back up and search down from there in fine steps.
+                phase = Phase::FIND_STALL;
+                kicking = true;
+                enterStep(FULL_PWM, nowMs);
+                break;
+            }
+            addSample(pwm, rpm);
+            lastRunningPWM = pwm;
+            if (pwm == 0) {
+                result.stallPWM = 0;
+                finish();
+                break;
+            }
+            enterStep(pwm > Cal::SWEEP_STEP ? pwm - Cal::SWEEP_STEP : 0, nowMs);
+            break;
+
+        case Phase::FIND_STALL:
+            if (kicking) {
+                if (nowMs - stepStartMs < Cal::KICK_MS) break;
+                kicking = false;
+                result.stallPWM = lastRunningPWM;
+                enterStep(lastRunningPWM > Cal::STALL_STEP ? lastRunningPWM - Cal::STALL_STEP : 0,
+                          nowMs);
+                break;
+            }
+            if (!isSettled(nowMs, rpm)) break;
+            if (rpm == 0) {
+                // stallPWM holds the last duty that kept it turning
+                finish();
+                break;
+            }
+            addSample(pwm, rpm);
+            result.stallPWM = pwm;
+            if (pwm == 0) {
+                finish();
+                break;
+            }
+            enterStep(pwm > Cal::STALL_STEP ? pwm - Cal::STALL_STEP : 0, nowMs);
+            break;
+
+        default:
+            break;
+    }
+
+    return pwm;
+}
+
+/*******************************************************************************
+ * Step Handling
+ ******************************************************************************/
+
+void FanCalibrator::enterStep(uint8_t duty, uint32_t nowMs) {
+    pwm = duty;
+    stepStartMs = nowMs;
+    lastRPM = NO_SAMPLE;
+    stableSamples = 0;
+}
+
+bool FanCalibrator::isSettled(uint32_t nowMs, uint16_t rpm) {
+    uint32_t elapsed = nowMs - stepStartMs;
+
+    // Compare with the previous sample, relative tolerance with a floor
+    // so low speeds are not held to an unrealistic absolute precision
+    uint16_t tolerance = static_cast<uint32_t>(rpm) * Cal::SETTLE_TOLERANCE_PERCENT / 100;
+    if (tolerance < Cal::SETTLE_MIN_TOLERANCE_RPM) {
+        tolerance = Cal::SETTLE_MIN_TOLERANCE_RPM;
+    }
+
+    if (lastRPM != NO_SAMPLE) {
+        uint16_t diff = rpm > lastRPM ? rpm - lastRPM : lastRPM - rpm;
+        stableSamples = diff <= tolerance ? stableSamples + 1 : 0;
+    }
+    lastRPM = rpm;
+
+    if (elapsed >= Cal::SETTLE_TIMEOUT_MS) return true;
+    return elapsed >= Cal::SETTLE_MIN_MS && stableSamples >= Cal::SETTLE_SAMPLES;
+}
+
+void FanCalibrator::addSample(uint8_t duty, uint16_t rpm) {
+    if (sampleCount < MAX_SAMPLES) {
+        samples[sampleCount++] = Sample{duty, rpm};
+    }
+}
+
+void FanCalibrator::finish() {
+    uint16_t maxRPM = 0;
+    for (uint8_t i = 0; i < sampleCount; i++) {
+        if (samples[i].rpm > maxRPM) maxRPM = samples[i].rpm;
+    }
+
+    if (maxRPM == 0) {
+        phase = Phase::FAILED;
+        return;
+    }
+    result.maxRPM = maxRPM;
+
+    // Samples were taken from high to low duty, walk them backwards to
+    // build points with increasing duty. Speed is RPM relative to full
+    // duty; points that do not increase in both axes are measurement
+    // noise and dropped to keep the curve strictly monotonic.
+    Point* points = result.points;
+    uint8_t count = 0;
+    points[count++] = Point{0, 0};
+
+    for (int i = sampleCount - 1; i >= 0; i--) {
+        const Sample& sample = samples[i];
+        uint8_t speed = (static_cast<uint32_t>(sample.rpm) * 100 + maxRPM / 2) / maxRPM;
+        if (sample.pwm == FULL_PWM || speed >= 100) continue;  // Closing point added below
+
+        const Point& last = points[count - 1];
+        if (speed <= last.speed || sample.pwm <= last.pwm) continue;
+
+        if (count < MAX_POINTS - 1) {
+            points[count++] = Point{speed, sample.pwm};
+        }
+    }
+
+    points[count++] = Point{100, FULL_PWM};
+    result.count = count;
+    phase = Phase::DONE;
+}
+
+/*******************************************************************************
+ * Reporting
+ ******************************************************************************/
+
+uint8_t FanCalibrator::getProgress() const {
+    switch (phase) {
+        case Phase::SPIN_DOWN:  return 0;
+        case Phase::FIND_START: return 10;
+        case Phase::SWEEP:      return 20 + (FULL_PWM - pwm) * 60 / FULL_PWM;
+        case Phase::FIND_STALL: return 85;
+        case Phase::DONE:       return 100;
+        default:                return 0;
+    }
+}
+
+const char* FanCalibrator::phaseToString(Phase phase) {
+    switch (phase) {
+        case Phase::IDLE:       return "idle";
+        case Phase::SPIN_DOWN:  return "spin_down";
+        case Phase::FIND_START: return "find_start";
+        case Phase::SWEEP:      return "sweep";
+        case Phase::FIND_STALL: return "find_stall";
+        case Phase::DONE:       return "done";
+        case Phase::FAILED:     return "failed";
+        default:                return "unknown";
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include "config.h"
+
+/**
+ * @brief Non-blocking fan calibration sweep
+ *
+ * Measures the characteristics of the connected fan and derives the
+ * speed <-> PWM curve from them:
+ * - Minimum start PWM, found by raising the duty from standstill
+ * - RPM at a coarse set of duties, swept down from full speed
+ * - Stall PWM, found in fine steps below the last running sweep point
+ *
+ * Each step waits for the RPM to settle: a step is complete once a few
+ * consecutive samples agree within a tolerance, or after a timeout. The
+ * calibrator holds no hardware; update() is fed the measured RPM and
+ * returns the duty to apply, so it runs from the fan task without
+ * blocking it.
+ */
+class FanCalibrator {
+public:
+    using Point = Config::Fan::Curve::Point;
+
+    static constexpr uint8_t MAX_POINTS = Config::Fan::Calibration::MAX_POINTS;
+
+    enum class Phase : uint8_t {
+        IDLE,          ///< Not calibrating
+        SPIN_DOWN,     ///< Waiting for the fan to stop
+        FIND_START,    ///< Raising duty until the fan starts
+        SWEEP,         ///< Measuring RPM from full duty downward
+        FIND_STALL,    ///< Lowering duty in fine steps until the fan stops
+        DONE,          ///< Result available
+        FAILED         ///< Aborted or no usable measurement
+    };
+
+    /**
+     * @brief Calibration outcome
+     */
+    struct Result {
+        Point points[MAX_POINTS];   ///< Curve points, 0% first and 100% last
+        uint8_t count;              ///< Number of valid points
+        uint8_t minStartPWM;        ///< Lowest duty starting the fan from standstill
+        uint8_t stallPWM;           ///< Lowest duty keeping the fan turning
+        uint16_t maxRPM;            ///< RPM at full duty
+    };
+
+    FanCalibrator();
+
+    /**
+     * @brief Begin a new calibration run
+     */
+    void start(uint32_t nowMs);
+
+    /**
+     * @brief Stop a run in progress, leaving the phase at FAILED
+     */
+    void abort();
+
+    /**
+     * @brief Advance the state machine with a new RPM measurement
+     * @param nowMs Current time in milliseconds
+     * @param rpm Latest measured RPM
+     * @return Raw PWM duty to apply
+     */
+    uint8_t update(uint32_t nowMs, uint16_t rpm);
+
+    bool isActive() const;
+    Phase getPhase() const { return phase; }
+    uint8_t getProgress() const;
+    const Result& getResult() const { return result; }
+
+    static const char* phaseToString(Phase phase);
+
+private:
+    struct Sample {
+        uint8_t pwm;
+        uint16_t rpm;
+    };
+    static constexpr uint8_t MAX_SAMPLES = MAX_POINTS;
+
+    Phase phase;
+    uint8_t pwm;
+    uint32_t stepStartMs;
+    uint16_t lastRPM;
+    uint8_t stableSamples;
+    bool kicking;
+    uint8_t lastRunningPWM;
+
+    Sample samples[MAX_SAMPLES];
+    uint8_t sampleCount;
+    Result result;
+
+    void enterStep(uint8_t duty, uint32_t nowMs);
+    bool isSettled(uint32_t nowMs, uint16_t rpm);
+    void addSample(uint8_t duty, uint16_t rpm);
+    void finish();
+};
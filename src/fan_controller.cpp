@@ -5,9 +5,36 @@
 
 #include "fan_controller.h"
 #include "temp_sensor.h"
+#include <cmath>
+
+namespace {
+    /**
+     * @brief Next duty of one ramp step towards the target
+     */
+    uint8_t nextRampPWM(uint8_t applied, uint8_t target, uint8_t minPWM, bool immediate) {
+        int delta = target - applied;
+        int next;
+        if (immediate || abs(delta) <= Config::Fan::Control::RAMP_STEP) {
+            next = target;
+        } else {
+            next = applied + (delta > 0 ? Config::Fan::Control::RAMP_STEP
+                                        : -Config::Fan::Control::RAMP_STEP);
+        }
 
-// Static member initialization
-volatile uint32_t FanController::pulseCount = 0;
+        // The fan does not turn below the minimum duty, cross that band in one step
+        if (next < minPWM) {
+            next = delta > 0 ? min<int>(minPWM, target) : target;
+        }
+        return static_cast<uint8_t>(next);
+    }
+
+    bool anyRamping(const FanController::Snapshot& state) {
+        for (uint8_t channel = 0; channel < FanController::CHANNEL_COUNT; channel++) {
+            if (state.appliedPWM[channel] != state.targetPWM[channel]) return true;
+        }
+        return false;
+    }
+}
 
 /*******************************************************************************
  * Construction / Destruction
@@ -23,6 +50,7 @@ FanController::FanController(TaskManager& tm, ConfigPreference& config)
     , config{
         .minTriggerTemp = Config::Fan::Control::MIN_TRIGGER_TEMP,
         .maxTriggerTemp = Config::Fan::Control::MAX_TRIGGER_TEMP,
+        .targetTemp = Config::Fan::Control::DEFAULT_TARGET,
         .minSpeed = Config::Fan::Speed::MIN_PERCENT,
         .maxSpeed = Config::Fan::Speed::MAX_PERCENT,
         .minPWM = Config::Fan::Speed::MIN_PWM,
@@ -30,26 +58,62 @@ FanController::FanController(TaskManager& tm, ConfigPreference& config)
         .nightMaxSpeed = Config::Fan::NightMode::MAX_SPEED_PERCENT,
         .minRPM = Config::Fan::RPM::MINIMUM,
         .nightStartHour = Config::Fan::NightMode::START_HOUR,
+        .nightStartMinute = Config::Fan::NightMode::START_MINUTE,
         .nightEndHour = Config::Fan::NightMode::END_HOUR,
+        .nightEndMinute = Config::Fan::NightMode::END_MINUTE,
         .testMode = false     // Enable test mode for Wokwi
     }
+    , pid({Config::Fan::Control::PID::KP,
+           Config::Fan::Control::PID::KI,
+           Config::Fan::Control::PID::KD},
+          Config::Fan::Control::DEFAULT_TARGET,
+          Config::Fan::Speed::MIN_PERCENT,
+          Config::Fan::Speed::MAX_PERCENT,
+          Config::Fan::Control::PID::SAMPLE_PERIOD_MS / 1000.0f)
+    , feedForward(0.0f)
+    , calibrationChannel(0)
+    , activeCalibration{}
+    , calibrated{}
     , mode(Mode::AUTO)
-    , status(Status::OK)
-    , currentSpeed(0)
-    , measuredRPM(0)
-    , stallCount(0)
+    , channels{}
     , nightModeEnabled(false)
-    , initialized(false) {
-    
+    , nightModeActive(false)
+    , nightSchedule{}
+    , initialized(false)
+    , loadingSettings(false)
+    , rampTimer(nullptr)
+    , ramp{}
+    , appliedPWM{}
+    , temperatureEventUs(0)
+    , controlEventUs(0)
+    , lastControlEventUs(0)
+    , revolutionEventUs(0)
+    , hardwareTach{} {
+
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        curves[channel] = FanCurve::defaultCurve();
+        channels.status[channel] = Status::OK;
+        channels.minPWM[channel] = this->config.minPWM;
+        channels.backoffMs[channel] = Config::Fan::Stall::BACKOFF_INITIAL_MS;
+    }
+
+    portMUX_INITIALIZE(&rampLock);
     mutex = xSemaphoreCreateMutex();
     events = xEventGroupCreate();
-    
+
     if (!mutex || !events) {
         DEBUG_LOG_FAN("FanController - Resource creation failed!");
     }
 }
 
 FanController::~FanController() {
+    if (rampTimer) {
+        esp_timer_stop(rampTimer);
+        esp_timer_delete(rampTimer);
+    }
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        delete hardwareTach[channel];
+    }
     if (mutex) vSemaphoreDelete(mutex);
     if (events) vEventGroupDelete(events);
 }
@@ -68,26 +132,44 @@ esp_err_t FanController::begin() {
         return ESP_FAIL;
     }
 
-    // Start with minimum speed
-    target.requestedSpeed = config.minSpeed;
-    target.effectiveSpeed = config.minSpeed;
-    currentSpeed = config.minSpeed;
-    ledcWrite(Config::Fan::PWM::CHANNEL, SpeedToRawPWM(currentSpeed));
+    // Start every fan at minimum speed
+    uint32_t now = millis();
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        channels.requestedSpeed[channel] = config.minSpeed;
+        channels.effectiveSpeed[channel] = config.minSpeed;
+        channels.currentSpeed[channel] = config.minSpeed;
+        channels.outputPWM[channel] = SpeedToRawPWM(channel, config.minSpeed);
+        channels.lastSpeedChangeMs[channel] = now;
+        ramp.targetPWM[channel] = channels.outputPWM[channel];
+        appliedPWM[channel] = channels.outputPWM[channel];
+        ledcWrite(Config::Fan::Channels::PINS[channel].ledcChannel, appliedPWM[channel]);
+    }
+    snapshot.modify([this](Snapshot& state) {
+        memcpy(state.appliedPWM, appliedPWM, sizeof(state.appliedPWM));
+    });
+    publishSnapshot();
 
-    TaskManager::TaskConfig taskConfig("Fan", 
+    // From here on only the ramp timer writes the duty
+    if (!setupRamp()) {
+        return ESP_FAIL;
+    }
+
+    TaskManager::TaskConfig taskConfig("Fan",
                                        Config::Fan::Task::STACK_SIZE,
-                                       Config::Fan::Task::TASK_PRIORITY, 
-                                       Config::Fan::Task::TASK_CORE);
-    esp_err_t err = taskManager.createTask(taskConfig, fanTask, this);
-    
+                                       Config::Fan::Task::TASK_PRIORITY,
+                                       Config::Fan::Task::TASK_CORE,
+                                       Config::Fan::Task::PERIOD_MS,
+                                       Config::Fan::Task::DEADLINE_MS,
+                                       Config::Fan::Task::POLICY,
+                                       Config::Fan::Task::WATCHDOG,
+                                       Config::Fan::Task::MEMORY);
+    esp_err_t err = taskManager.createTask(taskConfig, fanTask, this, &taskId);
+
     if (err != ESP_OK) return err;
 
     initialized = true;
-    
-    if (events) {
-        xEventGroupSetBits(events, TEMP_UPDATED);
-    }
-    
+    signalEvents(TEMP_UPDATED);
+
     return ESP_OK;
 }
 
@@ -95,20 +177,37 @@ esp_err_t FanController::begin() {
  * Speed Control Methods
  ******************************************************************************/
 
-void FanController::updateTargetSpeed(uint8_t requestedSpeed) {
-    target.requestedSpeed = requestedSpeed;
-    
-    if (nightModeEnabled && isNightTime()) {
-        // Use raw PWM values for comparison to avoid conversion rounding
-        target.effectiveSpeed = min(requestedSpeed, config.nightMaxSpeed);
-    } else {
-        target.effectiveSpeed = target.requestedSpeed;
-    }
-    
-    if (status == Status::OK && currentSpeed != target.effectiveSpeed) {
-        currentSpeed = target.effectiveSpeed;
-        ledcWrite(Config::Fan::PWM::CHANNEL, SpeedToRawPWM(currentSpeed));
+void FanController::updateTargetSpeeds() {
+    nightModeActive = nightModeEnabled && isNightTime();
+
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        updateTargetSpeed(channel);
     }
+
+    publishSnapshot();
+}
+
+void FanController::updateTargetSpeed(uint8_t channel) {
+    uint8_t requestedSpeed = channels.requestedSpeed[channel];
+    uint8_t effectiveSpeed = nightModeActive
+        ? min(requestedSpeed, config.nightMaxSpeed)
+        : requestedSpeed;
+    channels.effectiveSpeed[channel] = effectiveSpeed;
+
+    uint8_t currentSpeed = channels.currentSpeed[channel];
+    if (channels.status[channel] != Status::OK || currentSpeed == effectiveSpeed) return;
+
+    // In auto mode hold a speed for MIN_RUNTIME_MS before slowing down so
+    // the fan does not hunt on small swings. Night limits apply at once.
+    bool holdSpeed = mode == Mode::AUTO &&
+                     effectiveSpeed < currentSpeed &&
+                     !(nightModeActive && currentSpeed > config.nightMaxSpeed) &&
+                     (millis() - channels.lastSpeedChangeMs[channel]) < Config::Fan::Control::MIN_RUNTIME_MS;
+    if (holdSpeed) return;
+
+    channels.currentSpeed[channel] = effectiveSpeed;
+    channels.lastSpeedChangeMs[channel] = millis();
+    applyPWM(channel, SpeedToRawPWM(channel, effectiveSpeed), false);
 }
 
 bool FanController::setSpeedDutyCycle(uint8_t percentSpeed) {
@@ -117,7 +216,10 @@ bool FanController::setSpeedDutyCycle(uint8_t percentSpeed) {
     MutexGuard guard(mutex);
     if (!guard.isLocked()) return false;
 
-    updateTargetSpeed(percentSpeed);
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        channels.requestedSpeed[channel] = percentSpeed;
+    }
+    updateTargetSpeeds();
 
     // Save settings
     saveSettings(configPreference);
@@ -125,15 +227,48 @@ bool FanController::setSpeedDutyCycle(uint8_t percentSpeed) {
     return true;
 }
 
-void FanController::setTemperatureInternal(float temperature) {
-    int speed = calculateSpeedForTemperature(temperature);
-    DEBUG_LOG_FAN("Temperature %.2f -> speed %d", temperature, speed);
-    updateTargetSpeed(speed);
+bool FanController::setSpeedDutyCycle(uint8_t channel, uint8_t percentSpeed) {
+    if (!initialized || mode != Mode::MANUAL || !isValidChannel(channel)) return false;
+
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return false;
+
+    channels.requestedSpeed[channel] = percentSpeed;
+    updateTargetSpeeds();
+
+    // Save settings
+    saveSettings(configPreference);
+
+    return true;
+}
+
+void FanController::setTemperatureInternal(float temperature, float trend) {
+    int speed = computeAutoSpeed(temperature, trend);
+    DEBUG_LOG_FAN("Temperature %.2f (%+.2f/min) -> speed %d", temperature, trend, speed);
+
+    // One loop output drives every fan, each through its own curve
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        channels.requestedSpeed[channel] = speed;
+    }
+    updateTargetSpeeds();
+}
+
+void FanController::resetPid() {
+    // Bumpless transfer: continue from the highest speed currently applied
+    uint8_t speed = 0;
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        if (channels.currentSpeed[channel] > speed) speed = channels.currentSpeed[channel];
+    }
+
+    float temp = (tempSensor && tempSensor->isLastReadSuccess())
+        ? tempSensor->getSmoothedTemp()
+        : config.targetTemp;
+    pid.reset(temp, speed);
 }
 
 bool FanController::setTemperature(float temperature) {
     if (!initialized || mode != Mode::AUTO) {
-        DEBUG_LOG_FAN("setTemperature rejected - initialized: %d, mode: %d", 
+        DEBUG_LOG_FAN("setTemperature rejected - initialized: %d, mode: %d",
                  initialized, (int)mode);
         return false;
     }
@@ -151,27 +286,26 @@ bool FanController::setTemperature(float temperature) {
 bool FanController::setControlMode(Mode newMode) {
     MutexGuard guard(mutex);
     if (!guard.isLocked()) return false;
-    
+
     // Reject invalid mode transitions
     if (newMode == Mode::ERROR) return false;
-    
+
     // Update mode and trigger event
     mode = newMode;
-    
-    // Re-evaluate speed when changing modes since
-    // AUTO and MANUAL modes have different speed determination logic
-    if (mode == Mode::AUTO && tempSensor && tempSensor->isLastReadSuccess()) {
-        setTemperatureInternal(tempSensor->getSmoothedTemp());
-    }
-    
-    if (events) {
-        xEventGroupSetBits(events, CONTROL_MODE_CHANGED);
+
+    // Hand over to the PID loop from the current speed, the next
+    // sensor reading then runs the first control step
+    if (mode == Mode::AUTO) {
+        resetPid();
     }
+    publishSnapshot();
+
+    signalEvents(CONTROL_MODE_CHANGED);
 
     // Save settings
     saveSettings(configPreference);
-    
-    DEBUG_LOG_FAN("Control mode changed to: %s", 
+
+    DEBUG_LOG_FAN("Control mode changed to: %s",
               mode == Mode::AUTO ? "Auto" : "Manual");
     return true;
 }
@@ -186,13 +320,11 @@ bool FanController::setNightMode(bool enabled) {
 
     DEBUG_LOG_FAN("Night mode %s", enabled ? "enabled" : "disabled");
     nightModeEnabled = enabled;
-    
+
     // Re-evaluate speed with new night mode state
-    updateTargetSpeed(target.requestedSpeed);
-    
-    if (events) {
-        xEventGroupSetBits(events, NIGHT_MODE_CHANGED);
-    }
+    updateTargetSpeeds();
+
+    signalEvents(NIGHT_MODE_CHANGED);
 
     // Save settings
     saveSettings(configPreference);
@@ -200,43 +332,65 @@ bool FanController::setNightMode(bool enabled) {
     return true;
 }
 
-bool FanController::validateNightSettings(uint8_t startHour, uint8_t endHour, uint8_t maxPercent) const {
-    // Validate hours
+bool FanController::validateNightSettings(uint8_t startHour, uint8_t startMinute,
+                                          uint8_t endHour, uint8_t endMinute,
+                                          uint8_t maxPercent) const {
+    // Validate times of day
     if (startHour > 23 || endHour > 23) return false;
-    
+    if (startMinute > 59 || endMinute > 59) return false;
+
     // Validate percentage range
     if (maxPercent < 0 || maxPercent > 100) return false;
-    
+
     return true;
 }
 
 bool FanController::setNightSettings(uint8_t startHour, uint8_t endHour, uint8_t maxPercent) {
+    // Whole hours, as before minute resolution
+    return setNightSettings(startHour, 0, endHour, 0, maxPercent);
+}
+
+bool FanController::setNightSettings(uint8_t startHour, uint8_t startMinute,
+                                     uint8_t endHour, uint8_t endMinute, uint8_t maxPercent) {
     MutexGuard guard(mutex);
     if (!guard.isLocked()) return false;
 
     // Validate input parameters
-    if (!validateNightSettings(startHour, endHour, maxPercent)) return false;
+    if (!validateNightSettings(startHour, startMinute, endHour, endMinute, maxPercent)) return false;
+
+    // A cap below the minimum speed would stop the fans and leave the PID
+    // without a valid output range, so it holds them at the minimum instead
+    if (maxPercent < config.minSpeed) {
+        DEBUG_LOG_FAN("Night max speed %d%% is below the minimum speed, using %d%%",
+                      maxPercent, config.minSpeed);
+        maxPercent = config.minSpeed;
+    }
 
-    // Store previous settings to detect changes
-    uint8_t prevStart = config.nightStartHour;
-    uint8_t prevEnd = config.nightEndHour;
-    uint8_t prevMaxSpeed = config.nightMaxSpeed;
+    // Detect changes
+    bool changed = config.nightStartHour != startHour ||
+                   config.nightStartMinute != startMinute ||
+                   config.nightEndHour != endHour ||
+                   config.nightEndMinute != endMinute ||
+                   config.nightMaxSpeed != maxPercent;
 
     // Update configuration
     config.nightStartHour = startHour;
+    config.nightStartMinute = startMinute;
     config.nightEndHour = endHour;
+    config.nightEndMinute = endMinute;
     config.nightMaxSpeed = maxPercent;
-    
-    DEBUG_LOG_FAN("Night settings updated - Start: %d, End: %d, MaxSpeed: %d%%", 
-            startHour, endHour, maxPercent);
+
+    DEBUG_LOG_FAN("Night settings updated - Start: %02d:%02d, End: %02d:%02d, MaxSpeed: %d%%",
+            startHour, startMinute, endHour, endMinute, maxPercent);
 
     // Only trigger update if settings actually changed
-    if (prevStart != config.nightStartHour || 
-        prevEnd != config.nightEndHour || 
-        prevMaxSpeed != config.nightMaxSpeed) {
-        
+    if (changed) {
+        nightSchedule.valid = false;
+
         // Always recalculate from original requested speed
-        updateTargetSpeed(target.requestedSpeed);
+        updateTargetSpeeds();
+    } else {
+        publishSnapshot();
     }
 
     // Save settings
@@ -245,80 +399,92 @@ bool FanController::setNightSettings(uint8_t startHour, uint8_t endHour, uint8_t
     return true;
 }
 
-bool FanController::isNightTime() const {
-    // First check if we have valid NTP time
-    if (ntpManager && ntpManager->isTimeSynchronized()) {
-        int currentHour = ntpManager->getCurrentHour();
-        if (currentHour < 0) {
-            return isNightTimeRTC();
-        }
+bool FanController::isNightTime() {
+    // One clock read and comparison unless the schedule needs a refresh
+    time_t now = time(nullptr);
+    uint32_t syncCount = ntpManager ? ntpManager->getSyncCount() : 0;
 
-        if (config.nightStartHour < config.nightEndHour) {
-            return currentHour >= config.nightStartHour && 
-                   currentHour < config.nightEndHour;
-        } else {
-            return currentHour >= config.nightStartHour || 
-                   currentHour < config.nightEndHour;
-}
+    if (!nightSchedule.valid ||
+        now >= nightSchedule.nextTransition ||
+        now < nightSchedule.computedAt ||
+        syncCount != nightSchedule.syncCount) {
+        computeNightSchedule(now, syncCount);
     }
-    
-    // Fallback to RTC if NTP is not available
-    return isNightTimeRTC();
+    return nightSchedule.active;
 }
 
-bool FanController::isNightTimeRTC() const {
-    time_t now;
-    time(&now);
-    struct tm *timeinfo = localtime(&now);
-    int currentHour = timeinfo->tm_hour;
-    
-    bool isNight;
-    if (config.nightStartHour < config.nightEndHour) {
+void FanController::computeNightSchedule(time_t now, uint32_t syncCount) {
+    // Before the first NTP sync this runs on the unset RTC, as before
+    struct tm local;
+    localtime_r(&now, &local);
+
+    int minuteOfDay = local.tm_hour * 60 + local.tm_min;
+    int start = config.nightStartHour * 60 + config.nightStartMinute;
+    int end = config.nightEndHour * 60 + config.nightEndMinute;
+
+    bool active;
+    if (start < end) {
         // Simple case: night period within same day
-        isNight = currentHour >= config.nightStartHour && 
-                  currentHour < config.nightEndHour;
+        active = minuteOfDay >= start && minuteOfDay < end;
     } else {
-        // Complex case: night period crosses midnight
-        isNight = currentHour >= config.nightStartHour || 
-                  currentHour < config.nightEndHour;
+        // Night period crosses midnight, equal times mean always night
+        active = minuteOfDay >= start || minuteOfDay < end;
+    }
+
+    // Next boundary today, or tomorrow if it already passed. mktime
+    // normalizes the date and resolves DST for the boundary itself.
+    int boundary = active ? end : start;
+    struct tm next = local;
+    next.tm_hour = boundary / 60;
+    next.tm_min = boundary % 60;
+    next.tm_sec = 0;
+    next.tm_isdst = -1;
+    if (boundary <= minuteOfDay) {
+        next.tm_mday++;
     }
-    
-    DEBUG_LOG_FAN("Time check - Hour: %d, Start: %d, End: %d, Is night: %d", 
-              currentHour, config.nightStartHour, config.nightEndHour, isNight);
-    
-    return isNight;
+
+    time_t transition = mktime(&next);
+    if (transition <= now) {
+        // Boundary inside a DST gap, look again in a minute
+        transition = now + 60;
+    }
+
+    nightSchedule.valid = true;
+    nightSchedule.active = active;
+    nightSchedule.nextTransition = transition;
+    nightSchedule.computedAt = now;
+    nightSchedule.syncCount = syncCount;
+
+    DEBUG_LOG_FAN("Night schedule - Now: %02d:%02d, Night: %d, Next change in %ld s",
+                  local.tm_hour, local.tm_min, active, (long)(transition - now));
 }
 
 bool FanController::isNightModeEnabled() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return false;
-    
-    return nightModeEnabled;
+    return getSnapshot().nightModeEnabled;
 }
 
 bool FanController::isNightModeActive() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return false;
-    
-    return nightModeEnabled && isNightTime();
+    return getSnapshot().nightModeActive;
 }
 
 uint8_t FanController::getNightStartHour() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return 0;
-    return config.nightStartHour;
+    return getSnapshot().nightStartHour;
+}
+
+uint8_t FanController::getNightStartMinute() const {
+    return getSnapshot().nightStartMinute;
 }
 
 uint8_t FanController::getNightEndHour() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return 0;
-    return config.nightEndHour;
+    return getSnapshot().nightEndHour;
+}
+
+uint8_t FanController::getNightEndMinute() const {
+    return getSnapshot().nightEndMinute;
 }
 
 uint8_t FanController::getNightMaxSpeed() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return 0;
-    return config.nightMaxSpeed; 
+    return getSnapshot().nightMaxSpeed;
 }
 
 /*******************************************************************************
@@ -331,74 +497,113 @@ void FanController::processUpdate() {
     MutexGuard guard(mutex);
     if (!guard.isLocked()) return;
 
-    updateRPM();
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        updateRPM(channel);
 
-    // Handle stall detection
-    if (currentSpeed > config.minSpeed && measuredRPM < config.minRPM) {
-        stallCount++;
-        if (stallCount >= Config::Fan::Control::STALL_RETRY_COUNT) {
-            status = Status::SHUTOFF;
-            currentSpeed = 0;
-            ledcWrite(Config::Fan::PWM::CHANNEL, 0);
-            return;
+        // The calibration sweep owns this fan until it finishes
+        if (channels.status[channel] == Status::CALIBRATING) {
+            processCalibration(channel);
+            continue;
         }
-    } else {
-        stallCount = 0;
-        status = Status::OK;
+
+        superviseChannel(channel, millis());
     }
 
-    // Re-evaluate target speed based on current conditions
-    updateTargetSpeed(target.requestedSpeed);
+    // Re-evaluate target speeds based on current conditions
+    updateTargetSpeeds();
 }
 
-void FanController::processEvents() {
-    if (!initialized || !events || !tempSensor) return;
-
-    EventBits_t bits = xEventGroupWaitBits(
-        events,
-        TEMP_UPDATED | NIGHT_MODE_CHANGED | CONTROL_MODE_CHANGED,
-        pdTRUE,  // Clear bits after reading
-        pdFALSE, // Don't wait for all bits
-        0        // Don't block
-    );
-
-    if (bits == 0) return;
+void FanController::processEvents(EventBits_t bits) {
+    if (!initialized || !tempSensor) return;
 
     MutexGuard guard(mutex);
     if (!guard.isLocked()) return;
 
     DEBUG_LOG_FAN("Processing fan events: 0x%lx", (unsigned long)bits);
 
-    // Handle temperature updates in auto mode
-    if (mode == Mode::AUTO && tempSensor->isLastReadSuccess()) {
+    // Run one PID step per new sensor reading in auto mode. Mode and night
+    // mode changes were applied by their setters, the bits only wake us.
+    if ((bits & TEMP_UPDATED) && mode == Mode::AUTO && tempSensor->isLastReadSuccess()) {
+        portENTER_CRITICAL(&rampLock);
+        controlEventUs = temperatureEventUs;
+        portEXIT_CRITICAL(&rampLock);
+
+        // Adaptive sensor resolution varies the sample rate, so the PID
+        // integrates over the measured gap between readings. Long gaps,
+        // e.g. after manual mode, fall back to the nominal period.
+        int64_t periodUs = controlEventUs - lastControlEventUs;
+        if (!lastControlEventUs ||
+            periodUs > static_cast<int64_t>(Config::Fan::Control::PID::MAX_SAMPLE_PERIOD_MS) * 1000) {
+            periodUs = static_cast<int64_t>(Config::Fan::Control::PID::SAMPLE_PERIOD_MS) * 1000;
+        }
+        pid.setSamplePeriod(periodUs / 1e6f);
+        lastControlEventUs = controlEventUs;
+
         float temp = tempSensor->getSmoothedTemp();
+        float trend = tempSensor->getTrend();
         DEBUG_LOG_FAN("Updating temperature to %.2f°C", temp);
-        setTemperatureInternal(temp);
+        setTemperatureInternal(temp, trend);
+        controlEventUs = 0;
     }
 }
 
+void FanController::notifyTemperatureUpdated() {
+    if (!events) return;
+
+    portENTER_CRITICAL(&rampLock);
+    temperatureEventUs = esp_timer_get_time();
+    portEXIT_CRITICAL(&rampLock);
+
+    signalEvents(TEMP_UPDATED);
+}
+
+void FanController::signalEvents(EventBits_t bits) {
+    if (!events) return;
+
+    xEventGroupSetBits(events, bits);
+}
+
 void FanController::fanTask(void* parameters) {
     FanController* fan = static_cast<FanController*>(parameters);
-    TickType_t lastRPMUpdate = xTaskGetTickCount();
-    TickType_t lastEventCheck = xTaskGetTickCount();
-    
+    const TickType_t updateInterval = pdMS_TO_TICKS(Config::Fan::RPM::UPDATE_INTERVAL);
+    TickType_t nextUpdate = xTaskGetTickCount() + updateInterval;
+
     while (true) {
-        fan->taskManager.updateTaskRunTime("Fan");
+        // Sleep until an event arrives or the next RPM update is due
         TickType_t now = xTaskGetTickCount();
-        
-        // Process events more frequently than RPM updates
-        if ((now - lastEventCheck) >= pdMS_TO_TICKS(Config::Fan::Control::EVENT_CHECK_INTERVAL)) {
-            fan->processEvents();
-            lastEventCheck = now;
+        TickType_t timeout = static_cast<int32_t>(nextUpdate - now) > 0 ? nextUpdate - now : 0;
+
+        EventBits_t bits = xEventGroupWaitBits(
+            fan->events,
+            ALL_EVENTS,
+            pdTRUE,  // Clear bits after reading
+            pdFALSE, // Don't wait for all bits
+            timeout
+        ) & ALL_EVENTS;
+
+        // On wake, so the period histogram sees the event response
+        fan->taskManager.heartbeat(fan->taskId);
+
+        if (bits & REVOLUTION) {
+            fan->processRevolutions();
+        }
+        if (bits & ~REVOLUTION) {
+            fan->processEvents(bits);
         }
-        
+
         // Update RPM and process fan control
-        if ((now - lastRPMUpdate) >= pdMS_TO_TICKS(Config::Fan::RPM::UPDATE_INTERVAL)) {
+        now = xTaskGetTickCount();
+        if (static_cast<int32_t>(now - nextUpdate) >= 0) {
             fan->processUpdate();
-            lastRPMUpdate = now;
+            nextUpdate += updateInterval;
+
+            // Do not try to catch up on missed updates
+            if (static_cast<int32_t>(now - nextUpdate) >= 0) {
+                nextUpdate = now + updateInterval;
+            }
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(500));
+
+        fan->taskManager.workDone(fan->taskId);
     }
 }
 
@@ -407,192 +612,706 @@ void FanController::fanTask(void* parameters) {
  ******************************************************************************/
 
 bool FanController::setupPWM() {
-    ledcSetup(Config::Fan::PWM::CHANNEL, Config::Fan::PWM::FREQUENCY, Config::Fan::PWM::RESOLUTION);
-    ledcAttachPin(Config::Fan::PWM::PWM_PIN, Config::Fan::PWM::CHANNEL);
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        const Config::Fan::Channels::Pins& pins = Config::Fan::Channels::PINS[channel];
+        ledcSetup(pins.ledcChannel, Config::Fan::PWM::FREQUENCY, Config::Fan::PWM::RESOLUTION);
+        ledcAttachPin(pins.pwmPin, pins.ledcChannel);
+    }
     return true;
 }
 
 bool FanController::setupTachometer() {
-    pinMode(Config::Fan::PWM::TACH_PIN, INPUT_PULLUP);
-    attachInterrupt(digitalPinToInterrupt(Config::Fan::PWM::TACH_PIN), handleTachInterrupt, FALLING);
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        TachSource* source = &simulatedTach[channel];
+        if (!config.testMode) {
+            if (!hardwareTach[channel]) {
+                hardwareTach[channel] = createTachSource(channel);
+            }
+            source = hardwareTach[channel];
+            source->setRevolutionHandler(handleRevolution, this);
+        }
+
+        if (!tachometers[channel].begin(source)) {
+            DEBUG_LOG_FAN("Fan %d tachometer setup failed", channel);
+            return false;
+        }
+    }
     return true;
 }
 
-void IRAM_ATTR FanController::handleTachInterrupt() {
-    pulseCount++;
+TachSource* FanController::createTachSource(uint8_t channel) {
+    const Config::Fan::Channels::Pins& pins = Config::Fan::Channels::PINS[channel];
+
+    // Count in hardware while PCNT units last, interrupt per edge beyond.
+    // The tach loss measurement takes its fan's unit as the reference.
+    bool measured = Config::Temperature::Bus::MEASURE_TACH_LOSS &&
+                    channel == Config::Temperature::Bus::MEASURE_FAN_CHANNEL;
+    if (channel < Config::Fan::Tach::PCNT_UNITS && !measured) {
+        return new PcntTachSource(pins.tachPin,
+                                  static_cast<pcnt_unit_t>(channel),
+                                  Config::Fan::RPM::PULSES_PER_REV);
+    }
+    return new GpioTachSource(pins.tachPin, Config::Fan::RPM::PULSES_PER_REV);
 }
 
-void FanController::updateRPM() {
+const GpioTachSource* FanController::getTachLossSource() const {
+    if (!Config::Temperature::Bus::MEASURE_TACH_LOSS) return nullptr;
+    // createTachSource() put this channel on GPIO interrupts
+    return static_cast<const GpioTachSource*>(
+        hardwareTach[Config::Temperature::Bus::MEASURE_FAN_CHANNEL]);
+}
+
+bool FanController::setupRamp() {
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = rampTimerCallback;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "fan_ramp";
+
+    if (esp_timer_create(&timerArgs, &rampTimer) != ESP_OK) {
+        DEBUG_LOG_FAN("Ramp timer creation failed");
+        return false;
+    }
+    return true;
+}
+
+void FanController::applyPWM(uint8_t channel, uint8_t pwm, bool immediate) {
+    channels.outputPWM[channel] = pwm;
+
+    const int64_t intervalUs = Config::Fan::Control::RAMP_INTERVAL_MS * 1000LL;
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&rampLock);
+    ramp.targetPWM[channel] = pwm;
+    ramp.immediate[channel] = ramp.immediate[channel] || immediate;
+    if (controlEventUs) {
+        ramp.eventUs = controlEventUs;
+    }
+    // Step at once unless the last step was less than an interval ago
+    int64_t delayUs = immediate ? 0 : ramp.lastStepUs + intervalUs - now;
+    portEXIT_CRITICAL(&rampLock);
+
+    armRamp(delayUs > 0 ? delayUs : 0);
+}
+
+void FanController::armRamp(int64_t delayUs) {
+    if (!rampTimer) return;
+
+    // Fails harmlessly while the timer is armed, it steps towards the
+    // new target anyway. A stopped fan is not kept waiting though.
+    if (delayUs == 0) {
+        esp_timer_stop(rampTimer);
+    }
+    esp_timer_start_once(rampTimer, delayUs);
+}
+
+void FanController::rampTimerCallback(void* arg) {
+    static_cast<FanController*>(arg)->stepRamp();
+}
+
+void FanController::stepRamp() {
+    RampState pending;
+    portENTER_CRITICAL(&rampLock);
+    pending = ramp;
+    memset(ramp.immediate, 0, sizeof(ramp.immediate));
+    ramp.eventUs = 0;
+    portEXIT_CRITICAL(&rampLock);
+
+    // One timer steps every fan
+    bool changed = false;
+    bool ramping = false;
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        if (appliedPWM[channel] == pending.targetPWM[channel]) continue;
+
+        appliedPWM[channel] = nextRampPWM(appliedPWM[channel],
+                                          pending.targetPWM[channel],
+                                          channels.minPWM[channel],
+                                          pending.immediate[channel]);
+        ledcWrite(Config::Fan::Channels::PINS[channel].ledcChannel, appliedPWM[channel]);
+        changed = true;
+        ramping |= appliedPWM[channel] != pending.targetPWM[channel];
+    }
+
+    if (!changed) return;
+
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&rampLock);
+    ramp.lastStepUs = now;
+    portEXIT_CRITICAL(&rampLock);
+
+    if (ramping) {
+        esp_timer_start_once(rampTimer, Config::Fan::Control::RAMP_INTERVAL_MS * 1000ULL);
+    }
+
+    // Only the first write after a reading counts towards the response time
+    uint32_t latencyUs = pending.eventUs ? static_cast<uint32_t>(now - pending.eventUs) : 0;
+    bool measured = pending.eventUs != 0;
+
+    snapshot.modify([this, measured, latencyUs](Snapshot& state) {
+        memcpy(state.appliedPWM, appliedPWM, sizeof(state.appliedPWM));
+        state.ramping = anyRamping(state);
+        if (measured) {
+            state.latency.count++;
+            state.latency.lastUs = latencyUs;
+            state.latency.maxUs = max(state.latency.maxUs, latencyUs);
+            state.latency.totalUs += latencyUs;
+        }
+    });
+}
+
+void FanController::updateRPM(uint8_t channel) {
     if (config.testMode) {
-        // Simulate RPM in test mode
-        measuredRPM = map(currentSpeed, 
-                         config.minSpeed, config.maxSpeed, 
-                         500, 2000);  // Simulate range 500-2000 RPM
-        DEBUG_LOG_FAN("Test Mode - Simulated RPM: %d for speed: %d", 
-                 measuredRPM, currentSpeed);
-        return;
+        // Drive the simulated source so the estimator runs as on hardware
+        uint8_t appliedSpeed = getAppliedSpeed(channel);
+        simulatedTach[channel].setRPM(appliedSpeed == 0 ? 0 :
+                                      map(appliedSpeed,
+                                          config.minSpeed, config.maxSpeed,
+                                          500, 2000));  // Simulate range 500-2000 RPM
+    }
+
+    channels.measuredRPM[channel] = tachometers[channel].update(micros());
+
+    if (config.testMode) {
+        DEBUG_LOG_FAN("Test Mode - Fan %d simulated RPM: %d for speed: %d",
+                 channel, channels.measuredRPM[channel], getAppliedSpeed(channel));
+    }
+}
+
+void FanController::processRevolutions() {
+    if (!initialized) return;
+
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return;
+
+    // Readings only; stall supervision keeps the processUpdate() cadence
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        channels.measuredRPM[channel] = tachometers[channel].update(micros());
     }
+}
+
+void IRAM_ATTR FanController::handleRevolution(void* context) {
+    FanController* fan = static_cast<FanController*>(context);
+    int64_t now = esp_timer_get_time();
+
+    // One wake-up per EVENT_INTERVAL_US for all fans together: slow fans
+    // are read on every revolution, fast ones at a bounded rate
+    bool due = false;
+    portENTER_CRITICAL_ISR(&fan->rampLock);
+    if (now - fan->revolutionEventUs >= Config::Fan::RPM::EVENT_INTERVAL_US) {
+        fan->revolutionEventUs = now;
+        due = true;
+    }
+    portEXIT_CRITICAL_ISR(&fan->rampLock);
 
-    // Calculate actual RPM from pulse count
-    uint32_t pulses = pulseCount;
-    pulseCount = 0;
-    measuredRPM = (pulses * 60) / (Config::Fan::RPM::UPDATE_INTERVAL / 1000.0) / Config::Fan::RPM::PULSES_PER_REV;
+    if (!due || !fan->events) return;
+
+    BaseType_t woken = pdFALSE;
+    if (xEventGroupSetBitsFromISR(fan->events, REVOLUTION, &woken) == pdPASS) {
+        portYIELD_FROM_ISR(woken);
+    }
 }
 
 /*******************************************************************************
  * Status & Recovery Methods
  ******************************************************************************/
 
+void FanController::superviseChannel(uint8_t channel, uint32_t now) {
+    uint16_t rpm = channels.measuredRPM[channel];
+    channels.expectedRPM[channel] = expectedRPM(channel, getSnapshot().appliedPWM[channel]);
+
+    switch (channels.recovery[channel]) {
+        case Recovery::KICK:
+            if (now - channels.recoveryMs[channel] >= Config::Fan::Stall::KICK_MS) {
+                finishKick(channel, now);
+            }
+            return;
+
+        case Recovery::BACKOFF:
+            if (static_cast<int32_t>(now - channels.recoveryMs[channel]) >= 0) {
+                startKick(channel, now);
+            }
+            return;
+
+        default:
+            break;
+    }
+
+    // Check the duty actually applied, the commanded speed may still be
+    // ramping, and give the fan time to follow a new command
+    bool supervised = getAppliedSpeed(channel) > config.minSpeed &&
+                      now - channels.lastSpeedChangeMs[channel] >= Config::Fan::Stall::GRACE_MS;
+    if (!supervised) {
+        channels.stallCount[channel] = 0;
+        return;
+    }
+
+    if (rpm >= stallThresholdRPM(channel)) {
+        channels.stallCount[channel] = 0;
+
+        // A fan that ran clean for a while starts over with short retries
+        if (channels.stallRetries[channel] > 0 &&
+            now - channels.lastLowRPMMs[channel] >= Config::Fan::Stall::BACKOFF_RESET_MS) {
+            resetRecovery(channel);
+        }
+        return;
+    }
+
+    channels.lastLowRPMMs[channel] = now;
+    if (++channels.stallCount[channel] >= Config::Fan::Stall::SAMPLES) {
+        DEBUG_LOG_FAN("Fan %d stalled - RPM: %d, expected: %d", 
+                      channel, rpm, channels.expectedRPM[channel]);
+        startKick(channel, now);
+    }
+}
+
+void FanController::startKick(uint8_t channel, uint32_t now) {
+    // Full duty overcomes static friction, the ramp is bypassed
+    channels.stallCount[channel] = 0;
+    channels.status[channel] = Status::SHUTOFF;
+    channels.recovery[channel] = Recovery::KICK;
+    channels.recoveryMs[channel] = now;
+    channels.currentSpeed[channel] = config.maxSpeed;
+    applyPWM(channel, config.maxPWM, true);
+}
+
+void FanController::finishKick(uint8_t channel, uint32_t now) {
+    uint16_t rpm = channels.measuredRPM[channel];
+
+    // Same band as supervision, against the full duty of the kick; a fan
+    // that barely turns would otherwise stall again after every kick
+    if (rpm >= stallThresholdRPM(channel)) {
+        DEBUG_LOG_FAN("Fan %d recovered after kick - RPM: %d", channel, rpm);
+
+        // Back to the control loop, the ramp brings the duty down again
+        channels.status[channel] = Status::OK;
+        channels.recovery[channel] = Recovery::NONE;
+        channels.fault[channel] = Fault::NONE;
+        channels.currentSpeed[channel] = channels.effectiveSpeed[channel];
+        channels.lastSpeedChangeMs[channel] = now;
+        channels.lastLowRPMMs[channel] = now;
+        applyPWM(channel, SpeedToRawPWM(channel, channels.currentSpeed[channel]), false);
+        return;
+    }
+
+    // The tach line idles high when nothing is connected. Some rotation,
+    // or a line held low by the fan electronics, points at a blocked rotor.
+    channels.fault[channel] = (rpm == 0 && !tachometers[channel].isLineLow())
+        ? Fault::DISCONNECTED
+        : Fault::BLOCKED;
+
+    uint32_t backoff = channels.backoffMs[channel];
+    channels.recovery[channel] = Recovery::BACKOFF;
+    channels.recoveryMs[channel] = now + backoff;
+    channels.backoffMs[channel] = min(backoff * 2, Config::Fan::Stall::BACKOFF_MAX_MS);
+    if (channels.stallRetries[channel] < UINT8_MAX) {
+        channels.stallRetries[channel]++;
+    }
+    channels.currentSpeed[channel] = 0;
+    applyPWM(channel, 0, true);
+
+    DEBUG_LOG_FAN("Fan %d kick failed (%s), retry in %lu s",
+                  channel, faultToString(channels.fault[channel]), (unsigned long)(backoff / 1000));
+}
+
+void FanController::resetRecovery(uint8_t channel) {
+    channels.stallCount[channel] = 0;
+    channels.recovery[channel] = Recovery::NONE;
+    channels.fault[channel] = Fault::NONE;
+    channels.backoffMs[channel] = Config::Fan::Stall::BACKOFF_INITIAL_MS;
+    channels.stallRetries[channel] = 0;
+}
+
+bool FanController::recoverChannel(uint8_t channel) {
+    // Only a fan waiting for its next retry, a running kick goes on
+    if (channels.recovery[channel] != Recovery::BACKOFF) return false;
+
+    // Retry at once and start the backoff over
+    resetRecovery(channel);
+    startKick(channel, millis());
+    return true;
+}
+
 bool FanController::attemptRecovery() {
     MutexGuard guard(mutex);
     if (!guard.isLocked()) return false;
 
-    if (status != Status::SHUTOFF) return false;
+    bool recovered = false;
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        recovered |= recoverChannel(channel);
+    }
+    if (!recovered) return false;
 
-    // Reset stall detection and restart at minimum speed
-    stallCount = 0;
-    status = Status::OK;
-    updateTargetSpeed(config.minSpeed);
-    
+    updateTargetSpeeds();
     return true;
 }
 
-bool FanController::isStalled() const {
+bool FanController::attemptRecovery(uint8_t channel) {
+    if (!isValidChannel(channel)) return false;
+
     MutexGuard guard(mutex);
-    if (!guard.isLocked()) return true;  // Assume stalled if we can't check
-    return status == Status::SHUTOFF;
+    if (!guard.isLocked()) return false;
+
+    if (!recoverChannel(channel)) return false;
+
+    updateTargetSpeeds();
+    return true;
+}
+
+/*******************************************************************************
+ * Calibration
+ ******************************************************************************/
+
+bool FanController::startCalibration(uint8_t channel) {
+    if (!initialized || !isValidChannel(channel)) return false;
+
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return false;
+
+    if (calibrator.isActive()) return false;
+
+    calibrationChannel = channel;
+    resetRecovery(channel);
+    channels.status[channel] = Status::CALIBRATING;
+    calibrator.start(millis());
+    applyPWM(channel, 0, true);
+    publishSnapshot();
+
+    DEBUG_LOG_FAN("Calibration of fan %d started", channel);
+    return true;
+}
+
+bool FanController::abortCalibration() {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return false;
+
+    if (!calibrator.isActive()) return false;
+
+    calibrator.abort();
+    finishCalibration();
+    publishSnapshot();
+
+    DEBUG_LOG_FAN("Calibration of fan %d aborted", calibrationChannel);
+    return true;
+}
+
+bool FanController::resetCalibration(uint8_t channel) {
+    if (!isValidChannel(channel)) return false;
+
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return false;
+
+    if (channels.status[channel] == Status::CALIBRATING) return false;
+
+    curves[channel] = FanCurve::defaultCurve();
+    channels.minPWM[channel] = config.minPWM;
+    activeCalibration[channel] = FanCalibrator::Result{};
+    calibrated[channel] = false;
+    publishedCalibration[channel].write(activeCalibration[channel]);
+    configPreference.clearCurveSettings(channel);
+
+    if (initialized) {
+        applyPWM(channel, SpeedToRawPWM(channel, channels.currentSpeed[channel]), false);
+    }
+    publishSnapshot();
+
+    DEBUG_LOG_FAN("Fan %d calibration reset to default curve", channel);
+    return true;
+}
+
+FanController::CalibrationReport FanController::getCalibrationReport(uint8_t channel) const {
+    CalibrationReport report = {};
+    if (!isValidChannel(channel)) return report;
+
+    Snapshot state = getSnapshot();
+    report.runChannel = state.calibrationChannel;
+    report.phase = state.calibrationPhase;
+    report.progress = state.calibrationProgress;
+
+    // Judged from the curve itself, a snapshot taken a moment apart may
+    // not have caught up with it yet
+    report.active = publishedCalibration[channel].read();
+    report.calibrated = report.active.count > 0;
+    return report;
+}
+
+void FanController::processCalibration(uint8_t channel) {
+    uint8_t duty = calibrator.update(millis(), channels.measuredRPM[channel]);
+
+    if (calibrator.isActive()) {
+        applyPWM(channel, duty, true);
+        return;
+    }
+
+    if (calibrator.getPhase() == FanCalibrator::Phase::DONE &&
+        applyCurve(channel, calibrator.getResult())) {
+        const FanCalibrator::Result& result = calibrator.getResult();
+        DEBUG_LOG_FAN("Fan %d calibration done - Points: %d, MinPWM: %d, StallPWM: %d, MaxRPM: %d",
+                      channel, result.count, result.minStartPWM, result.stallPWM, result.maxRPM);
+        saveCurveSettings(configPreference, channel);
+    } else {
+        DEBUG_LOG_FAN("Fan %d calibration failed, keeping the previous curve", channel);
+    }
+
+    finishCalibration();
+}
+
+void FanController::finishCalibration() {
+    // Hand the output back and ramp to the speed requested meanwhile
+    uint8_t channel = calibrationChannel;
+    channels.status[channel] = Status::OK;
+    channels.stallCount[channel] = 0;
+    channels.currentSpeed[channel] = channels.effectiveSpeed[channel];
+    channels.lastSpeedChangeMs[channel] = millis();
+    applyPWM(channel, SpeedToRawPWM(channel, channels.currentSpeed[channel]), false);
+
+    if (mode == Mode::AUTO) {
+        resetPid();
+    }
+}
+
+bool FanController::applyCurve(uint8_t channel, const FanCalibrator::Result& result) {
+    if (!FanCurve::isValid(result.points, result.count)) return false;
+
+    curves[channel] = FanCurve::fromPoints(result.points, result.count);
+    channels.minPWM[channel] = result.minStartPWM;
+    activeCalibration[channel] = result;
+    calibrated[channel] = true;
+    publishedCalibration[channel].write(result);
+    return true;
+}
+
+bool FanController::setPidTuning(const PidController::Gains& gains, float targetTemp) {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return false;
+
+    // Reject negative, non-finite or absurd gains
+    const float values[] = {gains.kp, gains.ki, gains.kd};
+    for (float value : values) {
+        if (!std::isfinite(value) || value < 0.0f || value > Config::Fan::Control::PID::MAX_GAIN) {
+            return false;
+        }
+    }
+
+    // The setpoint has to lie inside the trigger band to be reachable
+    if (!std::isfinite(targetTemp) ||
+        targetTemp < config.minTriggerTemp ||
+        targetTemp > config.maxTriggerTemp) {
+        return false;
+    }
+
+    config.targetTemp = targetTemp;
+    pid.setGains(gains);
+    pid.setSetpoint(targetTemp);
+
+    publishSnapshot();
+
+    DEBUG_LOG_FAN("PID tuning updated - Kp: %.3f, Ki: %.3f, Kd: %.3f, Target: %.1f",
+                  gains.kp, gains.ki, gains.kd, targetTemp);
+
+    savePidSettings(configPreference);
+    return true;
+}
+
+PidController::Gains FanController::getPidGains() const {
+    return getSnapshot().pidGains;
+}
+
+float FanController::getTargetTemperature() const {
+    return getSnapshot().targetTemp;
+}
+
+FanController::Status FanController::aggregateStatus() const {
+    // A stalled fan outranks a calibration in progress
+    Status result = Status::OK;
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        switch (channels.status[channel]) {
+            case Status::ERROR:
+                return Status::ERROR;
+            case Status::SHUTOFF:
+                result = Status::SHUTOFF;
+                break;
+            case Status::CALIBRATING:
+                if (result == Status::OK) result = Status::CALIBRATING;
+                break;
+            default:
+                break;
+        }
+    }
+    return result;
+}
+
+uint8_t FanController::getAppliedSpeed(uint8_t channel) const {
+    return rawPWMToSpeed(channel, getSnapshot().appliedPWM[channel]);
+}
+
+uint16_t FanController::expectedRPM(uint8_t channel, uint8_t pwm) const {
+    // Curve speeds of a calibrated fan are RPM relative to full duty
+    if (!calibrated[channel] || pwm < channels.minPWM[channel]) return 0;
+    return static_cast<uint32_t>(curves[channel].pwmToSpeed(pwm)) *
+           activeCalibration[channel].maxRPM / 100;
+}
+
+uint16_t FanController::stallThresholdRPM(uint8_t channel) const {
+    // Without a calibration only the fixed minimum is known
+    uint16_t expected = channels.expectedRPM[channel];
+    if (expected == 0) return config.minRPM;
+    return static_cast<uint32_t>(expected) * (100 - Config::Fan::Stall::TOLERANCE_PERCENT) / 100;
 }
 
 /*******************************************************************************
  * Utility Methods
  ******************************************************************************/
 
-uint8_t FanController::calculateSpeedForTemperature(float temp) const {
-    temp = constrain(temp, config.minTriggerTemp, config.maxTriggerTemp);
-    float ratio = (temp - config.minTriggerTemp) / (config.maxTriggerTemp - config.minTriggerTemp);
-    return config.minSpeed + (ratio * (config.maxSpeed - config.minSpeed));
+uint8_t FanController::computeAutoSpeed(float temp, float trend) {
+    // Only a rising trend feeds forward; cooling is left to the loop
+    float rise = max(0.0f, trend);
+    float predicted = temp + rise * Config::Fan::Control::FeedForward::LOOKAHEAD_S / 60.0f;
+
+    // Outside the trigger band the loop is bypassed and the integrator is
+    // re-seeded so control resumes without a bump once back inside. A
+    // trend about to cross the lower edge enters the band early.
+    if (predicted <= config.minTriggerTemp) {
+        feedForward = 0.0f;
+        pid.reset(temp, config.minSpeed);
+        return config.minSpeed;
+    }
+    if (temp >= config.maxTriggerTemp) {
+        feedForward = 0.0f;
+        pid.reset(temp, config.maxSpeed);
+        return config.maxSpeed;
+    }
+
+    // Limit the loop to what can actually be applied so the integrator
+    // does not wind up against the night mode cap. setNightSettings()
+    // keeps the cap at or above the minimum speed, so the range is valid.
+    uint8_t maxSpeed = config.maxSpeed;
+    if (nightModeEnabled && isNightTime()) {
+        maxSpeed = min(config.maxSpeed, config.nightMaxSpeed);
+    }
+    pid.setOutputLimits(config.minSpeed, maxSpeed);
+
+    feedForward = min(rise * Config::Fan::Control::FeedForward::GAIN,
+                      Config::Fan::Control::FeedForward::MAX_SPEED);
+    return static_cast<uint8_t>(lroundf(pid.update(temp, feedForward)));
 }
 
-uint8_t FanController::SpeedToRawPWM(uint8_t percent) const {
+uint8_t FanController::SpeedToRawPWM(uint8_t channel, uint8_t percent) const {
     // No PWM below minimum speed to prevent unwanted rotation
     if (percent < config.minSpeed) return 0;
-    
-    // Calibration table based on measurements
-    const struct {
-        uint8_t speed;
-        uint8_t pwm;
-    } calibration[] = {
-        {0, 0},      // Explicit zero point
-        {5, 25},     // Minimum speed
-        {10, 37},
-        {20, 61},
-        {30, 85},
-        {40, 109},
-        {50, 134},
-        {60, 158},
-        {70, 182},
-        {80, 206},
-        {90, 230},
-        {100, 255}
-    };
-    
-    // Find the calibration points to interpolate between
-    size_t i;
-    for (i = 0; i < sizeof(calibration)/sizeof(calibration[0]) - 1; i++) {
-        if (percent <= calibration[i + 1].speed) break;
-    }
-    
-    // Linear interpolation between calibration points
-    float t = (percent - calibration[i].speed) / 
-              float(calibration[i + 1].speed - calibration[i].speed);
-    return calibration[i].pwm + t * (calibration[i + 1].pwm - calibration[i].pwm);
-}
-
-uint8_t FanController::rawPWMToSpeed(uint8_t pwm) const {
-    if (pwm < config.minPWM) return 0;
-    
-    // Calibration table (same as above but we'll interpolate PWM to speed)
-    const struct {
-        uint8_t pwm;
-        uint8_t speed;
-    } calibration[] = {
-        {0, 0},
-        {25, 5},
-        {37, 10},
-        {61, 20},
-        {85, 30},
-        {109, 40},
-        {134, 50},
-        {158, 60},
-        {182, 70},
-        {206, 80},
-        {230, 90},
-        {255, 100}
-    };
-    
-    // Find the calibration points to interpolate between
-    size_t i;
-    for (i = 0; i < sizeof(calibration)/sizeof(calibration[0]) - 1; i++) {
-        if (pwm <= calibration[i + 1].pwm) break;
-    }
-    
-    // Linear interpolation between calibration points
-    float t = (pwm - calibration[i].pwm) / 
-              float(calibration[i + 1].pwm - calibration[i].pwm);
-    return calibration[i].speed + t * (calibration[i + 1].speed - calibration[i].speed);
+    return curves[channel].speedToPwm(percent);
+}
+
+uint8_t FanController::rawPWMToSpeed(uint8_t channel, uint8_t pwm) const {
+    if (pwm < channels.minPWM[channel]) return 0;
+    return curves[channel].pwmToSpeed(pwm);
+}
+
+void FanController::publishSnapshot() {
+    // Called with the mutex held after every state change. The applied
+    // duty belongs to the ramp timer and is left untouched here.
+    Status status = aggregateStatus();
+    snapshot.modify([this, status](Snapshot& state) {
+        state.mode = mode;
+        state.status = status;
+        state.nightModeEnabled = nightModeEnabled;
+        state.nightModeActive = nightModeActive;
+        state.nightStartHour = config.nightStartHour;
+        state.nightStartMinute = config.nightStartMinute;
+        state.nightEndHour = config.nightEndHour;
+        state.nightEndMinute = config.nightEndMinute;
+        state.nightTransition = nightSchedule.valid ? nightSchedule.nextTransition : 0;
+        state.nightMaxSpeed = config.nightMaxSpeed;
+        memcpy(state.currentSpeed, channels.currentSpeed, sizeof(state.currentSpeed));
+        memcpy(state.targetSpeed, channels.effectiveSpeed, sizeof(state.targetSpeed));
+        memcpy(state.measuredRPM, channels.measuredRPM, sizeof(state.measuredRPM));
+        memcpy(state.channelStatus, channels.status, sizeof(state.channelStatus));
+        memcpy(state.targetPWM, channels.outputPWM, sizeof(state.targetPWM));
+        memcpy(state.expectedRPM, channels.expectedRPM, sizeof(state.expectedRPM));
+        memcpy(state.recovery, channels.recovery, sizeof(state.recovery));
+        memcpy(state.fault, channels.fault, sizeof(state.fault));
+        memcpy(state.stallRetries, channels.stallRetries, sizeof(state.stallRetries));
+        memcpy(state.retryAtMs, channels.recoveryMs, sizeof(state.retryAtMs));
+        state.feedForward = feedForward;
+        state.pidGains = pid.getGains();
+        state.targetTemp = config.targetTemp;
+        state.calibrationChannel = calibrationChannel;
+        state.calibrationPhase = calibrator.getPhase();
+        state.calibrationProgress = calibrator.getProgress();
+        state.ramping = anyRamping(state);
+    });
 }
 
 /*******************************************************************************
  * Protected Getters
  ******************************************************************************/
 
-uint8_t FanController::getCurrentSpeed() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return 0;
-    return currentSpeed;
+uint8_t FanController::getCurrentSpeed(uint8_t channel) const {
+    return isValidChannel(channel) ? getSnapshot().currentSpeed[channel] : 0;
 }
 
-uint8_t FanController::getTargetSpeed() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return 0;
-    return target.effectiveSpeed;
+uint8_t FanController::getTargetSpeed(uint8_t channel) const {
+    return isValidChannel(channel) ? getSnapshot().targetSpeed[channel] : 0;
 }
 
-uint16_t FanController::getMeasuredRPM() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return 0;
-    return measuredRPM;
+uint16_t FanController::getMeasuredRPM(uint8_t channel) const {
+    return isValidChannel(channel) ? getSnapshot().measuredRPM[channel] : 0;
 }
 
 FanController::Status FanController::getStatus() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return Status::ERROR;
-    return status;
+    return getSnapshot().status;
+}
+
+FanController::Status FanController::getChannelStatus(uint8_t channel) const {
+    return isValidChannel(channel) ? getSnapshot().channelStatus[channel] : Status::ERROR;
 }
 
 FanController::Mode FanController::getControlMode() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return Mode::ERROR;
-    return mode;
+    return getSnapshot().mode;
 }
 
 String FanController::getStatusString() const {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return "Mutex Error";
-    
-    String result = (mode == Mode::AUTO) ? "Auto" : "Manual";
-    result += " - Speed: " + String(currentSpeed) + "%";  // Change PWM to Speed
-    result += " - RPM: " + String(measuredRPM);
-    
-    switch (status) {
-        case Status::SHUTOFF: result += " (Shutoff)"; break;
-        case Status::ERROR:   result += " (Error)"; break;
-        default: break;
-    }
-    
+    Snapshot state = getSnapshot();
+
+    String result = (state.mode == Mode::AUTO) ? "Auto" : "Manual";
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        result += " - Fan " + String(channel) + ": " + String(state.currentSpeed[channel]) + "%";
+        result += " " + String(state.measuredRPM[channel]) + " RPM";
+
+        switch (state.channelStatus[channel]) {
+            case Status::SHUTOFF:
+                result += " (Shutoff, ";
+                result += state.recovery[channel] == Recovery::KICK 
+                    ? "kick" 
+                    : faultToString(state.fault[channel]);
+                result += ")";
+                break;
+            case Status::ERROR:   result += " (Error)"; break;
+            case Status::CALIBRATING: result += " (Calibrating)"; break;
+            default: break;
+        }
+    }
+
     return result;
 }
 
+const char* FanController::faultToString(Fault fault) {
+    switch (fault) {
+        case Fault::NONE:         return "none";
+        case Fault::BLOCKED:      return "blocked";
+        case Fault::DISCONNECTED: return "disconnected";
+        default:                  return "unknown";
+    }
+}
+
+const char* FanController::recoveryToString(Recovery recovery) {
+    switch (recovery) {
+        case Recovery::NONE:    return "none";
+        case Recovery::KICK:    return "kick";
+        case Recovery::BACKOFF: return "backoff";
+        default:                return "unknown";
+    }
+}
+
 /*******************************************************************************
  * Component Registration
  ******************************************************************************/
@@ -616,35 +1335,124 @@ void FanController::registerNTPManager(NTPManager* manager) {
  ******************************************************************************/
 
 void FanController::saveSettings(ConfigPreference& configPref) {
-    DEBUG_LOG_FAN("Saving settings - Mode: %d, Speed: %d, NightMode: %d", 
-                  static_cast<uint8_t>(mode), currentSpeed, nightModeEnabled);
-                  
+    if (loadingSettings) return;
+
+    DEBUG_LOG_FAN("Saving settings - Mode: %d, Speed: %d, NightMode: %d",
+                  static_cast<uint8_t>(mode), channels.currentSpeed[0], nightModeEnabled);
+
     ConfigPreference::FanSettings settings;
     settings.fanMode = static_cast<uint8_t>(mode);
-    settings.manualSpeed = currentSpeed;
+    memcpy(settings.manualSpeed, channels.currentSpeed, sizeof(settings.manualSpeed));
     settings.nightModeEnabled = nightModeEnabled;
     settings.nightStartHour = config.nightStartHour;
+    settings.nightStartMinute = config.nightStartMinute;
     settings.nightEndHour = config.nightEndHour;
+    settings.nightEndMinute = config.nightEndMinute;
     settings.nightMaxSpeed = config.nightMaxSpeed;
     configPref.saveFanSettings(settings);
 }
 
+void FanController::savePidSettings(ConfigPreference& configPref) {
+    if (loadingSettings) return;
+
+    const PidController::Gains& gains = pid.getGains();
+
+    ConfigPreference::PidSettings settings;
+    settings.kp = gains.kp;
+    settings.ki = gains.ki;
+    settings.kd = gains.kd;
+    settings.targetTemp = config.targetTemp;
+    configPref.savePidSettings(settings);
+}
+
+void FanController::saveCurveSettings(ConfigPreference& configPref, uint8_t channel) {
+    const FanCalibrator::Result& active = activeCalibration[channel];
+
+    ConfigPreference::CurveSettings settings;
+    memcpy(settings.points, active.points, sizeof(settings.points));
+    settings.count = active.count;
+    settings.minStartPWM = active.minStartPWM;
+    settings.stallPWM = active.stallPWM;
+    settings.maxRPM = active.maxRPM;
+    configPref.saveCurveSettings(channel, settings);
+}
+
+void FanController::loadCurveSettings(ConfigPreference& configPref) {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return;
+
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+        ConfigPreference::CurveSettings settings;
+        if (!configPref.loadCurveSettings(channel, settings)) {
+            DEBUG_LOG_FAN("No calibrated curve stored for fan %d, using default", channel);
+            continue;
+        }
+
+        FanCalibrator::Result result = {};
+        memcpy(result.points, settings.points, sizeof(result.points));
+        result.count = settings.count;
+        result.minStartPWM = settings.minStartPWM;
+        result.stallPWM = settings.stallPWM;
+        result.maxRPM = settings.maxRPM;
+
+        if (!applyCurve(channel, result)) {
+            DEBUG_LOG_FAN("Stored curve of fan %d invalid, using default", channel);
+            continue;
+        }
+
+        if (initialized) {
+            applyPWM(channel, SpeedToRawPWM(channel, channels.currentSpeed[channel]), false);
+        }
+        DEBUG_LOG_FAN("Loaded calibrated curve of fan %d with %d points", channel, result.count);
+    }
+
+    publishSnapshot();
+}
+
 void FanController::loadSettings(ConfigPreference& configPref) {
     DEBUG_LOG_FAN("Loading fan settings...");
+    loadCurveSettings(configPref);
+
+    // Applied through the setters for their checks, which would otherwise
+    // write every value straight back to NVS
+    setLoadingSettings(true);
+
+    // Gains first, the mode change below seeds the loop with them
+    ConfigPreference::PidSettings pidSettings;
+    if (configPref.loadPidSettings(pidSettings)) {
+        DEBUG_LOG_FAN("Loaded PID - Kp: %.3f, Ki: %.3f, Kd: %.3f, Target: %.1f",
+                      pidSettings.kp, pidSettings.ki, pidSettings.kd, pidSettings.targetTemp);
+        setPidTuning({pidSettings.kp, pidSettings.ki, pidSettings.kd}, pidSettings.targetTemp);
+    }
+
     ConfigPreference::FanSettings settings;
     if (configPref.loadFanSettings(settings)) {
-        DEBUG_LOG_FAN("Loaded - Mode: %d, Speed: %d, NightMode: %d", 
-                     settings.fanMode, settings.manualSpeed, settings.nightModeEnabled);
-                     
-        mode = static_cast<Mode>(settings.fanMode);
-        if (mode == Mode::MANUAL) {
-            setSpeedDutyCycle(settings.manualSpeed);
-        }
+        DEBUG_LOG_FAN("Loaded - Mode: %d, Speed: %d, NightMode: %d",
+                     settings.fanMode, settings.manualSpeed[0], settings.nightModeEnabled);
+
         setNightMode(settings.nightModeEnabled);
-        setNightSettings(settings.nightStartHour, 
-                        settings.nightEndHour, 
+        setNightSettings(settings.nightStartHour,
+                        settings.nightStartMinute,
+                        settings.nightEndHour,
+                        settings.nightEndMinute,
                         settings.nightMaxSpeed);
+
+        // Resets the PID in AUTO, so its first update is bumpless
+        setControlMode(static_cast<Mode>(settings.fanMode));
+        if (settings.fanMode == static_cast<uint8_t>(Mode::MANUAL)) {
+            for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+                setSpeedDutyCycle(channel, settings.manualSpeed[channel]);
+            }
+        }
     } else {
         DEBUG_LOG_FAN("Failed to load settings or using defaults");
     }
-}
\ No newline at end of file
+
+    setLoadingSettings(false);
+}
+
+void FanController::setLoadingSettings(bool loading) {
+    // Under the mutex the setters save under
+    MutexGuard guard(mutex);
+    loadingSettings = loading;
+}
@@ -3,28 +3,50 @@
 #include <Arduino.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "esp_timer.h"
 #include "config.h"
 #include "task_manager.h"
 #include "mutex_guard.h"
 #include "ntp_manager.h"
 #include "debug_log.h"
 #include "config_preference.h"
+#include "pid_controller.h"
+#include "fan_curve.h"
+#include "fan_calibrator.h"
+#include "tachometer.h"
+#include "pcnt_tach_source.h"
+#include "gpio_tach_source.h"
+#include "seqlock.h"
 
 // Forward declarations
 class TempSensor;
 
 /**
- * @brief Controls a PWM-driven fan with RPM monitoring and various operating modes
+ * @brief Controls PWM-driven fans with RPM monitoring and various operating modes
  * 
  * Features:
- * - PWM-based speed control with automatic temperature-based and manual modes
- * - RPM monitoring via tachometer input
- * - Night mode with configurable quiet hours and speed limits
- * - Stall detection and recovery
- * - Event-driven updates for temperature and mode changes
+ * - Config::Fan::Channels::COUNT fans driven by a single control task
+ * - PWM-based speed control with closed-loop PID temperature control and manual modes
+ * - Period-based RPM monitoring on the PCNT peripheral, GPIO interrupts beyond four fans;
+ *   readings refresh on the revolution events, at most every EVENT_INTERVAL_US
+ * - Slew-rate limited PWM ramping driven by an esp_timer
+ * - Night mode with minute-resolution quiet hours and speed limits, evaluated
+ *   against a transition time precomputed after each clock sync
+ * - Per-fan stall detection against the calibrated RPM, spin-up kick and
+ *   automatic retries with exponential backoff
+ * - On-demand per-fan calibration of the speed/PWM curve, persisted in NVS
+ * - Event-driven control task, temperature changes reach the PWM output within a tick
+ * - Lock-free state snapshot for status readers
+ *
+ * Mode, PID loop and night mode are shared; every fan has its own pins,
+ * curve, stall state and RPM. Per-fan state is a structure of arrays
+ * indexed by channel, so a control pass is one O(N) sweep under the
+ * single controller mutex with no per-fan task or lock.
  */
 class FanController {
 public:
+    static constexpr uint8_t CHANNEL_COUNT = Config::Fan::Channels::COUNT;
+
     /**
      * @brief Operating modes for the fan controller
      */
@@ -35,45 +57,123 @@ public:
     };
 
     /**
-     * @brief Current status of the fan
+     * @brief Current status of a fan
      */
     enum class Status {
         OK,         ///< Normal operation
-        SHUTOFF,    ///< Fan stopped due to stall
-        ERROR       ///< General error condition
+        SHUTOFF,    ///< Stalled, recovery owns the PWM output
+        ERROR,      ///< General error condition
+        CALIBRATING ///< Calibration sweep owns the PWM output
+    };
+
+    /**
+     * @brief Likely cause of a stall that a spin-up kick did not clear
+     */
+    enum class Fault {
+        NONE,           ///< No failed recovery
+        BLOCKED,        ///< Fan present but the rotor does not turn freely
+        DISCONNECTED    ///< No tach signal at all, fan or cable missing
+    };
+
+    /**
+     * @brief Stall recovery step of a fan
+     */
+    enum class Recovery {
+        NONE,       ///< Normal control, RPM supervised
+        KICK,       ///< Full duty spin-up pulse
+        BACKOFF     ///< Output off until the next kick
     };
 
     /**
      * @brief Configuration parameters for fan operation
      */
     struct FanConfig {
-        float minTriggerTemp;          ///< Minimum trigger temperature for auto mode
-        float maxTriggerTemp;          ///< Maximum trigger temperature for auto mode
+        float minTriggerTemp;          ///< Below this the fan idles at minimum speed
+        float maxTriggerTemp;          ///< Above this the fan runs at maximum speed
+        float targetTemp;              ///< PID setpoint for auto mode
         uint8_t minSpeed;       ///< Minimum speed percentage
         uint8_t maxSpeed;       ///< Maximum speed percentage
-        uint8_t minPWM;        ///< Minimum PWM value
+        uint8_t minPWM;        ///< Minimum PWM value of uncalibrated fans
         uint8_t maxPWM;        ///< Maximum PWM value
         uint8_t nightMaxSpeed; ///< Maximum speed during night mode
         uint16_t minRPM;      ///< Minimum RPM before stall detection
         uint8_t nightStartHour; ///< Night mode start hour (0-23)
+        uint8_t nightStartMinute; ///< Night mode start minute (0-59)
         uint8_t nightEndHour;   ///< Night mode end hour (0-23)
+        uint8_t nightEndMinute; ///< Night mode end minute (0-59)
         bool testMode;          ///< Enable test mode simulation
     };
 
     /**
-     * @brief Encapsulates target speed states and calculations
+     * @brief Delay from a temperature reading to the resulting PWM write
+     *
+     * Measured from notifyTemperatureUpdated() to the first ledcWrite of
+     * the duty the control step computed. Readings that leave the duty
+     * unchanged are not counted.
      */
-    struct SpeedTarget {
-        uint8_t requestedSpeed;   ///< Originally requested speed value
-        uint8_t effectiveSpeed;   ///< Actual speed after applying limits
+    struct ResponseLatency {
+        uint32_t count;     ///< Measured responses
+        uint32_t lastUs;    ///< Latest response
+        uint32_t maxUs;     ///< Slowest response since boot
+        uint64_t totalUs;   ///< Sum for the mean
+    };
 
-        SpeedTarget() : requestedSpeed(0), effectiveSpeed(0) {}
+    /**
+     * @brief Consistent view of the controller state for readers
+     *
+     * Published through a seqlock whenever the state changes, so display,
+     * MQTT and health check readers never take the controller mutex.
+     * Per-fan fields are arrays indexed by channel.
+     */
+    struct Snapshot {
+        Mode mode;                               ///< Operating mode
+        Status status;                           ///< Most severe fan status
+        bool nightModeEnabled;                   ///< Night mode switched on
+        bool nightModeActive;                    ///< Night mode enabled and within quiet hours
+        uint8_t nightStartHour;                  ///< Night mode start hour (0-23)
+        uint8_t nightStartMinute;                ///< Night mode start minute (0-59)
+        uint8_t nightEndHour;                    ///< Night mode end hour (0-23)
+        uint8_t nightEndMinute;                  ///< Night mode end minute (0-59)
+        uint8_t nightMaxSpeed;                   ///< Maximum speed during night mode
+        time_t nightTransition;                  ///< Next quiet hours start or end (epoch)
+        bool ramping;                            ///< Some fan has not reached its target duty
+        ResponseLatency latency;                 ///< Temperature to PWM response time
+        float feedForward;                       ///< Speed added ahead of the temperature trend (%)
+        PidController::Gains pidGains;           ///< Loop gains
+        float targetTemp;                        ///< Loop setpoint (°C)
+        uint8_t calibrationChannel;              ///< Fan of the latest calibration run
+        FanCalibrator::Phase calibrationPhase;   ///< Phase of the latest run
+        uint8_t calibrationProgress;             ///< Progress of the latest run (0-100)
+        uint8_t currentSpeed[CHANNEL_COUNT];     ///< Commanded speed percentage
+        uint8_t targetSpeed[CHANNEL_COUNT];      ///< Effective target after night limits
+        uint16_t measuredRPM[CHANNEL_COUNT];     ///< Latest RPM estimate
+        Status channelStatus[CHANNEL_COUNT];     ///< Fan status
+        uint8_t appliedPWM[CHANNEL_COUNT];       ///< Duty currently output by the ramp
+        uint8_t targetPWM[CHANNEL_COUNT];        ///< Duty the ramp is heading to
+        uint16_t expectedRPM[CHANNEL_COUNT];     ///< RPM the calibration predicts, 0 if uncalibrated
+        Recovery recovery[CHANNEL_COUNT];        ///< Stall recovery step
+        Fault fault[CHANNEL_COUNT];              ///< Cause of the last failed kick
+        uint8_t stallRetries[CHANNEL_COUNT];     ///< Failed kicks since the fan last ran clean
+        uint32_t retryAtMs[CHANNEL_COUNT];       ///< millis() of the next kick while in backoff
+    };
+
+    /**
+     * @brief Calibration progress and the curve in use on one fan
+     */
+    struct CalibrationReport {
+        uint8_t runChannel;             ///< Fan of the latest run
+        FanCalibrator::Phase phase;     ///< Phase of the latest run
+        uint8_t progress;               ///< Progress of the latest run (0-100)
+        bool calibrated;                ///< Measured curve active, else built-in default
+        FanCalibrator::Result active;   ///< Active measured curve if calibrated
     };
 
     // Event flags for FreeRTOS event group
     static constexpr EventBits_t TEMP_UPDATED = (1 << 0);
     static constexpr EventBits_t NIGHT_MODE_CHANGED = (1 << 1);
     static constexpr EventBits_t CONTROL_MODE_CHANGED = (1 << 2);
+    static constexpr EventBits_t REVOLUTION = (1 << 3);
+    static constexpr EventBits_t ALL_EVENTS = TEMP_UPDATED | NIGHT_MODE_CHANGED | CONTROL_MODE_CHANGED | REVOLUTION;
 
     // Constructor and destructor
     explicit FanController(TaskManager& taskManager, ConfigPreference& config);
@@ -85,84 +185,216 @@ public:
 
     // Initialization
     esp_err_t begin();
+    uint8_t getChannelCount() const { return CHANNEL_COUNT; }
 
-    // Core control methods
+    // Core control methods, without a channel they apply to every fan
     bool setSpeedDutyCycle(uint8_t percentSpeed);
+    bool setSpeedDutyCycle(uint8_t channel, uint8_t percentSpeed);
     bool setControlMode(Mode mode);
     bool setTemperature(float temperature);
     bool attemptRecovery();
+    bool attemptRecovery(uint8_t channel);
+
+    // PID tuning, getters read the published snapshot
+    bool setPidTuning(const PidController::Gains& gains, float targetTemp);
+    PidController::Gains getPidGains() const;
+    float getTargetTemperature() const;
+
+    // Calibration, one fan at a time; the report is read lock-free
+    bool startCalibration(uint8_t channel = 0);
+    bool abortCalibration();
+    bool resetCalibration(uint8_t channel = 0);
+    CalibrationReport getCalibrationReport(uint8_t channel = 0) const;
 
     // Night mode configuration
     bool setNightMode(bool enabled);
+    // A maxPercent below the minimum speed is raised to it
     bool setNightSettings(uint8_t startHour, uint8_t endHour, uint8_t maxPercent);
+    bool setNightSettings(uint8_t startHour, uint8_t startMinute,
+                          uint8_t endHour, uint8_t endMinute, uint8_t maxPercent);
     bool isNightModeEnabled() const;
     uint8_t getNightStartHour() const;
+    uint8_t getNightStartMinute() const;
     uint8_t getNightEndHour() const;
+    uint8_t getNightEndMinute() const;
     uint8_t getNightMaxSpeed() const;
     bool isNightModeActive() const;
 
-    // Status getters
-    uint8_t getCurrentSpeed() const;        ///< Get current speed percentage (0-100)
-    uint8_t getTargetSpeed() const;         ///< Get target speed percentage (0-100)
-    uint16_t getMeasuredRPM() const;        ///< Get current fan RPM
-    Status getStatus() const;               ///< Get current fan status
-    Mode getControlMode() const;            ///< Get current operating mode
-    String getStatusString() const;         ///< Get human-readable status
+    // Status getters, lock-free reads of the published snapshot
+    Snapshot getSnapshot() const { return snapshot.read(); }
+    uint8_t getCurrentSpeed(uint8_t channel = 0) const;   ///< Get current speed percentage (0-100)
+    uint8_t getTargetSpeed(uint8_t channel = 0) const;    ///< Get target speed percentage (0-100)
+    uint16_t getMeasuredRPM(uint8_t channel = 0) const;   ///< Get current fan RPM
+    Status getStatus() const;                              ///< Get most severe fan status
+    Status getChannelStatus(uint8_t channel) const;        ///< Get status of one fan
+    Mode getControlMode() const;                           ///< Get current operating mode
+    String getStatusString() const;                        ///< Get human-readable status
     const FanConfig& getConfig() const { return config; }
+    const GpioTachSource* getTachLossSource() const;  ///< Measured fan's tach, nullptr unless measuring
+    static const char* faultToString(Fault fault);
+    static const char* recoveryToString(Recovery recovery);
 
     // Component registration
     void registerTempSensor(TempSensor* sensor);
     void registerNTPManager(NTPManager* manager);
     EventGroupHandle_t getEventGroup() const { return events; }
+    void notifyTemperatureUpdated();    ///< Wake the fan task for a new reading
 
     // Settings management
     void saveSettings(ConfigPreference& configPref);
     void loadSettings(ConfigPreference& configPref);
 
 private:
+    /**
+     * @brief Per-fan control state, one array per field indexed by channel
+     */
+    struct ChannelState {
+        uint8_t requestedSpeed[CHANNEL_COUNT];     ///< Speed from the loop or the user
+        uint8_t effectiveSpeed[CHANNEL_COUNT];     ///< Requested speed after night limits
+        uint8_t currentSpeed[CHANNEL_COUNT];       ///< Speed handed to the ramp
+        uint16_t measuredRPM[CHANNEL_COUNT];
+        Status status[CHANNEL_COUNT];
+        uint8_t stallCount[CHANNEL_COUNT];         ///< Consecutive readings below the band
+        uint16_t expectedRPM[CHANNEL_COUNT];
+        Recovery recovery[CHANNEL_COUNT];
+        Fault fault[CHANNEL_COUNT];
+        uint32_t recoveryMs[CHANNEL_COUNT];        ///< Kick start, or next kick while in backoff
+        uint32_t backoffMs[CHANNEL_COUNT];         ///< Off time after the next failed kick
+        uint8_t stallRetries[CHANNEL_COUNT];
+        uint32_t lastLowRPMMs[CHANNEL_COUNT];      ///< Last reading below the band
+        uint8_t minPWM[CHANNEL_COUNT];             ///< Start duty, calibrated or default
+        uint8_t outputPWM[CHANNEL_COUNT];          ///< Last duty handed to the ramp
+        uint32_t lastSpeedChangeMs[CHANNEL_COUNT];
+    };
+
+    /**
+     * @brief Quiet hours state, valid until the next transition
+     *
+     * Recomputed only when the transition passes, the clock was synced
+     * or stepped, or the settings change, so the control path does no
+     * calendar conversion.
+     */
+    struct NightSchedule {
+        bool valid;
+        bool active;                ///< Within quiet hours
+        time_t nextTransition;      ///< Epoch at which active flips
+        time_t computedAt;          ///< Detects the clock stepping backwards
+        uint32_t syncCount;         ///< NTP sync the schedule is based on
+    };
+
+    /**
+     * @brief Targets handed from the fan task to the ramp timer
+     */
+    struct RampState {
+        uint8_t targetPWM[CHANNEL_COUNT];
+        bool immediate[CHANNEL_COUNT];
+        int64_t eventUs;        ///< Temperature reading behind the targets, 0 if none
+        int64_t lastStepUs;     ///< Last duty change, spaces the steps
+    };
+
     // Core components
     TaskManager& taskManager;
+    TaskManager::TaskId taskId;
     SemaphoreHandle_t mutex;
     EventGroupHandle_t events;
     TempSensor* tempSensor;
     NTPManager* ntpManager;
     FanConfig config;
     ConfigPreference& configPreference;
+    PidController pid;
+    float feedForward;                     // Latest trend contribution to the PID output
+    FanCurve curves[CHANNEL_COUNT];
+    FanCalibrator calibrator;
+    uint8_t calibrationChannel;
+    FanCalibrator::Result activeCalibration[CHANNEL_COUNT];
+    bool calibrated[CHANNEL_COUNT];
     
     // State tracking
     Mode mode;
-    Status status;
-    SpeedTarget target;
-    uint8_t currentSpeed;
-    uint16_t measuredRPM;
-    uint8_t stallCount;
+    ChannelState channels;
     bool nightModeEnabled;
+    bool nightModeActive;
+    NightSchedule nightSchedule;
     bool initialized;
-    volatile static uint32_t pulseCount;
+    bool loadingSettings;                  // Setters skip saving what was just loaded
+
+    // Published state for lock-free readers; the active curves apart,
+    // they are large and change only with a calibration
+    SeqLock<Snapshot> snapshot;
+    SeqLock<FanCalibrator::Result> publishedCalibration[CHANNEL_COUNT];
+
+    // PWM ramp, stepped by a one-shot timer which is the only LEDC writer
+    // after begin(). The fan task hands over targets under rampLock and
+    // arms the timer; it re-arms itself until every fan reached its target.
+    esp_timer_handle_t rampTimer;
+    portMUX_TYPE rampLock;
+    RampState ramp;
+    uint8_t appliedPWM[CHANNEL_COUNT];     // Owned by the ramp timer
+
+    // Response latency instrumentation
+    int64_t temperatureEventUs;            // Latest reading, under rampLock
+    int64_t controlEventUs;                // Reading being processed, fan task only
+    int64_t lastControlEventUs;            // Previous reading fed to the PID, fan task only
+    int64_t revolutionEventUs;             // Latest REVOLUTION raised, under rampLock
+
+    // Tachometers, the simulated sources replace the hardware in test mode
+    TachSource* hardwareTach[CHANNEL_COUNT];
+    SimulatedTachSource simulatedTach[CHANNEL_COUNT];
+    Tachometer tachometers[CHANNEL_COUNT];
 
     // Task management
     static void fanTask(void* parameters);
     void processUpdate();
-    void processEvents();
+    void processEvents(EventBits_t bits);
+    void signalEvents(EventBits_t bits);     // Set the bits that wake the fan task
 
     // Hardware control
     bool setupPWM();
     bool setupTachometer();
-    static void IRAM_ATTR handleTachInterrupt();
-    void updateRPM();
+    bool setupRamp();
+    static TachSource* createTachSource(uint8_t channel);
+    void updateRPM(uint8_t channel);
+    void processRevolutions();
+    static void IRAM_ATTR handleRevolution(void* context);
+    void applyPWM(uint8_t channel, uint8_t pwm, bool immediate);
+    static void rampTimerCallback(void* arg);
+    void stepRamp();
+    void armRamp(int64_t delayUs);
     
     // Speed control helpers
-    void updateTargetSpeed(uint8_t requestedSpeed);
-    uint8_t calculateSpeedForTemperature(float temp) const;
-    void setTemperatureInternal(float temperature);
-    bool validateNightSettings(uint8_t startHour, uint8_t endHour, uint8_t maxPercent) const;
+    void updateTargetSpeeds();
+    void updateTargetSpeed(uint8_t channel);
+    uint8_t computeAutoSpeed(float temp, float trend);
+    void setTemperatureInternal(float temperature, float trend = 0.0f);
+    void resetPid();
+    bool recoverChannel(uint8_t channel);
+    void superviseChannel(uint8_t channel, uint32_t now);
+    void startKick(uint8_t channel, uint32_t now);
+    void finishKick(uint8_t channel, uint32_t now);
+    void resetRecovery(uint8_t channel);
+    void processCalibration(uint8_t channel);
+    void finishCalibration();
+    bool applyCurve(uint8_t channel, const FanCalibrator::Result& result);
+    void publishSnapshot();
+    bool validateNightSettings(uint8_t startHour, uint8_t startMinute,
+                               uint8_t endHour, uint8_t endMinute, uint8_t maxPercent) const;
     
     // Status helpers
-    bool isStalled() const;
-    bool isNightTime() const;
-    bool isNightTimeRTC() const;
+    Status aggregateStatus() const;
+    uint8_t getAppliedSpeed(uint8_t channel) const;
+    uint16_t expectedRPM(uint8_t channel, uint8_t pwm) const;
+    uint16_t stallThresholdRPM(uint8_t channel) const;
+    bool isNightTime();
+    void computeNightSchedule(time_t now, uint32_t syncCount);
+    bool isValidChannel(uint8_t channel) const { return channel < CHANNEL_COUNT; }
+
+    // Settings helpers
+    void savePidSettings(ConfigPreference& configPref);
+    void saveCurveSettings(ConfigPreference& configPref, uint8_t channel);
+    void loadCurveSettings(ConfigPreference& configPref);
+    void setLoadingSettings(bool loading);
 
     // Utility methods
-    uint8_t SpeedToRawPWM(uint8_t percent) const;
-    uint8_t rawPWMToSpeed(uint8_t raw) const;
+    uint8_t SpeedToRawPWM(uint8_t channel, uint8_t percent) const;
+    uint8_t rawPWMToSpeed(uint8_t channel, uint8_t raw) const;
 };
\ No newline at end of file
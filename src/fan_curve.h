@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "config.h"
+
+/**
+ * @brief Speed <-> PWM transfer curve backed by precomputed lookup tables
+ *
+ * Both directions are generated from a single list of calibration points:
+ * - 101-entry speed (0-100%) to raw PWM table
+ * - 256-entry raw PWM to speed table
+ *
+ * Tables are filled with integer interpolation rounded to nearest, so a
+ * curve can be built at compile time (see defaultCurve()) or at runtime
+ * from measured points. Lookups are a single bounds-checked array read
+ * with no floating point, which keeps them safe to call from IRAM code
+ * as long as the instance itself lives in DRAM.
+ */
+class FanCurve {
+public:
+    using Point = Config::Fan::Curve::Point;
+
+    static constexpr size_t SPEED_ENTRIES = 101;
+    static constexpr size_t PWM_ENTRIES = 256;
+
+    constexpr FanCurve() : speedToPwmTable{}, pwmToSpeedTable{} {}
+
+    /**
+     * @brief Build both tables from calibration points
+     * @param points Points sorted by strictly increasing speed and PWM,
+     *               starting at speed 0 and ending at speed 100
+     * @param count Number of points
+     * @return Curve with populated tables, or an all-zero curve if the
+     *         points are not valid (see isValid())
+     */
+    static constexpr FanCurve fromPoints(const Point* points, size_t count) {
+        FanCurve curve;
+        if (!isValid(points, count)) return curve;
+
+        // Speed -> PWM
+        size_t segment = 0;
+        for (size_t speed = 0; speed < SPEED_ENTRIES; speed++) {
+            while (segment + 2 < count && speed > points[segment + 1].speed) segment++;
+            curve.speedToPwmTable[speed] = interpolate(
+                speed, points[segment].speed, points[segment + 1].speed,
+                points[segment].pwm, points[segment + 1].pwm);
+        }
+
+        // PWM -> speed, flat below the first and above the last point
+        segment = 0;
+        for (size_t pwm = 0; pwm < PWM_ENTRIES; pwm++) {
+            if (pwm <= points[0].pwm) {
+                curve.pwmToSpeedTable[pwm] = points[0].speed;
+                continue;
+            }
+            if (pwm >= points[count - 1].pwm) {
+                curve.pwmToSpeedTable[pwm] = points[count - 1].speed;
+                continue;
+            }
+            while (segment + 2 < count && pwm > points[segment + 1].pwm) segment++;
+            curve.pwmToSpeedTable[pwm] = interpolate(
+                pwm, points[segment].pwm, points[segment + 1].pwm,
+                points[segment].speed, points[segment + 1].speed);
+        }
+
+        return curve;
+    }
+
+    template <size_t N>
+    static constexpr FanCurve fromPoints(const Point (&points)[N]) {
+        return fromPoints(points, N);
+    }
+
+    /**
+     * @brief Curve generated at compile time from Config::Fan::Curve::DEFAULT_POINTS
+     */
+    static constexpr FanCurve defaultCurve() {
+        return fromPoints(Config::Fan::Curve::DEFAULT_POINTS);
+    }
+
+    /**
+     * @brief Check that points cover 0-100% and are strictly increasing
+     */
+    static constexpr bool isValid(const Point* points, size_t count) {
+        if (!points || count < 2) return false;
+        if (points[0].speed != 0 || points[count - 1].speed != 100) return false;
+        for (size_t i = 1; i < count; i++) {
+            if (points[i].speed <= points[i - 1].speed) return false;
+            if (points[i].pwm <= points[i - 1].pwm) return false;
+        }
+        return true;
+    }
+
+    // Lookups
+    constexpr uint8_t speedToPwm(uint8_t percent) const {
+        return speedToPwmTable[percent < SPEED_ENTRIES ? percent : SPEED_ENTRIES - 1];
+    }
+
+    constexpr uint8_t pwmToSpeed(uint8_t pwm) const {
+        return pwmToSpeedTable[pwm];
+    }
+
+    // Table properties, used for compile-time verification
+    constexpr bool isMonotonic() const {
+        for (size_t i = 1; i < SPEED_ENTRIES; i++) {
+            if (speedToPwmTable[i] < speedToPwmTable[i - 1]) return false;
+        }
+        for (size_t i = 1; i < PWM_ENTRIES; i++) {
+            if (pwmToSpeedTable[i] < pwmToSpeedTable[i - 1]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Largest |speed - pwmToSpeed(speedToPwm(speed))| over 0-100%
+     */
+    constexpr uint8_t maxRoundTripError() const {
+        uint8_t worst = 0;
+        for (size_t speed = 0; speed < SPEED_ENTRIES; speed++) {
+            uint8_t back = pwmToSpeed(speedToPwm(speed));
+            uint8_t error = back > speed ? back - speed : speed - back;
+            if (error > worst) worst = error;
+        }
+        return worst;
+    }
+
+private:
+    uint8_t speedToPwmTable[SPEED_ENTRIES];
+    uint8_t pwmToSpeedTable[PWM_ENTRIES];
+
+    // Integer linear interpolation, rounded to nearest
+    static constexpr uint8_t interpolate(size_t x, size_t x0, size_t x1,
+                                         size_t y0, size_t y1) {
+        if (x <= x0) return y0;
+        if (x >= x1) return y1;
+        size_t dx = x1 - x0;
+        size_t offset = x - x0;
+        if (y1 >= y0) {
+            return y0 + ((y1 - y0) * offset + dx / 2) / dx;
+        }
+        return y0 - ((y0 - y1) * offset + dx / 2) / dx;
+    }
+};
+
+static_assert(FanCurve::isValid(Config::Fan::Curve::DEFAULT_POINTS,
+                                sizeof(Config::Fan::Curve::DEFAULT_POINTS) /
+                                sizeof(Config::Fan::Curve::DEFAULT_POINTS[0])),
+              "Default fan curve points must span 0-100% and increase strictly");
+static_assert(FanCurve::defaultCurve().isMonotonic(),
+              "Default fan curve tables must be monotonic");
+static_assert(FanCurve::defaultCurve().maxRoundTripError() <= 1,
+              "Default fan curve must round-trip within 1%");
@@ -0,0 +1,111 @@
+/**
+ * @file gpio_tach_source.cpp
+ * @brief Implementation of the GPIO interrupt based tachometer source
+ */
+
+#include "gpio_tach_source.h"
+#include "esp_timer.h"
+#include "config.h"
+#include "debug_log.h"
+
+/*******************************************************************************
+ * Construction / Destruction
+ ******************************************************************************/
+
+GpioTachSource::GpioTachSource(uint8_t tachPin, uint8_t pulsesPerRev)
+    : pin(tachPin)
+    , pulsesPerRevolution(pulsesPerRev)
+    , initialized(false)
+    , pulses(0)
+    , edges(0)
+    , lastEdgeUs(0)
+    , revolutions(0)
+    , lastRevolutionUs(0) {
+    portMUX_INITIALIZE(&spinlock);
+}
+
+GpioTachSource::~GpioTachSource() {
+    if (initialized) {
+        gpio_isr_handler_remove(static_cast<gpio_num_t>(pin));
+    }
+}
+
+/*******************************************************************************
+ * Initialization
+ ******************************************************************************/
+
+bool GpioTachSource::begin() {
+    if (initialized) return true;
+
+    gpio_num_t gpio = static_cast<gpio_num_t>(pin);
+
+    gpio_config_t ioConfig = {};
+    ioConfig.pin_bit_mask = 1ULL << pin;
+    ioConfig.mode = GPIO_MODE_INPUT;
+    ioConfig.pull_up_en = GPIO_PULLUP_ENABLE;     // Tach outputs are open collector
+    ioConfig.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    ioConfig.intr_type = GPIO_INTR_NEGEDGE;
+
+    if (gpio_config(&ioConfig) != ESP_OK) {
+        DEBUG_LOG_FAN("Tach GPIO %d configuration failed", pin);
+        return false;
+    }
+
+    // The ISR service is shared with attachInterrupt() and may already be installed
+    esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        DEBUG_LOG_FAN("GPIO ISR service install failed: %d", err);
+        return false;
+    }
+
+    if (gpio_isr_handler_add(gpio, handleEdge, this) != ESP_OK) {
+        DEBUG_LOG_FAN("Tach GPIO %d ISR registration failed", pin);
+        return false;
+    }
+
+    initialized = true;
+    return true;
+}
+
+/*******************************************************************************
+ * Revolution Tracking
+ ******************************************************************************/
+
+void IRAM_ATTR GpioTachSource::handleEdge(void* arg) {
+    GpioTachSource* source = static_cast<GpioTachSource*>(arg);
+    uint32_t now = static_cast<uint32_t>(esp_timer_get_time());
+
+    bool completed = false;
+    portENTER_CRITICAL_ISR(&source->spinlock);
+    if (now - source->lastEdgeUs >= Config::Fan::Tach::GPIO_MIN_EDGE_US) {
+        source->lastEdgeUs = now;
+        source->edges = source->edges + 1;
+        source->pulses = source->pulses + 1;
+        if (source->pulses >= source->pulsesPerRevolution) {
+            source->pulses = 0;
+            source->revolutions = source->revolutions + 1;
+            source->lastRevolutionUs = now;
+            completed = true;
+        }
+    }
+    portEXIT_CRITICAL_ISR(&source->spinlock);
+
+    if (completed && source->revolutionHandler) {
+        source->revolutionHandler(source->revolutionContext);
+    }
+}
+
+TachSource::Capture GpioTachSource::capture(uint32_t nowUs) {
+    (void)nowUs;
+
+    Capture result;
+    portENTER_CRITICAL(&spinlock);
+    result.revolutions = revolutions;
+    result.lastRevolutionUs = lastRevolutionUs;
+    portEXIT_CRITICAL(&spinlock);
+    return result;
+}
+
+bool GpioTachSource::isLineLow() const {
+    return gpio_get_level(static_cast<gpio_num_t>(pin)) == 0;
+}
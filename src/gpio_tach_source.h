@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "tachometer.h"
+
+/**
+ * @brief Tachometer source on a plain GPIO edge interrupt
+ *
+ * Fallback for fans beyond the four PCNT units of the ESP32-S3. Every
+ * falling edge interrupts the CPU; edges closer together than
+ * Config::Fan::Tach::GPIO_MIN_EDGE_US are rejected as glitches, and every
+ * pulsesPerRevolution accepted edges complete a timestamped revolution.
+ */
+class GpioTachSource : public TachSource {
+public:
+    /**
+     * @param pin Tachometer GPIO (open collector, pulled up)
+     * @param pulsesPerRevolution Tach pulses emitted per fan revolution
+     */
+    GpioTachSource(uint8_t pin, uint8_t pulsesPerRevolution);
+    ~GpioTachSource() override;
+
+    // Prevent copying
+    GpioTachSource(const GpioTachSource&) = delete;
+    GpioTachSource& operator=(const GpioTachSource&) = delete;
+
+    bool begin() override;
+    Capture capture(uint32_t nowUs) override;
+    bool isLineLow() const override;
+
+    /**
+     * @brief Edges accepted since construction, wraps
+     */
+    uint32_t getEdges() const { return edges; }
+
+private:
+    const uint8_t pin;
+    const uint8_t pulsesPerRevolution;
+    bool initialized;
+
+    // Written from the GPIO ISR
+    portMUX_TYPE spinlock;
+    volatile uint8_t pulses;
+    volatile uint32_t edges;
+    volatile uint32_t lastEdgeUs;
+    volatile uint32_t revolutions;
+    volatile uint32_t lastRevolutionUs;
+
+    static void IRAM_ATTR handleEdge(void* arg);
+};
@@ -0,0 +1,295 @@
+/**
+ * @file history_store.cpp
+ * @brief Implementation of the tiered temperature and RPM history
+ */
+
+#include "history_store.h"
+#include "temp_sensor.h"
+#include "debug_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include <cmath>
+
+namespace {
+    constexpr int16_t NO_DATA = INT16_MIN;
+
+    constexpr size_t TIER_POINTS[] = {
+        Config::History::Raw::POINTS,
+        Config::History::Minute::POINTS,
+        Config::History::Hour::POINTS,
+    };
+}
+
+/*******************************************************************************
+ * Construction / Destruction
+ ******************************************************************************/
+
+HistoryStore::HistoryStore(TaskManager& tm, TempSensor& ts, FanController& fc)
+    : taskManager(tm)
+    , tempSensor(ts)
+    , fanController(fc)
+    , mutex(xSemaphoreCreateMutex())
+    , ready(false)
+    , footprintBytes(0)
+    , rings{}
+    , accumulators{} {
+}
+
+HistoryStore::~HistoryStore() {
+    for (Ring& ring : rings) {
+        heap_caps_free(ring.times);
+        heap_caps_free(ring.slots);
+    }
+    if (mutex) {
+        vSemaphoreDelete(mutex);
+    }
+}
+
+/*******************************************************************************
+ * Initialization
+ ******************************************************************************/
+
+esp_err_t HistoryStore::begin() {
+    if (!mutex) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint8_t tier = 0; tier < static_cast<uint8_t>(Tier::COUNT); tier++) {
+        if (!allocate(rings[tier], TIER_POINTS[tier])) {
+            DEBUG_LOG_HISTORY("History disabled: %u bytes of PSRAM unavailable",
+                              (unsigned)(TIER_POINTS[tier] * (sizeof(uint32_t) + sizeof(Slot) * SERIES_COUNT)));
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // Fixed from here on, nothing is allocated while recording
+    DEBUG_LOG_HISTORY("%u series, raw %u B, minute %u B, hour %u B, total %u B in PSRAM",
+                      SERIES_COUNT,
+                      (unsigned)(rings[0].capacity * (sizeof(uint32_t) + sizeof(Slot) * SERIES_COUNT)),
+                      (unsigned)(rings[1].capacity * (sizeof(uint32_t) + sizeof(Slot) * SERIES_COUNT)),
+                      (unsigned)(rings[2].capacity * (sizeof(uint32_t) + sizeof(Slot) * SERIES_COUNT)),
+                      (unsigned)footprintBytes);
+
+    TaskManager::TaskConfig taskConfig("History",
+                                       Config::History::Task::STACK_SIZE,
+                                       Config::History::Task::TASK_PRIORITY,
+                                       Config::History::Task::TASK_CORE,
+                                       Config::History::Task::PERIOD_MS,
+                                       Config::History::Task::DEADLINE_MS,
+                                       Config::History::Task::POLICY,
+                                       Config::History::Task::WATCHDOG,
+                                       Config::History::Task::MEMORY);
+    esp_err_t err = taskManager.createTask(taskConfig, historyTask, this, &taskId);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    ready = true;
+    return ESP_OK;
+}
+
+bool HistoryStore::allocate(Ring& ring, size_t capacity) {
+    size_t timesBytes = capacity * sizeof(uint32_t);
+    size_t slotsBytes = capacity * SERIES_COUNT * sizeof(Slot);
+
+    ring.times = static_cast<uint32_t*>(heap_caps_malloc(timesBytes, MALLOC_CAP_SPIRAM));
+    ring.slots = static_cast<Slot*>(heap_caps_malloc(slotsBytes, MALLOC_CAP_SPIRAM));
+    if (!ring.times || !ring.slots) {
+        return false;
+    }
+
+    ring.capacity = capacity;
+    ring.head = 0;
+    ring.count = 0;
+    footprintBytes += timesBytes + slotsBytes;
+    return true;
+}
+
+/*******************************************************************************
+ * Recording
+ ******************************************************************************/
+
+void HistoryStore::record(uint32_t timeS, const float* values) {
+    if (!ready) return;
+
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return;
+
+    Slot raw[SERIES_COUNT];
+    for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+        int16_t value = toFixed(series, values[series]);
+        raw[series] = { value, value, value };
+    }
+    push(rings[static_cast<uint8_t>(Tier::RAW)], timeS, raw);
+
+    accumulate(Tier::MINUTE, timeS, values);
+    accumulate(Tier::HOUR, timeS, values);
+}
+
+void HistoryStore::push(Ring& ring, uint32_t timeS, const Slot* slots) {
+    ring.times[ring.head] = timeS;
+    memcpy(&ring.slots[ring.head * SERIES_COUNT], slots, sizeof(Slot) * SERIES_COUNT);
+    ring.head = (ring.head + 1) % ring.capacity;
+    if (ring.count < ring.capacity) ring.count++;
+}
+
+void HistoryStore::accumulate(Tier tier, uint32_t timeS, const float* values) {
+    Accumulator& acc = accumulators[static_cast<uint8_t>(tier)];
+    uint32_t startS = timeS - timeS % tierPeriodS(tier);
+
+    if (acc.open && acc.startS != startS) {
+        flush(tier);
+    }
+    if (!acc.open) {
+        acc.startS = startS;
+        acc.open = true;
+        for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+            acc.samples[series] = 0;
+            acc.sum[series] = 0.0f;
+        }
+    }
+
+    for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+        float value = values[series];
+        if (std::isnan(value)) continue;
+
+        if (!acc.samples[series] || value < acc.min[series]) acc.min[series] = value;
+        if (!acc.samples[series] || value > acc.max[series]) acc.max[series] = value;
+        acc.sum[series] += value;
+        acc.samples[series]++;
+    }
+}
+
+void HistoryStore::flush(Tier tier) {
+    Accumulator& acc = accumulators[static_cast<uint8_t>(tier)];
+
+    Slot slots[SERIES_COUNT];
+    for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+        if (acc.samples[series]) {
+            slots[series] = {
+                toFixed(series, acc.min[series]),
+                toFixed(series, acc.sum[series] / acc.samples[series]),
+                toFixed(series, acc.max[series])
+            };
+        } else {
+            slots[series] = { NO_DATA, NO_DATA, NO_DATA };
+        }
+    }
+
+    push(rings[static_cast<uint8_t>(tier)], acc.startS, slots);
+    acc.open = false;
+}
+
+/*******************************************************************************
+ * Range Query
+ ******************************************************************************/
+
+size_t HistoryStore::query(Tier tier, uint8_t series, uint32_t fromS, uint32_t toS,
+                           Point* out, size_t maxPoints) const {
+    if (!ready || tier >= Tier::COUNT || series >= SERIES_COUNT || !maxPoints) return 0;
+
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return 0;
+
+    // Walk back from the newest slot so the most recent points win
+    const Ring& ring = rings[static_cast<uint8_t>(tier)];
+    size_t found = 0;
+    for (size_t i = 0; i < ring.count && found < maxPoints; i++) {
+        size_t index = (ring.head + ring.capacity - 1 - i) % ring.capacity;
+        uint32_t timeS = ring.times[index];
+        if (timeS > toS) continue;
+        if (timeS < fromS) break;
+
+        const Slot& slot = ring.slots[index * SERIES_COUNT + series];
+        if (slot.avg == NO_DATA) continue;
+
+        out[found++] = {
+            timeS,
+            fromFixed(series, slot.min),
+            fromFixed(series, slot.avg),
+            fromFixed(series, slot.max)
+        };
+    }
+
+    // Restore chronological order
+    for (size_t i = 0; i < found / 2; i++) {
+        Point tmp = out[i];
+        out[i] = out[found - 1 - i];
+        out[found - 1 - i] = tmp;
+    }
+    return found;
+}
+
+/*******************************************************************************
+ * Utility Methods
+ ******************************************************************************/
+
+int16_t HistoryStore::toFixed(uint8_t series, float value) {
+    if (std::isnan(value)) return NO_DATA;
+
+    float scaled = series == SERIES_TEMPERATURE ? value * Config::History::TEMPERATURE_SCALE : value;
+    return static_cast<int16_t>(constrain(lroundf(scaled), NO_DATA + 1, INT16_MAX));
+}
+
+float HistoryStore::fromFixed(uint8_t series, int16_t value) {
+    return series == SERIES_TEMPERATURE ? value / Config::History::TEMPERATURE_SCALE : value;
+}
+
+uint32_t HistoryStore::nowS() {
+    return static_cast<uint32_t>(esp_timer_get_time() / 1000000);
+}
+
+uint32_t HistoryStore::tierPeriodS(Tier tier) {
+    switch (tier) {
+        case Tier::MINUTE: return Config::History::Minute::PERIOD_S;
+        case Tier::HOUR:   return Config::History::Hour::PERIOD_S;
+        default:           return Config::History::Raw::PERIOD_S;
+    }
+}
+
+const char* HistoryStore::tierToString(Tier tier) {
+    switch (tier) {
+        case Tier::RAW:    return "raw";
+        case Tier::MINUTE: return "minute";
+        case Tier::HOUR:   return "hour";
+        default:           return "unknown";
+    }
+}
+
+bool HistoryStore::tierFromString(const char* name, Tier& tier) {
+    for (uint8_t i = 0; i < static_cast<uint8_t>(Tier::COUNT); i++) {
+        if (strcmp(name, tierToString(static_cast<Tier>(i))) == 0) {
+            tier = static_cast<Tier>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * Task Implementation
+ ******************************************************************************/
+
+void HistoryStore::historyTask(void* parameters) {
+    HistoryStore* history = static_cast<HistoryStore*>(parameters);
+    TickType_t lastWakeTime = xTaskGetTickCount();
+    float values[SERIES_COUNT];
+
+    while (true) {
+        history->taskManager.heartbeat(history->taskId);
+
+        values[SERIES_TEMPERATURE] = history->tempSensor.isLastReadSuccess()
+            ? history->tempSensor.getCurrentTemp()
+            : NAN;
+
+        FanController::Snapshot fan = history->fanController.getSnapshot();
+        for (uint8_t channel = 0; channel < FanController::CHANNEL_COUNT; channel++) {
+            values[rpmSeries(channel)] = fan.measuredRPM[channel];
+        }
+
+        history->record(nowS(), values);
+        history->taskManager.workDone(history->taskId);
+
+        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(Config::History::Raw::PERIOD_S * 1000));
+    }
+}
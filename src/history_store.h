@@ -0,0 +1,141 @@
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "config.h"
+#include "task_manager.h"
+#include "mutex_guard.h"
+#include "fan_controller.h"
+
+// Forward declarations
+class TempSensor;
+
+/**
+ * @brief Tiered time series of the temperature and every fan's RPM
+ *
+ * Three ring buffers at decreasing resolution:
+ * - RAW: one sample per second for 10 minutes
+ * - MINUTE: min/avg/max per minute for 24 hours
+ * - HOUR: min/avg/max per hour for 30 days
+ *
+ * Features:
+ * - Storage allocated once in PSRAM at begin(), fixed footprint reported at boot
+ * - Incremental downsampling: open minute and hour slots accumulate every
+ *   raw sample and are written out when their period ends
+ * - Allocation-free recording and range queries
+ * - Thread-safe; sampled by its own low priority task
+ *
+ * Slot times are seconds since boot, so history is consistent before the
+ * first NTP sync.
+ */
+class HistoryStore {
+public:
+    enum class Tier : uint8_t {
+        RAW,
+        MINUTE,
+        HOUR,
+        COUNT
+    };
+
+    // Series 0 is the control temperature, series 1 + n the RPM of fan n
+    static constexpr uint8_t SERIES_TEMPERATURE = 0;
+    static constexpr uint8_t SERIES_COUNT = 1 + FanController::CHANNEL_COUNT;
+    static constexpr uint8_t rpmSeries(uint8_t channel) { return 1 + channel; }
+
+    /**
+     * @brief One slot of a series; raw slots have min == avg == max
+     */
+    struct Point {
+        uint32_t timeS;     ///< Slot start, seconds since boot
+        float min;
+        float avg;
+        float max;
+    };
+
+    HistoryStore(TaskManager& taskManager, TempSensor& tempSensor, FanController& fanController);
+    ~HistoryStore();
+
+    // Prevent copying
+    HistoryStore(const HistoryStore&) = delete;
+    HistoryStore& operator=(const HistoryStore&) = delete;
+
+    /**
+     * @brief Allocate the tiers and start sampling
+     * @return ESP_ERR_NO_MEM without PSRAM, the history is then disabled
+     */
+    esp_err_t begin();
+
+    /**
+     * @brief Add one raw sample
+     * @param timeS Seconds since boot
+     * @param values SERIES_COUNT values, NAN where a series has no data
+     */
+    void record(uint32_t timeS, const float* values);
+
+    /**
+     * @brief Copy completed slots of one series within [fromS, toS]
+     *
+     * Slots without data are skipped. If the range holds more than
+     * maxPoints, the most recent ones are returned. Points are in
+     * chronological order.
+     * @return Number of points written to out
+     */
+    size_t query(Tier tier, uint8_t series, uint32_t fromS, uint32_t toS,
+                 Point* out, size_t maxPoints) const;
+
+    size_t getFootprintBytes() const { return footprintBytes; }
+    bool isReady() const { return ready; }
+
+    static uint32_t nowS();
+    static uint32_t tierPeriodS(Tier tier);
+    static const char* tierToString(Tier tier);
+    static bool tierFromString(const char* name, Tier& tier);
+
+private:
+    // Values are stored in fixed point, INT16_MIN marks a slot without data
+    struct Slot {
+        int16_t min;
+        int16_t avg;
+        int16_t max;
+    };
+
+    struct Ring {
+        uint32_t* times;        // Slot start per entry
+        Slot* slots;            // capacity x SERIES_COUNT
+        size_t capacity;
+        size_t head;            // Next entry to write
+        size_t count;
+    };
+
+    // Open slot of a downsampled tier
+    struct Accumulator {
+        uint32_t startS;
+        bool open;
+        float min[SERIES_COUNT];
+        float max[SERIES_COUNT];
+        float sum[SERIES_COUNT];
+        uint16_t samples[SERIES_COUNT];
+    };
+
+    TaskManager& taskManager;
+    TaskManager::TaskId taskId;
+    TempSensor& tempSensor;
+    FanController& fanController;
+    SemaphoreHandle_t mutex;
+    bool ready;
+    size_t footprintBytes;
+
+    Ring rings[static_cast<uint8_t>(Tier::COUNT)];
+    Accumulator accumulators[static_cast<uint8_t>(Tier::COUNT)];   // RAW unused
+
+    bool allocate(Ring& ring, size_t capacity);
+    void push(Ring& ring, uint32_t timeS, const Slot* slots);
+    void accumulate(Tier tier, uint32_t timeS, const float* values);
+    void flush(Tier tier);
+
+    static int16_t toFixed(uint8_t series, float value);
+    static float fromFixed(uint8_t series, int16_t value);
+
+    static void historyTask(void* parameters);
+};
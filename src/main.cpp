@@ -1,8 +1,16 @@
 #include <Arduino.h>
 #include <OneButton.h>
+#include <LittleFS.h>
+#include "esp_heap_caps.h"
 #include "task_manager.h"
 #include "wifi_manager.h"
 #include "temp_sensor.h"
+#include "sensor_bus.h"
+#include "rmt_onewire.h"
+#include "bitbang_onewire.h"
+#include "tach_edge_monitor.h"
+#include "replay_source.h"
+#include "trace_recorder.h"
 #include "fan_controller.h"
 #include "config.h"
 #include "mqtt_manager.h"
@@ -11,16 +19,39 @@
 #include "system_initializer.h"
 #include "debug_log.h"
 #include "config_preference.h"
+#include "history_store.h"
+#include "cpu_monitor.h"
+#include "cooperative_executor.h"
+
+// Only the transport selected in Config::Temperature::Bus is constructed,
+// the other one never claims the pin or its peripherals
+static auto makeProbeTransport() {
+    if constexpr (Config::Temperature::Bus::USE_RMT) {
+        return RmtOneWire(Config::Temperature::SENSOR_PIN,
+                          static_cast<rmt_channel_t>(Config::Temperature::Bus::RMT_TX_CHANNEL),
+                          static_cast<rmt_channel_t>(Config::Temperature::Bus::RMT_RX_CHANNEL));
+    } else {
+        return BitBangOneWire(Config::Temperature::SENSOR_PIN);
+    }
+}
 
 // System components
 TaskManager taskManager;
 WifiManager wifiManager(taskManager);
-TempSensor tempSensor(taskManager);
+auto probeTransport = makeProbeTransport();
+SensorBus probeBus(probeTransport);
+ReplaySource traceReplay(Config::Temperature::Trace::REPLAY_SPEED, Config::Temperature::Trace::REPLAY_LOOP);
+TempSensor tempSensor(taskManager, Config::Temperature::Trace::REPLAY
+                                       ? static_cast<TemperatureSource&>(traceReplay)
+                                       : probeBus);
 NTPManager ntpManager(taskManager);
 ConfigPreference configPreference;
 FanController fanController(taskManager, configPreference);
 MqttManager mqttManager(taskManager, tempSensor, fanController);
 DisplayManager displayManager(taskManager, tempSensor, fanController, wifiManager, mqttManager);
+HistoryStore historyStore(taskManager, tempSensor, fanController);
+CpuMonitor cpuMonitor;
+CooperativeExecutor executor(taskManager);
 
 // Button
 
@@ -31,7 +62,16 @@ struct ButtonParams {
 };
 static ButtonParams buttonParams;
 
-void performSystemHealthCheck();
+// Temperature trace
+File traceFile;
+
+// Tach edges missed during probe readouts, on the PCNT unit the measured fan gives up
+TachEdgeMonitor tachEdgeMonitor(
+    Config::Fan::Channels::PINS[Config::Temperature::Bus::MEASURE_FAN_CHANNEL].tachPin,
+    static_cast<pcnt_unit_t>(Config::Temperature::Bus::MEASURE_FAN_CHANNEL));
+
+void performSystemHealthCheck(bool tasksHealthy);
+void setupTemperatureTrace();
 
 void setup() {
     // Set power pin first thing, important for LilyGo on battery
@@ -55,6 +95,15 @@ void setup() {
         return;
     }
 
+    // Before the sensor starts, it replays or records from its first sample
+    setupTemperatureTrace();
+
+    // Before their begin(), which then adds a job instead of a task
+    if (Config::Executor::ENABLED) {
+        wifiManager.registerExecutor(&executor);
+        ntpManager.registerExecutor(&executor);
+    }
+
     // Initialize first
     SystemInitializer initializer(
         taskManager, displayManager, displayDriver,
@@ -69,6 +118,30 @@ void setup() {
         return;
     }
 
+    // After the fans, it compares against the measured fan's tach source
+    if (Config::Temperature::Bus::MEASURE_TACH_LOSS) {
+        if (tachEdgeMonitor.begin(fanController.getTachLossSource())) {
+            tempSensor.registerTachEdgeMonitor(&tachEdgeMonitor);
+        } else {
+            Serial.println("Tach loss measurement unavailable");
+        }
+    }
+
+    // History is optional, the controller runs without it
+    if (historyStore.begin() == ESP_OK) {
+        mqttManager.registerHistoryStore(&historyStore);
+    } else {
+        Serial.println("History store unavailable");
+    }
+
+    // Needs run-time stats in the FreeRTOS build
+    if (cpuMonitor.begin()) {
+        mqttManager.registerCpuMonitor(&cpuMonitor);
+        displayManager.registerCpuMonitor(&cpuMonitor);
+    } else {
+        Serial.println("CPU monitor unavailable");
+    }
+
     // Add a delay before button setup
     delay(100);
  
@@ -86,6 +159,19 @@ void setup() {
         params->displayManager->handleButtonPress();
     }, &buttonParams);
 
+    button.attachDoubleClick([](void* ctx) {
+        auto* params = static_cast<ButtonParams*>(ctx);
+        params->displayManager->toggleDiagnostics();
+    }, &buttonParams);
+
+    // The supervisor runs in the loop, the watchdog covers it stalling
+    if (Config::TaskManager::Watchdog::WATCH_LOOP) {
+        enableLoopWDT();
+    }
+
+    // Every task exists by now
+    taskManager.printMemoryBudget();
+
     Serial.println("System initialization complete!");
 }
 
@@ -93,23 +179,83 @@ void loop() {
     button.tick(); // Call this in the loop to process button events
 
     static uint32_t lastCheck = 0;
+    static uint32_t lastSupervision = 0;
+    static uint32_t lastCpuSample = 0;
+    static uint32_t lastStackReport = 0;
+    static uint32_t lastTimingReport = 0;
+    static bool tasksHealthy = true;
     uint32_t now = millis();
 
+    if (now - lastSupervision >= Config::TaskManager::Supervisor::CHECK_INTERVAL_MS) {
+        lastSupervision = now;
+        tasksHealthy = taskManager.checkTaskHealth();
+    }
+
+    if (cpuMonitor.isAvailable() && now - lastCpuSample >= Config::CpuMonitor::WINDOW_MS) {
+        lastCpuSample = now;
+        cpuMonitor.sample();
+    }
+
+    if (now - lastStackReport >= Config::TaskManager::StackSizing::REPORT_INTERVAL_MS) {
+        lastStackReport = now;
+        taskManager.printStackReport();
+    }
+
+    if (now - lastTimingReport >= Config::TaskManager::LoopTiming::REPORT_INTERVAL_MS) {
+        lastTimingReport = now;
+        taskManager.printTimingReport();
+    }
+
     if (now - lastCheck >= 5000) {
         lastCheck = now;
-        performSystemHealthCheck();
+        performSystemHealthCheck(tasksHealthy);
     }
     
     delay(1);
 }
 
-void performSystemHealthCheck() {
+void setupTemperatureTrace() {
+    using namespace Config::Temperature::Trace;
+    if (!REPLAY && !RECORD) return;
+
+    if (!LittleFS.begin(true)) {
+        Serial.println("LittleFS mount failed, temperature trace disabled");
+        return;
+    }
+
+    if (REPLAY) {
+        File file = LittleFS.open(FILE, "r");
+        size_t size = file ? file.size() : 0;
+        uint8_t* trace = size ? static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_SPIRAM)) : nullptr;
+        if (!trace || file.read(trace, size) != size) {
+            Serial.printf("Temperature trace %s not loaded, no temperature source!\n", FILE);
+            heap_caps_free(trace);
+            return;
+        }
+        file.close();
+
+        // Kept for the lifetime of the replay
+        traceReplay.load(trace, size);
+        Serial.printf("Replaying temperature trace %s (%u bytes)\n", FILE, (unsigned)size);
+        return;
+    }
+
+    traceFile = LittleFS.open(FILE, "w");
+    if (!traceFile) {
+        Serial.printf("Temperature trace %s not created\n", FILE);
+        return;
+    }
+    static TraceRecorder recorder(traceFile);
+    tempSensor.registerTraceRecorder(&recorder);
+    Serial.printf("Recording temperature trace to %s\n", FILE);
+}
+
+void performSystemHealthCheck(bool tasksHealthy) {
     DEBUG_LOG_MAIN("\n=== System Status ===");
 
-    // Check task health
-    bool healthy = taskManager.checkTaskHealth();
-    DEBUG_LOG_MAIN("System health: %s", healthy ? "OK" : "FAIL");
-    if (!healthy) {
+    // Task health, as of the last supervisor pass
+    DEBUG_LOG_MAIN("System health: %s", tasksHealthy ? "OK" : "FAIL");
+    if (!tasksHealthy) {
         taskManager.dumpTaskStatus();
     }
 
@@ -127,13 +273,62 @@ void performSystemHealthCheck() {
                        tempSensor.getCurrentTemp(),
                        tempSensor.getSmoothedTemp());
     }
+    for (uint8_t i = 0; i < static_cast<uint8_t>(TempAcquisition::Phase::COUNT); i++) {
+        TempAcquisition::Phase phase = static_cast<TempAcquisition::Phase>(i);
+        TempAcquisition::Histogram histogram;
+        if (tempSensor.getPhaseHistogram(phase, histogram) && histogram.count > 0) {
+            DEBUG_LOG_MAIN("Temp %s: p50 <%lu us, p99 <%lu us, max %lu us (%lu)",
+                           TempAcquisition::phaseToString(phase),
+                           (unsigned long)histogram.percentileUs(50),
+                           (unsigned long)histogram.percentileUs(99),
+                           (unsigned long)histogram.maxUs,
+                           (unsigned long)histogram.count);
+        }
+    }
 
     // Report fan status
+    FanController::Snapshot fan = fanController.getSnapshot();
     DEBUG_LOG_MAIN("Fan Status: %s", fanController.getStatusString().c_str());
-    DEBUG_LOG_MAIN("Speed: %d%% (Target: %d%%), RPM: %d",
-                   fanController.getCurrentSpeed(),
-                   fanController.getTargetSpeed(),
-                   fanController.getMeasuredRPM());
+    for (uint8_t channel = 0; channel < fanController.getChannelCount(); channel++) {
+        DEBUG_LOG_MAIN("Fan %d Speed: %d%% (Target: %d%%), RPM: %d",
+                       channel,
+                       fan.currentSpeed[channel],
+                       fan.targetSpeed[channel],
+                       fan.measuredRPM[channel]);
+    }
+    if (fan.latency.count > 0) {
+        DEBUG_LOG_MAIN("Fan response: last %lu us, mean %lu us, max %lu us (%lu readings)",
+                       (unsigned long)fan.latency.lastUs,
+                       (unsigned long)(fan.latency.totalUs / fan.latency.count),
+                       (unsigned long)fan.latency.maxUs,
+                       (unsigned long)fan.latency.count);
+    }
+
+    // Report CPU load, of the last complete window
+    static CpuMonitor::Snapshot cpu;
+    if (cpuMonitor.getSnapshot(cpu)) {
+        for (uint8_t core = 0; core < portNUM_PROCESSORS; core++) {
+            DEBUG_LOG_MAIN("Core %d load: %.1f%%", core, cpu.corePercent[core]);
+        }
+        for (uint8_t i = 0, shown = 0; i < cpu.taskCount && shown < 5; i++) {
+            if (cpu.tasks[i].idle) continue;
+            DEBUG_LOG_MAIN("  %-16s %5.1f%%", cpu.tasks[i].name, cpu.tasks[i].percent);
+            shown++;
+        }
+    }
+
+    // Report executor jobs, cumulative since boot
+    CooperativeExecutor::JobStats jobs[CooperativeExecutor::MAX_JOBS];
+    size_t jobCount = executor.getJobStats(jobs, CooperativeExecutor::MAX_JOBS);
+    for (size_t i = 0; i < jobCount; i++) {
+        DEBUG_LOG_MAIN("Job %-6s runs %lu (%lu notified), exec mean %lu us, max %lu us, late max %lu us",
+                       jobs[i].name,
+                       (unsigned long)jobs[i].runs,
+                       (unsigned long)jobs[i].notifiedRuns,
+                       (unsigned long)jobs[i].meanExecUs,
+                       (unsigned long)jobs[i].maxExecUs,
+                       (unsigned long)jobs[i].maxLateUs);
+    }
 
     // Report network service status
     DEBUG_LOG_MAIN("MQTT Status: %s", 
@@ -1,5 +1,7 @@
 // mqtt_manager.cpp
 #include "mqtt_manager.h"
+#include "history_store.h"
+#include "cpu_monitor.h"
 
 /*******************************************************************************
  * Construction / Destruction
@@ -11,6 +13,8 @@ MqttManager::MqttManager(TaskManager& tm, TempSensor& ts, FanController& fc)
     : taskManager(tm)
     , tempSensor(ts)
     , fanController(fc)
+    , historyStore(nullptr)
+    , cpuMonitor(nullptr)
     , mqttClient(wifiClient)
     , connectionMutex(nullptr)
     , messageMutex(nullptr)
@@ -70,9 +74,14 @@ esp_err_t MqttManager::begin() {
     TaskManager::TaskConfig taskConfig("MQTT", 
                                        Config::MQTT::Task::STACK_SIZE, 
                                        Config::MQTT::Task::TASK_PRIORITY, 
-                                       Config::MQTT::Task::TASK_CORE);
+                                       Config::MQTT::Task::TASK_CORE,
+                                       Config::MQTT::Task::PERIOD_MS,
+                                       Config::MQTT::Task::DEADLINE_MS,
+                                       Config::MQTT::Task::POLICY,
+                                       Config::MQTT::Task::WATCHDOG,
+                                       Config::MQTT::Task::MEMORY);
     DEBUG_LOG_MQTT("Creating MQTT task...");
-    esp_err_t err = taskManager.createTask(taskConfig, mqttTask, this);
+    esp_err_t err = taskManager.createTask(taskConfig, mqttTask, this, &taskId);
     
     if (err != ESP_OK) {
         DEBUG_LOG_MQTT("Failed to create MQTT task: %d", err);
@@ -199,6 +208,11 @@ bool MqttManager::setupSubscriptions() {
     success &= mqttClient.subscribe(Config::MQTT::Topics::Control::NIGHT_MODE);
     success &= mqttClient.subscribe(Config::MQTT::Topics::Control::NIGHT_SETTINGS);
     success &= mqttClient.subscribe(Config::MQTT::Topics::Control::RECOVERY);
+    success &= mqttClient.subscribe(Config::MQTT::Topics::Control::PID);
+    success &= mqttClient.subscribe(Config::MQTT::Topics::Control::CALIBRATION);
+    success &= mqttClient.subscribe(Config::MQTT::Topics::Control::FAN_WILDCARD);
+    success &= mqttClient.subscribe(Config::MQTT::Topics::Control::HISTORY);
+    success &= mqttClient.subscribe(Config::MQTT::Topics::Control::TIMING);
     
     DEBUG_LOG_MQTT("Subscriptions setup %s", success ? "successful" : "failed");
     return success;
@@ -323,7 +337,8 @@ void MqttManager::handleMessage(const char* topic, const byte* payload, unsigned
     }
 
     // Determine the message type and required action outside the critical section
-    MessageAction action = determineMessageAction(topic);
+    uint8_t channel = 0;
+    MessageAction action = determineMessageAction(topic, channel);
     if (action == MessageAction::INVALID) {
         DEBUG_LOG_MQTT("Invalid message action for topic: %s", topic);
         return;
@@ -368,6 +383,30 @@ void MqttManager::handleMessage(const char* topic, const byte* payload, unsigned
                 needsUpdate = success;
                 break;
 
+            case MessageAction::PID:
+                success = handlePidMessage(doc);
+                needsUpdate = success;
+                break;
+
+            case MessageAction::CALIBRATION:
+                success = handleCalibrationMessage(doc);
+                needsUpdate = success;
+                break;
+
+            case MessageAction::FAN_CHANNEL:
+                success = handleFanChannelMessage(doc, channel);
+                needsUpdate = success;
+                break;
+
+            case MessageAction::HISTORY:
+                // Answered on its own topic, no state changed
+                success = handleHistoryMessage(doc);
+                break;
+
+            case MessageAction::TIMING:
+                success = handleTimingMessage(doc);
+                break;
+
             default:
                 DEBUG_LOG_MQTT("Unhandled message action");
                 break;
@@ -394,7 +433,7 @@ void MqttManager::handleMessage(const char* topic, const byte* payload, unsigned
 
 
 // Helper method to determine message action from topic
-MqttManager::MessageAction MqttManager::determineMessageAction(const char* topic) {
+MqttManager::MessageAction MqttManager::determineMessageAction(const char* topic, uint8_t& channel) {
     if (strcmp(topic, Config::MQTT::Topics::Control::MODE) == 0) {
         return MessageAction::MODE;
     }
@@ -407,6 +446,31 @@ MqttManager::MessageAction MqttManager::determineMessageAction(const char* topic
     else if (strcmp(topic, Config::MQTT::Topics::Control::NIGHT_SETTINGS) == 0) {
         return MessageAction::NIGHT_SETTINGS;
     }
+    else if (strcmp(topic, Config::MQTT::Topics::Control::PID) == 0) {
+        return MessageAction::PID;
+    }
+    else if (strcmp(topic, Config::MQTT::Topics::Control::CALIBRATION) == 0) {
+        return MessageAction::CALIBRATION;
+    }
+    else if (strcmp(topic, Config::MQTT::Topics::Control::HISTORY) == 0) {
+        return MessageAction::HISTORY;
+    }
+    else if (strcmp(topic, Config::MQTT::Topics::Control::TIMING) == 0) {
+        return MessageAction::TIMING;
+    }
+    else if (strncmp(topic, Config::MQTT::Topics::Control::FAN_PREFIX,
+                     strlen(Config::MQTT::Topics::Control::FAN_PREFIX)) == 0) {
+        // control/fan/<n>/set, the channel must be a plain decimal index
+        const char* index = topic + strlen(Config::MQTT::Topics::Control::FAN_PREFIX);
+        char* end = nullptr;
+        unsigned long value = strtoul(index, &end, 10);
+        if (end != index && isdigit(static_cast<unsigned char>(*index)) &&
+            strcmp(end, Config::MQTT::Topics::Control::FAN_SUFFIX) == 0 &&
+            value < fanController.getChannelCount()) {
+            channel = static_cast<uint8_t>(value);
+            return MessageAction::FAN_CHANNEL;
+        }
+    }
     return MessageAction::INVALID;
 }
 
@@ -478,15 +542,217 @@ bool MqttManager::handleNightSettingsMessage(const JsonDocument& doc) {
     int endHour = doc["end_hour"];
     int maxSpeed = doc["max_speed"];
 
+    // Minutes are optional and default to the full hour
+    int startMinute = doc["start_minute"].is<int>() ? doc["start_minute"].as<int>() : 0;
+    int endMinute = doc["end_minute"].is<int>() ? doc["end_minute"].as<int>() : 0;
+
     // Validate ranges
     if (startHour < 0 || startHour > 23 || 
         endHour < 0 || endHour > 23 || 
+        startMinute < 0 || startMinute > 59 ||
+        endMinute < 0 || endMinute > 59 ||
         maxSpeed < 0 || maxSpeed > 100) {
         DEBUG_LOG_MQTT("Night settings values out of range");
         return false;
     }
 
-    return fanController.setNightSettings(startHour, endHour, maxSpeed);
+    return fanController.setNightSettings(startHour, startMinute, endHour, endMinute, maxSpeed);
+}
+
+bool MqttManager::handlePidMessage(const JsonDocument& doc) {
+    DEBUG_LOG_MQTT("Processing PID message");
+
+    // Gains are required, the setpoint is optional
+    if (!doc["kp"].is<float>() || 
+        !doc["ki"].is<float>() || 
+        !doc["kd"].is<float>()) {
+        DEBUG_LOG_MQTT("PID message missing required fields");
+        return false;
+    }
+
+    PidController::Gains gains;
+    gains.kp = doc["kp"];
+    gains.ki = doc["ki"];
+    gains.kd = doc["kd"];
+
+    float target = doc["target"].is<float>() 
+        ? doc["target"].as<float>() 
+        : fanController.getTargetTemperature();
+
+    return fanController.setPidTuning(gains, target);
+}
+
+bool MqttManager::handleCalibrationMessage(const JsonDocument& doc) {
+    DEBUG_LOG_MQTT("Processing calibration message");
+
+    if (!doc["action"].is<const char*>()) {
+        DEBUG_LOG_MQTT("Calibration message missing or invalid 'action' field");
+        return false;
+    }
+
+    // Fan 0 unless a channel is given
+    int channel = doc["channel"].is<int>() ? doc["channel"].as<int>() : 0;
+    if (channel < 0 || channel >= fanController.getChannelCount()) {
+        DEBUG_LOG_MQTT("Calibration message channel %d out of range", channel);
+        return false;
+    }
+
+    const char* action = doc["action"];
+    if (strcmp(action, "start") == 0) {
+        return fanController.startCalibration(channel);
+    }
+    else if (strcmp(action, "abort") == 0) {
+        return fanController.abortCalibration();
+    }
+    else if (strcmp(action, "reset") == 0) {
+        return fanController.resetCalibration(channel);
+    }
+    return false;
+}
+
+bool MqttManager::handleHistoryMessage(const JsonDocument& doc) {
+    DEBUG_LOG_MQTT("Processing history query");
+
+    if (!historyStore || !historyStore->isReady()) {
+        DEBUG_LOG_MQTT("History query without a history store");
+        return false;
+    }
+
+    HistoryStore::Tier tier = HistoryStore::Tier::RAW;
+    if (doc["tier"].is<const char*>() &&
+        !HistoryStore::tierFromString(doc["tier"].as<const char*>(), tier)) {
+        DEBUG_LOG_MQTT("History query with unknown tier");
+        return false;
+    }
+
+    // "temperature", or "rpm" of the fan given by "channel" (default 0)
+    const char* seriesName = doc["series"].is<const char*>() ? doc["series"].as<const char*>() : "temperature";
+    int channel = doc["channel"].is<int>() ? doc["channel"].as<int>() : 0;
+    uint8_t series;
+    if (strcmp(seriesName, "temperature") == 0) {
+        series = HistoryStore::SERIES_TEMPERATURE;
+    } else if (strcmp(seriesName, "rpm") == 0 && channel >= 0 && channel < fanController.getChannelCount()) {
+        series = HistoryStore::rpmSeries(channel);
+    } else {
+        DEBUG_LOG_MQTT("History query with unknown series %s", seriesName);
+        return false;
+    }
+
+    // Newest points first within the look-back window, default one reply's worth
+    size_t maxPoints = Config::History::QUERY_MAX_POINTS;
+    if (doc["points"].is<int>() && doc["points"].as<int>() > 0) {
+        maxPoints = min(static_cast<size_t>(doc["points"].as<int>()), maxPoints);
+    }
+    uint32_t periodS = HistoryStore::tierPeriodS(tier);
+    uint32_t seconds = doc["seconds"].is<uint32_t>() ? doc["seconds"].as<uint32_t>() : maxPoints * periodS;
+    uint32_t nowS = HistoryStore::nowS();
+    uint32_t fromS = seconds < nowS ? nowS - seconds : 0;
+
+    HistoryStore::Point points[Config::History::QUERY_MAX_POINTS];
+    size_t count = historyStore->query(tier, series, fromS, nowS, points, maxPoints);
+
+    JsonDocument reply;
+    reply["series"] = seriesName;
+    if (series != HistoryStore::SERIES_TEMPERATURE) {
+        reply["channel"] = channel;
+    }
+    reply["tier"] = HistoryStore::tierToString(tier);
+    reply["period"] = periodS;
+    reply["now"] = nowS;
+
+    // [time, min, avg, max], time in seconds since boot
+    JsonArray data = reply["points"].to<JsonArray>();
+    for (size_t i = 0; i < count; i++) {
+        JsonArray point = data.add<JsonArray>();
+        point.add(points[i].timeS);
+        point.add(points[i].min);
+        point.add(points[i].avg);
+        point.add(points[i].max);
+    }
+
+    return publishLargeJson(Config::MQTT::Topics::Status::HISTORY, reply);
+}
+
+bool MqttManager::handleTimingMessage(const JsonDocument& doc) {
+    DEBUG_LOG_MQTT("Processing timing query");
+
+    // Every task, or only the one given by "task"; "reset" starts a new window
+    const char* taskName = doc["task"].is<const char*>() ? doc["task"].as<const char*>() : nullptr;
+    bool reset = doc["reset"].is<bool>() && doc["reset"].as<bool>();
+
+    TaskManager::TaskTiming timing[Config::TaskManager::MAX_TASKS];
+    size_t count = taskManager.getTaskTiming(timing, Config::TaskManager::MAX_TASKS, reset);
+
+    JsonDocument reply;
+    JsonArray tasks = reply["tasks"].to<JsonArray>();
+    for (size_t i = 0; i < count; i++) {
+        const TaskManager::TaskTiming& entry = timing[i];
+        if (taskName && strcmp(taskName, entry.name) != 0) continue;
+
+        JsonObject task = tasks.add<JsonObject>();
+        task["name"] = entry.name;
+        task["period_ms"] = entry.periodMs;
+
+        // Microseconds, percentiles as bucket upper bounds
+        const TaskManager::Percentiles* histograms[] = {&entry.period, &entry.execution};
+        const char* keys[] = {"period", "exec"};
+        for (uint8_t j = 0; j < 2; j++) {
+            JsonObject values = task[keys[j]].to<JsonObject>();
+            values["count"] = histograms[j]->count;
+            values["p50"] = histograms[j]->p50Us;
+            values["p95"] = histograms[j]->p95Us;
+            values["p99"] = histograms[j]->p99Us;
+            values["max"] = histograms[j]->maxUs;
+        }
+    }
+    reply["reset"] = reset;
+
+    if (taskName && tasks.size() == 0) {
+        DEBUG_LOG_MQTT("Timing query for unknown task %s", taskName);
+        return false;
+    }
+
+    return publishLargeJson(Config::MQTT::Topics::Status::TIMING, reply);
+}
+
+bool MqttManager::handleFanChannelMessage(const JsonDocument& doc, uint8_t channel) {
+    DEBUG_LOG_MQTT("Processing message for fan %d", channel);
+
+    // Every field is optional, at least one has to be valid
+    bool handled = false;
+    bool success = true;
+
+    if (doc["speed"].is<int>()) {
+        int speed = doc["speed"];
+        if (speed < 0 || speed > 100) {
+            DEBUG_LOG_MQTT("Fan %d speed %d out of range", channel, speed);
+            return false;
+        }
+        success &= fanController.setSpeedDutyCycle(channel, speed);
+        handled = true;
+    }
+
+    if (doc["recover"].is<bool>() && doc["recover"].as<bool>()) {
+        success &= fanController.attemptRecovery(channel);
+        handled = true;
+    }
+
+    if (doc["calibration"].is<const char*>()) {
+        const char* action = doc["calibration"];
+        if (strcmp(action, "start") == 0) {
+            success &= fanController.startCalibration(channel);
+        } else if (strcmp(action, "reset") == 0) {
+            success &= fanController.resetCalibration(channel);
+        } else {
+            success = false;
+        }
+        handled = true;
+    }
+
+    if (!handled) {
+        DEBUG_LOG_MQTT("Fan %d message has no valid field", channel);
+    }
+    return handled && success;
 }
 
 /*******************************************************************************
@@ -520,17 +786,24 @@ void MqttManager::publishStatus() {
         return;
     }
 
+    // One consistent view of the fan for all documents
+    FanController::Snapshot fan = fanController.getSnapshot();
+
     // System status document
     JsonDocument systemDoc;
     {
-        auto status = fanController.getStatus();
-        systemDoc["state"] = status == FanController::Status::OK ? "on" : "off";
-        systemDoc["speed"] = fanController.getCurrentSpeed();
-        systemDoc["mode"] = fanController.getControlMode() == FanController::Mode::AUTO ? "auto" : "manual";
+        auto status = fan.status;
+        bool running = status == FanController::Status::OK || 
+                       status == FanController::Status::CALIBRATING;
+        systemDoc["state"] = running ? "on" : "off";
+        systemDoc["speed"] = fan.currentSpeed[0];
+        systemDoc["fans"] = fanController.getChannelCount();
+        systemDoc["mode"] = fan.mode == FanController::Mode::AUTO ? "auto" : "manual";
         systemDoc["temperature"] = tempSensor.getSmoothedTemp();
+        systemDoc["trend"] = tempSensor.getTrend();     // °C/min
         
         // Add error information if applicable
-        if (status != FanController::Status::OK) {
+        if (!running) {
             systemDoc["error"] = getFanStatusString(status);
         }
     }
@@ -538,20 +811,213 @@ void MqttManager::publishStatus() {
     // Night mode status document
     JsonDocument nightDoc;
     {
-        nightDoc["enabled"] = fanController.isNightModeEnabled();
-        nightDoc["active"] = fanController.isNightModeActive();
-        nightDoc["start_hour"] = fanController.getNightStartHour();
-        nightDoc["end_hour"] = fanController.getNightEndHour();
-        nightDoc["max_speed"] = fanController.getNightMaxSpeed();
+        nightDoc["enabled"] = fan.nightModeEnabled;
+        nightDoc["active"] = fan.nightModeActive;
+        nightDoc["start_hour"] = fan.nightStartHour;
+        nightDoc["start_minute"] = fan.nightStartMinute;
+        nightDoc["end_hour"] = fan.nightEndHour;
+        nightDoc["end_minute"] = fan.nightEndMinute;
+        nightDoc["max_speed"] = fan.nightMaxSpeed;
+        if (fan.nightModeEnabled && fan.nightTransition > 0) {
+            nightDoc["next_transition"] = static_cast<int64_t>(fan.nightTransition);
+        }
+    }
+
+    // PID tuning document
+    JsonDocument pidDoc;
+    {
+        pidDoc["kp"] = fan.pidGains.kp;
+        pidDoc["ki"] = fan.pidGains.ki;
+        pidDoc["kd"] = fan.pidGains.kd;
+        pidDoc["feed_forward"] = fan.feedForward;
+        pidDoc["target"] = fan.targetTemp;
+    }
+
+    // Calibration document
+    JsonDocument calibrationDoc;
+    {
+        FanController::CalibrationReport report = fanController.getCalibrationReport();
+        calibrationDoc["channel"] = report.runChannel;
+        calibrationDoc["phase"] = FanCalibrator::phaseToString(report.phase);
+        calibrationDoc["progress"] = report.progress;
+        calibrationDoc["calibrated"] = report.calibrated;
+        if (report.calibrated) {
+            calibrationDoc["min_start_pwm"] = report.active.minStartPWM;
+            calibrationDoc["stall_pwm"] = report.active.stallPWM;
+            calibrationDoc["max_rpm"] = report.active.maxRPM;
+            JsonArray points = calibrationDoc["points"].to<JsonArray>();
+            for (uint8_t i = 0; i < report.active.count; i++) {
+                JsonArray point = points.add<JsonArray>();
+                point.add(report.active.points[i].speed);
+                point.add(report.active.points[i].pwm);
+            }
+        }
     }
 
-    // Publish both status documents
+    // Publish all status documents
     bool systemPublished = publishJson(Config::MQTT::Topics::Status::SYSTEM, systemDoc);
     bool nightPublished = publishJson(Config::MQTT::Topics::Status::NIGHT_MODE, nightDoc);
-
-    DEBUG_LOG_MQTT("Status published - System: %s, Night Mode: %s",
+    bool pidPublished = publishJson(Config::MQTT::Topics::Status::PID, pidDoc);
+    bool calibrationPublished = publishJson(Config::MQTT::Topics::Status::CALIBRATION, calibrationDoc);
+    bool fansPublished = publishFanChannels(fan);
+    bool sensorsPublished = publishSensors();
+    bool cpuPublished = publishCpuUsage();
+    bool stacksPublished = publishStackUsage();
+
+    DEBUG_LOG_MQTT("Status published - System: %s, Night Mode: %s, PID: %s, Calibration: %s, Fans: %s, Sensors: %s, CPU: %s, Stacks: %s",
               systemPublished ? "success" : "failed",
-              nightPublished ? "success" : "failed");
+              nightPublished ? "success" : "failed",
+              pidPublished ? "success" : "failed",
+              calibrationPublished ? "success" : "failed",
+              fansPublished ? "success" : "failed",
+              sensorsPublished ? "success" : "failed",
+              cpuPublished ? "success" : "failed",
+              stacksPublished ? "success" : "failed");
+}
+
+bool MqttManager::publishFanChannels(const FanController::Snapshot& fan) {
+    bool success = true;
+    char topic[Config::MQTT::Message::MAX_TOPIC_LENGTH];
+
+    for (uint8_t channel = 0; channel < fanController.getChannelCount(); channel++) {
+        FanController::Status status = fan.channelStatus[channel];
+        bool running = status == FanController::Status::OK ||
+                       status == FanController::Status::CALIBRATING;
+
+        JsonDocument fanDoc;
+        fanDoc["state"] = running ? "on" : "off";
+        fanDoc["speed"] = fan.currentSpeed[channel];
+        fanDoc["target"] = fan.targetSpeed[channel];
+        fanDoc["rpm"] = fan.measuredRPM[channel];
+        fanDoc["pwm"] = fan.appliedPWM[channel];
+        fanDoc["calibrated"] = fanController.getCalibrationReport(channel).calibrated;
+        if (fan.expectedRPM[channel] > 0) {
+            fanDoc["expected_rpm"] = fan.expectedRPM[channel];
+        }
+        if (!running) {
+            fanDoc["error"] = getFanStatusString(status);
+        }
+
+        // Stall recovery progress
+        if (fan.recovery[channel] != FanController::Recovery::NONE) {
+            fanDoc["recovery"] = FanController::recoveryToString(fan.recovery[channel]);
+        }
+        if (fan.fault[channel] != FanController::Fault::NONE) {
+            fanDoc["fault"] = FanController::faultToString(fan.fault[channel]);
+        }
+        if (fan.stallRetries[channel] > 0) {
+            fanDoc["retries"] = fan.stallRetries[channel];
+        }
+        if (fan.recovery[channel] == FanController::Recovery::BACKOFF) {
+            int32_t remaining = static_cast<int32_t>(fan.retryAtMs[channel] - millis());
+            fanDoc["retry_in"] = remaining > 0 ? (remaining + 999) / 1000 : 0;
+        }
+
+        snprintf(topic, sizeof(topic), Config::MQTT::Topics::Status::FAN_FORMAT, channel);
+        success &= publishJson(topic, fanDoc);
+    }
+    return success;
+}
+
+bool MqttManager::publishSensors() {
+    JsonDocument sensorsDoc;
+    sensorsDoc["control"] = tempSensor.getCurrentTemp();
+    sensorsDoc["resolution"] = tempSensor.getResolution();
+    sensorsDoc["interval_ms"] = tempSensor.getSampleIntervalMs();
+    sensorsDoc["source"] = tempSensor.getSourceName();
+
+    uint32_t reads, lastMissed, maxMissed, totalMissed;
+    if (tempSensor.getTachLoss(reads, lastMissed, maxMissed, totalMissed)) {
+        JsonObject tachLoss = sensorsDoc["tach_loss"].to<JsonObject>();
+        tachLoss["reads"] = reads;
+        tachLoss["last"] = lastMissed;
+        tachLoss["max"] = maxMissed;
+        tachLoss["total"] = totalMissed;
+    }
+
+    // IDs are ROM codes, stable across reboots and rewiring
+    JsonArray sensors = sensorsDoc["sensors"].to<JsonArray>();
+    TemperatureSource::Reading reading;
+    for (uint8_t i = 0; i < tempSensor.getSensorCount(); i++) {
+        if (!tempSensor.getSensorReading(i, reading)) continue;
+
+        JsonObject sensor = sensors.add<JsonObject>();
+        sensor["id"] = reading.id;
+        sensor["temp"] = reading.tempC;
+        sensor["ok"] = reading.valid;
+    }
+
+    return publishJson(Config::MQTT::Topics::Status::SENSORS, sensorsDoc);
+}
+
+bool MqttManager::publishCpuUsage() {
+    CpuMonitor::Snapshot usage;
+    if (!cpuMonitor || !cpuMonitor->getSnapshot(usage)) {
+        return true;    // Nothing to report yet
+    }
+
+    JsonDocument cpuDoc;
+    cpuDoc["window_ms"] = usage.windowMs;
+
+    // Load of each core, 100 minus its IDLE task
+    JsonArray cores = cpuDoc["cores"].to<JsonArray>();
+    for (uint8_t core = 0; core < portNUM_PROCESSORS; core++) {
+        cores.add(roundf(usage.corePercent[core] * 10.0f) / 10.0f);
+    }
+
+    // Busiest first, percent of one core; core -1 runs on either
+    JsonArray tasks = cpuDoc["tasks"].to<JsonArray>();
+    for (uint8_t i = 0; i < usage.taskCount; i++) {
+        const CpuMonitor::TaskUsage& task = usage.tasks[i];
+        JsonObject entry = tasks.add<JsonObject>();
+        entry["name"] = task.name;
+        entry["core"] = task.core;
+        entry["cpu"] = roundf(task.percent * 10.0f) / 10.0f;
+    }
+
+    // A couple of dozen tasks exceed the client buffer
+    return publishLargeJson(Config::MQTT::Topics::Status::CPU, cpuDoc);
+}
+
+bool MqttManager::publishStackUsage() {
+    TaskManager::StackUsage usage[Config::TaskManager::MAX_TASKS];
+    size_t count = taskManager.getStackUsage(usage, Config::TaskManager::MAX_TASKS);
+    if (!count) {
+        return true;    // Nothing to report yet
+    }
+
+    JsonDocument stackDoc;
+    uint32_t reclaimable = 0;
+    JsonArray tasks = stackDoc["tasks"].to<JsonArray>();
+    for (size_t i = 0; i < count; i++) {
+        const TaskManager::StackUsage& entry = usage[i];
+        JsonObject task = tasks.add<JsonObject>();
+        task["name"] = entry.name;
+        task["size"] = entry.size;
+        task["peak"] = entry.peak;
+        task["recommended"] = entry.recommended;
+        reclaimable += entry.reclaimable();
+    }
+    stackDoc["reclaimable"] = reclaimable;
+
+    return publishLargeJson(Config::MQTT::Topics::Status::STACKS, stackDoc);
+}
+
+bool MqttManager::publishLargeJson(const char* topic, const JsonDocument& doc) {
+    if (!mqttClient.connected()) {
+        return false;
+    }
+
+    // Streamed to the socket, not limited by the client buffer
+    size_t length = measureJson(doc);
+    if (!mqttClient.beginPublish(topic, length, false)) {
+        return false;
+    }
+    serializeJson(doc, mqttClient);
+    bool success = mqttClient.endPublish();
+    DEBUG_LOG_MQTT("Published %u bytes to %s (%s)", (unsigned)length, topic, success ? "success" : "failed");
+
+    return success;
 }
 
 bool MqttManager::publishJson(const char* topic, const JsonDocument& doc) {
@@ -577,8 +1043,9 @@ void MqttManager::mqttTask(void* parameters) {
     DEBUG_LOG_MQTT("MQTT Task started");
     
     while (true) {
-        mqtt->taskManager.updateTaskRunTime("MQTT");
+        mqtt->taskManager.heartbeat(mqtt->taskId);
         mqtt->processUpdate();
+        mqtt->taskManager.workDone(mqtt->taskId);
         
         // Use shorter delay when messages are being processed
         if (uxQueueMessagesWaiting(mqtt->messageQueue) > 0) {
@@ -617,6 +1084,8 @@ const char* MqttManager::getFanStatusString(FanController::Status status) {
             return "general_error";
         case FanController::Status::SHUTOFF:
             return "fan_stalled";
+        case FanController::Status::CALIBRATING:
+            return "calibrating";
         default:
             return "unknown_error";
     }
@@ -13,6 +13,10 @@
 #include "fan_controller.h"
 #include "mutex_guard.h"
 
+// Forward declarations
+class HistoryStore;
+class CpuMonitor;
+
 /**
  * @brief MQTT communication manager for IoT device control
  * 
@@ -39,7 +43,12 @@ public:
         MODE,
         NIGHT_MODE,
         RECOVERY,
-        NIGHT_SETTINGS
+        NIGHT_SETTINGS,
+        PID,
+        CALIBRATION,
+        FAN_CHANNEL,
+        HISTORY,
+        TIMING
     };
 
     /**
@@ -79,11 +88,20 @@ public:
 
     uint32_t getTotalTimeout();
 
+    // Optional, history queries are rejected until registered
+    void registerHistoryStore(HistoryStore* store) { historyStore = store; }
+
+    // Optional, CPU utilization is published once registered
+    void registerCpuMonitor(CpuMonitor* monitor) { cpuMonitor = monitor; }
+
 private:
     // Core components
     TaskManager& taskManager;
+    TaskManager::TaskId taskId;
     TempSensor& tempSensor;
     FanController& fanController;
+    HistoryStore* historyStore;
+    CpuMonitor* cpuMonitor;
     WiFiClient wifiClient;
     PubSubClient mqttClient;
     static MqttManager* instance;
@@ -120,13 +138,23 @@ private:
     bool handleNightModeMessage(const JsonDocument& doc);
     bool handleRecoveryMessage(const JsonDocument& doc);
     bool handleNightSettingsMessage(const JsonDocument& doc);
+    bool handlePidMessage(const JsonDocument& doc);
+    bool handleCalibrationMessage(const JsonDocument& doc);
+    bool handleFanChannelMessage(const JsonDocument& doc, uint8_t channel);
+    bool handleHistoryMessage(const JsonDocument& doc);
+    bool handleTimingMessage(const JsonDocument& doc);
     void processQueuedMessages();
     bool enqueueMessage(const char* topic, const byte* payload, unsigned int length);
-    MessageAction determineMessageAction(const char* topic);
+    MessageAction determineMessageAction(const char* topic, uint8_t& channel);
 
     // Publication methods
     void publishString(const char* topic, const String& value);
     bool publishJson(const char* topic, const JsonDocument& doc);
+    bool publishFanChannels(const FanController::Snapshot& fan);
+    bool publishSensors();
+    bool publishCpuUsage();
+    bool publishStackUsage();
+    bool publishLargeJson(const char* topic, const JsonDocument& doc);
     const char* getFanStatusString(FanController::Status status);
 
     // Utility methods
@@ -1,4 +1,5 @@
 #include "ntp_manager.h"
+#include "cooperative_executor.h"
 #include <sys/time.h>
 
 /*******************************************************************************
@@ -7,12 +8,14 @@
 
 NTPManager::NTPManager(TaskManager& tm)
     : taskManager(tm)
+    , executor(nullptr)
     , mutex(xSemaphoreCreateMutex())
     , initialized(false)
     , timeSynchronized(false)
     , lastSyncTime(0)
     , lastSyncEpoch(0)
     , syncAttempts(0)
+    , syncCount(0)
 {
     if (!mutex) {
         DEBUG_LOG_NTP("NTPManager - Mutex creation failed!");
@@ -52,12 +55,30 @@ esp_err_t NTPManager::begin() {
     setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
     tzset();
 
+    // As a job, processUpdate() also makes the first sync
+    if (executor) {
+        esp_err_t err = executor->addJob("NTP", ntpJob, this, Config::NTP::START_DELAY_MS);
+        if (err != ESP_OK) {
+            DEBUG_LOG_NTP("Failed to add NTP job: %d", err);
+            return err;
+        }
+
+        initialized = true;
+        DEBUG_LOG_NTP("NTP Manager initialized as executor job");
+        return ESP_OK;
+    }
+
     // Create background task
     TaskManager::TaskConfig taskConfig("NTP", 
                                        Config::NTP::Task::STACK_SIZE, 
                                        Config::NTP::Task::TASK_PRIORITY, 
-                                       Config::NTP::Task::TASK_CORE);
-    esp_err_t err = taskManager.createTask(taskConfig, ntpTask, this);
+                                       Config::NTP::Task::TASK_CORE,
+                                       Config::NTP::Task::PERIOD_MS,
+                                       Config::NTP::Task::DEADLINE_MS,
+                                       Config::NTP::Task::POLICY,
+                                       Config::NTP::Task::WATCHDOG,
+                                       Config::NTP::Task::MEMORY);
+    esp_err_t err = taskManager.createTask(taskConfig, ntpTask, this, &taskId);
     
     if (err != ESP_OK) {
         DEBUG_LOG_NTP("Failed to create NTP task: %d", err);
@@ -98,19 +119,21 @@ void NTPManager::processUpdate() {
             
             DEBUG_LOG_NTP("Starting NTP sync attempt %d/%d", 
                         syncAttempts, Config::NTP::MAX_SYNC_ATTEMPTS);
-            
-            struct tm timeinfo;
-            if (getLocalTime(&timeinfo, Config::NTP::SYNC_TIMEOUT_MS)) {
-                lastSyncTime = currentTime;
-                time(&lastSyncEpoch);
-                timeSynchronized = true;
-                attemptInProgress = false;
-                syncAttempts = 0; // Reset on success
-                
-                char timeStr[32];
-                strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", &timeinfo);
-                DEBUG_LOG_NTP("Time synchronized successfully: %s", timeStr);
-            }
+        }
+
+        // Polled without blocking, every update until the attempt times out
+        struct tm timeinfo;
+        if (attemptInProgress && getLocalTime(&timeinfo, 0)) {
+            lastSyncTime = currentTime;
+            time(&lastSyncEpoch);
+            timeSynchronized = true;
+            syncCount.fetch_add(1, std::memory_order_release);
+            attemptInProgress = false;
+            syncAttempts = 0; // Reset on success
+
+            char timeStr[32];
+            strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", &timeinfo);
+            DEBUG_LOG_NTP("Time synchronized successfully: %s", timeStr);
         }
         
         // Check if current attempt has timed out
@@ -157,6 +180,7 @@ if (success) {
     lastSyncTime = millis();
     time(&lastSyncEpoch);
     timeSynchronized = true;
+    syncCount.fetch_add(1, std::memory_order_release);
     syncAttempts = 0; // Reset on success
     
     char timeStr[32];
@@ -228,7 +252,7 @@ void NTPManager::ntpTask(void* parameters) {
     DEBUG_LOG_NTP("NTP task started");
     
     // Initial delay to allow WiFi to connect
-    vTaskDelay(pdMS_TO_TICKS(5000));
+    vTaskDelay(pdMS_TO_TICKS(Config::NTP::START_DELAY_MS));
     
     // Initial sync attempt
     if (!ntp->syncTime()) {
@@ -236,8 +260,14 @@ void NTPManager::ntpTask(void* parameters) {
     }
     
     while (true) {
-        ntp->taskManager.updateTaskRunTime("NTP");
+        ntp->taskManager.heartbeat(ntp->taskId);
         ntp->processUpdate();
+        ntp->taskManager.workDone(ntp->taskId);
         vTaskDelay(pdMS_TO_TICKS(100));
     }
+}
+
+uint32_t NTPManager::ntpJob(void* parameters) {
+    static_cast<NTPManager*>(parameters)->processUpdate();
+    return Config::NTP::Task::PERIOD_MS;
 }
\ No newline at end of file
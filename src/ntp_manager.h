@@ -2,6 +2,7 @@
 #define NTP_MANAGER_H
 
 #include <Arduino.h>
+#include <atomic>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
@@ -10,6 +11,8 @@
 #include "task_manager.h"
 #include "mutex_guard.h"
 
+class CooperativeExecutor;
+
 /**
  * @brief Manages NTP time synchronization for the system
  * 
@@ -18,6 +21,7 @@
  * - Retry mechanism with exponential backoff
  * - Thread-safe time access
  * - Timezone and DST handling
+ * - Own task, or a job of the cooperative executor
  */
 class NTPManager {
 public:
@@ -38,9 +42,23 @@ public:
      */
     esp_err_t begin();
 
+    /**
+     * @brief Run as a job of the executor instead of a task of its own;
+     * call before begin()
+     */
+    void registerExecutor(CooperativeExecutor* jobExecutor) { executor = jobExecutor; }
+
     // Time management
     int getCurrentHour() const;
     bool isTimeSynchronized() const;
+
+    /**
+     * @brief Number of successful synchronizations, lock-free
+     *
+     * Lets clients cache values derived from the wall clock and recompute
+     * them only when the clock may have been stepped.
+     */
+    uint32_t getSyncCount() const { return syncCount.load(std::memory_order_acquire); }
     String getTimeString() const;
     bool forceSync();
 
@@ -54,6 +72,8 @@ public:
 private:
     // Core components
     TaskManager& taskManager;
+    TaskManager::TaskId taskId;
+    CooperativeExecutor* executor;
     SemaphoreHandle_t mutex;
     
     // State tracking
@@ -62,6 +82,7 @@ private:
     uint32_t lastSyncTime;
     time_t lastSyncEpoch;
     uint8_t syncAttempts;
+    std::atomic<uint32_t> syncCount;
 
     // Retry mechanism
     bool attemptInProgress;
@@ -70,6 +91,7 @@ private:
 
     // Task management
     static void ntpTask(void* parameters);
+    static uint32_t ntpJob(void* parameters);
     void processUpdate();
     bool syncTime();
 };
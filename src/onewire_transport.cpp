@@ -0,0 +1,94 @@
+/**
+ * @file onewire_transport.cpp
+ * @brief ROM search and CRC shared by the OneWire transports
+ */
+
+#include "onewire_transport.h"
+#include <string.h>
+
+namespace {
+    constexpr uint8_t CMD_SEARCH_ROM = 0xF0;
+}
+
+/*******************************************************************************
+ * ROM Search
+ ******************************************************************************/
+
+void OneWireTransport::resetSearch(SearchState& state) {
+    memset(state.rom, 0, sizeof(state.rom));
+    state.lastDiscrepancy = -1;
+    state.done = false;
+}
+
+bool OneWireTransport::search(SearchState& state, uint8_t* rom) {
+    if (state.done || !reset() || !writeByte(CMD_SEARCH_ROM)) {
+        state.done = true;
+        return false;
+    }
+
+    // Walk the ROM tree bit by bit; at each fork take the branch that
+    // continues the previous path, then the 1 branch at the last fork
+    int8_t discrepancy = -1;
+    for (uint8_t bitIndex = 0; bitIndex < ROM_SIZE * 8; bitIndex++) {
+        bool bit;
+        bool complement;
+        if (!readBit(bit) || !readBit(complement)) {
+            state.done = true;
+            return false;
+        }
+
+        uint8_t& romByte = state.rom[bitIndex / 8];
+        uint8_t mask = 1 << (bitIndex % 8);
+        bool direction;
+
+        if (bit && complement) {
+            // Nobody answered, a device left the bus mid-search
+            state.done = true;
+            return false;
+        } else if (bit != complement) {
+            direction = bit;
+        } else if (bitIndex < state.lastDiscrepancy) {
+            direction = romByte & mask;
+        } else {
+            direction = bitIndex == state.lastDiscrepancy;
+        }
+
+        if (!bit && !complement && !direction) {
+            discrepancy = bitIndex;
+        }
+
+        if (direction) {
+            romByte |= mask;
+        } else {
+            romByte &= ~mask;
+        }
+
+        if (!writeBit(direction)) {
+            state.done = true;
+            return false;
+        }
+    }
+
+    state.lastDiscrepancy = discrepancy;
+    state.done = discrepancy < 0;
+    memcpy(rom, state.rom, ROM_SIZE);
+    return true;
+}
+
+/*******************************************************************************
+ * CRC
+ ******************************************************************************/
+
+uint8_t OneWireTransport::crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    while (length--) {
+        uint8_t value = *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            uint8_t mix = (crc ^ value) & 0x01;
+            crc >>= 1;
+            if (mix) crc ^= 0x8C;
+            value >>= 1;
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Link layer of a OneWire bus
+ *
+ * Implementations generate the reset and bit slots; device commands are
+ * built on top by SensorBus. The backends are BitBangOneWire, which times
+ * the slots on the CPU with interrupts masked, and RmtOneWire, which
+ * hands them to the RMT peripheral.
+ *
+ * ROM search and CRC are implemented once here on top of the bit level
+ * primitives.
+ */
+class OneWireTransport {
+public:
+    static constexpr size_t ROM_SIZE = 8;
+
+    /**
+     * @brief Progress of a ROM search across search() calls
+     */
+    struct SearchState {
+        uint8_t rom[ROM_SIZE];
+        int8_t lastDiscrepancy;     ///< Bit index of the last unexplored branch, -1 for none
+        bool done;
+    };
+
+    virtual ~OneWireTransport() = default;
+
+    virtual bool begin() = 0;
+
+    /**
+     * @brief Reset pulse
+     * @return true if at least one device answered with a presence pulse
+     */
+    virtual bool reset() = 0;
+
+    /**
+     * @brief Write bytes, LSB first
+     * @param holdHigh Drive the line high afterwards to power parasite
+     *                 devices through a conversion, where supported
+     * @return false on a transport failure
+     */
+    virtual bool write(const uint8_t* data, size_t length, bool holdHigh = false) = 0;
+
+    /**
+     * @brief Read bytes, LSB first
+     * @return false on a transport failure
+     */
+    virtual bool read(uint8_t* data, size_t length) = 0;
+
+    virtual bool writeBit(bool bit) = 0;
+    virtual bool readBit(bool& bit) = 0;
+
+    /**
+     * @brief Short name for status reports
+     */
+    virtual const char* getName() const = 0;
+
+    bool writeByte(uint8_t value, bool holdHigh = false) { return write(&value, 1, holdHigh); }
+
+    /**
+     * @brief Start a new ROM search
+     */
+    static void resetSearch(SearchState& state);
+
+    /**
+     * @brief Find the next device on the bus
+     * @param rom Receives its ROM code, unchecked; verify with crc8()
+     * @return false once every device was found or the bus failed
+     */
+    bool search(SearchState& state, uint8_t* rom);
+
+    /**
+     * @brief Dallas/Maxim CRC-8 (x^8 + x^5 + x^4 + 1)
+     */
+    static uint8_t crc8(const uint8_t* data, size_t length);
+};
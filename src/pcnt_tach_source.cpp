@@ -0,0 +1,116 @@
+/**
+ * @file pcnt_tach_source.cpp
+ * @brief Implementation of the PCNT based tachometer source
+ */
+
+#include "pcnt_tach_source.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "config.h"
+#include "debug_log.h"
+
+/*******************************************************************************
+ * Construction / Destruction
+ ******************************************************************************/
+
+PcntTachSource::PcntTachSource(uint8_t tachPin, pcnt_unit_t pcntUnit, uint8_t pulses)
+    : pin(tachPin)
+    , unit(pcntUnit)
+    , pulsesPerRevolution(pulses)
+    , initialized(false)
+    , revolutions(0)
+    , lastRevolutionUs(0) {
+    portMUX_INITIALIZE(&spinlock);
+}
+
+PcntTachSource::~PcntTachSource() {
+    if (initialized) {
+        pcnt_counter_pause(unit);
+        pcnt_isr_handler_remove(unit);
+    }
+}
+
+/*******************************************************************************
+ * Initialization
+ ******************************************************************************/
+
+bool PcntTachSource::begin() {
+    if (initialized) return true;
+
+    pcnt_config_t pcntConfig = {};
+    pcntConfig.pulse_gpio_num = pin;
+    pcntConfig.ctrl_gpio_num = PCNT_PIN_NOT_USED;
+    pcntConfig.channel = PCNT_CHANNEL_0;
+    pcntConfig.unit = unit;
+    pcntConfig.pos_mode = PCNT_COUNT_DIS;      // Count falling edges only
+    pcntConfig.neg_mode = PCNT_COUNT_INC;
+    pcntConfig.lctrl_mode = PCNT_MODE_KEEP;
+    pcntConfig.hctrl_mode = PCNT_MODE_KEEP;
+    pcntConfig.counter_h_lim = pulsesPerRevolution;  // One event per revolution
+    pcntConfig.counter_l_lim = 0;
+
+    if (pcnt_unit_config(&pcntConfig) != ESP_OK) {
+        DEBUG_LOG_FAN("PCNT unit %d configuration failed", unit);
+        return false;
+    }
+
+    // Tach outputs are open collector
+    gpio_set_pull_mode(static_cast<gpio_num_t>(pin), GPIO_PULLUP_ONLY);
+
+    // Reject edges shorter than the filter window (PWM crosstalk, ringing)
+    pcnt_set_filter_value(unit, Config::Fan::Tach::GLITCH_FILTER_APB_CYCLES);
+    pcnt_filter_enable(unit);
+
+    pcnt_event_enable(unit, PCNT_EVT_H_LIM);
+    pcnt_counter_pause(unit);
+    pcnt_counter_clear(unit);
+
+    // The ISR service is shared between units and may already be installed
+    esp_err_t err = pcnt_isr_service_install(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        DEBUG_LOG_FAN("PCNT ISR service install failed: %d", err);
+        return false;
+    }
+
+    if (pcnt_isr_handler_add(unit, handleRevolution, this) != ESP_OK) {
+        DEBUG_LOG_FAN("PCNT ISR handler registration failed");
+        return false;
+    }
+
+    pcnt_counter_resume(unit);
+    initialized = true;
+    return true;
+}
+
+/*******************************************************************************
+ * Revolution Tracking
+ ******************************************************************************/
+
+void IRAM_ATTR PcntTachSource::handleRevolution(void* arg) {
+    PcntTachSource* source = static_cast<PcntTachSource*>(arg);
+    uint32_t now = static_cast<uint32_t>(esp_timer_get_time());
+
+    portENTER_CRITICAL_ISR(&source->spinlock);
+    source->revolutions = source->revolutions + 1;
+    source->lastRevolutionUs = now;
+    portEXIT_CRITICAL_ISR(&source->spinlock);
+
+    if (source->revolutionHandler) {
+        source->revolutionHandler(source->revolutionContext);
+    }
+}
+
+TachSource::Capture PcntTachSource::capture(uint32_t nowUs) {
+    (void)nowUs;
+
+    Capture result;
+    portENTER_CRITICAL(&spinlock);
+    result.revolutions = revolutions;
+    result.lastRevolutionUs = lastRevolutionUs;
+    portEXIT_CRITICAL(&spinlock);
+    return result;
+}
+
+bool PcntTachSource::isLineLow() const {
+    return gpio_get_level(static_cast<gpio_num_t>(pin)) == 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Arduino.h>
+#include "driver/pcnt.h"
+#include "freertos/FreeRTOS.h"
+#include "tachometer.h"
+
+/**
+ * @brief Tachometer source on the ESP32-S3 pulse counter peripheral
+ *
+ * Tach pulses are counted in hardware with the PCNT glitch filter enabled.
+ * The counter high limit is set to one revolution, so the CPU is only
+ * interrupted once per revolution to timestamp it instead of once per
+ * pulse edge.
+ */
+class PcntTachSource : public TachSource {
+public:
+    /**
+     * @param pin Tachometer GPIO (open collector, pulled up)
+     * @param unit PCNT unit dedicated to this fan
+     * @param pulsesPerRevolution Tach pulses emitted per fan revolution
+     */
+    PcntTachSource(uint8_t pin, pcnt_unit_t unit, uint8_t pulsesPerRevolution);
+    ~PcntTachSource() override;
+
+    // Prevent copying
+    PcntTachSource(const PcntTachSource&) = delete;
+    PcntTachSource& operator=(const PcntTachSource&) = delete;
+
+    bool begin() override;
+    Capture capture(uint32_t nowUs) override;
+    bool isLineLow() const override;
+
+private:
+    const uint8_t pin;
+    const pcnt_unit_t unit;
+    const uint8_t pulsesPerRevolution;
+    bool initialized;
+
+    // Written from the PCNT ISR
+    portMUX_TYPE spinlock;
+    volatile uint32_t revolutions;
+    volatile uint32_t lastRevolutionUs;
+
+    static void IRAM_ATTR handleRevolution(void* arg);
+};
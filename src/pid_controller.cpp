@@ -0,0 +1,90 @@
+/**
+ * @file pid_controller.cpp
+ * @brief Implementation of the PidController class
+ */
+
+#include "pid_controller.h"
+
+/*******************************************************************************
+ * Construction / Configuration
+ ******************************************************************************/
+
+PidController::PidController(const Gains& initialGains, float target,
+                             float minimum, float maximum, float samplePeriodS)
+    : gains(initialGains)
+    , setpoint(target)
+    , outputMin(minimum)
+    , outputMax(maximum)
+    , samplePeriod(samplePeriodS)
+    , integral(minimum)
+    , lastMeasurement(0.0f)
+    , lastOutput(minimum)
+    , hasLastMeasurement(false) {
+}
+
+void PidController::setOutputLimits(float minimum, float maximum) {
+    if (minimum >= maximum) return;
+    if (minimum == outputMin && maximum == outputMax) return;
+
+    outputMin = minimum;
+    outputMax = maximum;
+    // Narrowed limits cap the integrator at once instead of letting it
+    // unwind from beyond them
+    integral = clamp(integral);
+    lastOutput = clamp(lastOutput);
+}
+
+void PidController::setSamplePeriod(float samplePeriodS) {
+    if (samplePeriodS <= 0.0f) return;
+    samplePeriod = samplePeriodS;
+}
+
+void PidController::reset(float measurement, float output) {
+    // The next update() adds the P term on top of the integrator, so seed
+    // it without; update(measurement) then continues from output unless
+    // the P term alone reaches past the limits
+    lastOutput = clamp(output);
+    integral = clamp(lastOutput - gains.kp * (measurement - setpoint));
+    lastMeasurement = measurement;
+    hasLastMeasurement = true;
+}
+
+/*******************************************************************************
+ * Control Step
+ ******************************************************************************/
+
+float PidController::update(float measurement, float feedForward) {
+    // Reverse acting: a measurement above the setpoint needs more output
+    float error = measurement - setpoint;
+
+    float proportional = gains.kp * error;
+
+    // Derivative on measurement avoids a kick when the setpoint is changed
+    float derivative = 0.0f;
+    if (hasLastMeasurement) {
+        derivative = gains.kd * (measurement - lastMeasurement) / samplePeriod;
+    }
+    lastMeasurement = measurement;
+    hasLastMeasurement = true;
+
+    // Conditional integration: stop accumulating while the output is
+    // saturated and the error would push it further into saturation
+    float candidate = integral + gains.ki * error * samplePeriod;
+    float unclamped = proportional + candidate + derivative + feedForward;
+    bool saturatedHigh = unclamped > outputMax && error > 0.0f;
+    bool saturatedLow = unclamped < outputMin && error < 0.0f;
+    if (!saturatedHigh && !saturatedLow) {
+        // The other terms can hold the output inside the limits while the
+        // error keeps integrating, e.g. a steep fall seen by the D term
+        integral = clamp(candidate);
+    }
+
+    lastOutput = clamp(proportional + integral + derivative + feedForward);
+    return lastOutput;
+}
+
+float PidController::clamp(float value) const {
+    if (value < outputMin) return outputMin;
+    if (value > outputMax) return outputMax;
+    return value;
+}
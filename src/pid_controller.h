@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Discrete PID controller for closed-loop fan speed control
+ *
+ * Features:
+ * - Reverse-acting loop: output rises while the measurement is above the setpoint
+ * - Derivative on measurement to avoid kicks when the setpoint changes
+ * - Anti-windup through conditional integration, integrator clamped to the output limits
+ * - One update() per new sample; the owner adjusts the period when the sample rate changes
+ * - Bumpless transfer when taking over from manual control
+ *
+ * The class has no hardware or RTOS dependencies and is not thread-safe;
+ * the owner is expected to serialize access.
+ */
+class PidController {
+public:
+    /**
+     * @brief Controller tuning parameters
+     */
+    struct Gains {
+        float kp;   ///< Proportional gain (output units per °C)
+        float ki;   ///< Integral gain (output units per °C per second)
+        float kd;   ///< Derivative gain (output units per °C/s)
+    };
+
+    /**
+     * @brief Construct a new PID controller
+     * @param gains Initial tuning parameters
+     * @param setpoint Target value for the measurement
+     * @param outputMin Lower output limit
+     * @param outputMax Upper output limit
+     * @param samplePeriodS Initial time between two update() calls in seconds
+     */
+    PidController(const Gains& gains, float setpoint,
+                  float outputMin, float outputMax, float samplePeriodS);
+
+    // Configuration
+    void setGains(const Gains& newGains) { gains = newGains; }
+    const Gains& getGains() const { return gains; }
+    void setSetpoint(float value) { setpoint = value; }
+    float getSetpoint() const { return setpoint; }
+    void setOutputLimits(float minimum, float maximum);
+    void setSamplePeriod(float samplePeriodS);
+
+    /**
+     * @brief Re-initialize the controller state for a bumpless start
+     * @param measurement Current measurement, seeds the derivative term
+     * @param output Output currently applied; an update() with the same
+     *               measurement returns it, unless the P term alone
+     *               reaches past the limits
+     */
+    void reset(float measurement, float output);
+
+    /**
+     * @brief Run one control step with a new measurement
+     * @param measurement Latest process value
+     * @param feedForward Added to the output ahead of the clamp, counts toward saturation
+     * @return Output clamped to the configured limits
+     */
+    float update(float measurement, float feedForward = 0.0f);
+
+    float getLastOutput() const { return lastOutput; }
+
+private:
+    Gains gains;
+    float setpoint;
+    float outputMin;
+    float outputMax;
+    float samplePeriod;
+
+    float integral;             ///< Integrator state, already scaled by ki
+    float lastMeasurement;
+    float lastOutput;
+    bool hasLastMeasurement;
+
+    float clamp(float value) const;
+};
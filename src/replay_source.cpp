@@ -0,0 +1,137 @@
+/**
+ * @file replay_source.cpp
+ * @brief Implementation of the trace replay temperature source
+ */
+
+#include "replay_source.h"
+#include "debug_log.h"
+#include <cstring>
+
+/*******************************************************************************
+ * Construction
+ ******************************************************************************/
+
+ReplaySource::ReplaySource(float replaySpeed, bool replayLoop)
+    : data(nullptr)
+    , size(0)
+    , bodyOffset(0)
+    , offset(0)
+    , speed(replaySpeed)
+    , loop(replayLoop)
+    , count(0)
+    , resolution(Config::Temperature::Resolution::DEFAULT_BITS)
+    , requestedResolution(0)
+    , recordIndex(0)
+    , finished(false)
+    , readings{} {
+}
+
+void ReplaySource::load(const uint8_t* trace, size_t traceSize) {
+    data = trace;
+    size = traceSize;
+    count = 0;
+}
+
+/*******************************************************************************
+ * Header
+ ******************************************************************************/
+
+uint8_t ReplaySource::begin() {
+    count = 0;
+    if (!data || size < TraceFormat::FILE_HEADER_SIZE ||
+        memcmp(data, TraceFormat::MAGIC, sizeof(TraceFormat::MAGIC)) != 0) {
+        DEBUG_LOG_TEMP("Not a temperature trace");
+        return 0;
+    }
+    if (data[4] != TraceFormat::VERSION) {
+        DEBUG_LOG_TEMP("Unsupported trace version %d", data[4]);
+        return 0;
+    }
+
+    uint8_t probes = data[5];
+    if (!probes || probes > MAX_SENSORS || size < TraceFormat::headerSize(probes)) {
+        DEBUG_LOG_TEMP("Trace header truncated or with %d probes", probes);
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < probes; i++) {
+        Reading& reading = readings[i];
+        memcpy(reading.id, &data[TraceFormat::FILE_HEADER_SIZE + i * TraceFormat::ID_SIZE], TraceFormat::ID_SIZE);
+        reading.id[ID_LENGTH - 1] = '\0';
+        reading.tempC = Config::Temperature::DEFAULT_VALUE;
+        reading.valid = false;
+        reading.failures = 0;
+    }
+
+    count = probes;
+    bodyOffset = TraceFormat::headerSize(probes);
+    offset = bodyOffset;
+    recordIndex = 0;
+    finished = false;
+
+    DEBUG_LOG_TEMP("Replaying %u records of %d probe(s) at %.1fx",
+                   (unsigned)((size - bodyOffset) / TraceFormat::recordSize(count)), count, speed);
+    return count;
+}
+
+/*******************************************************************************
+ * Playback
+ ******************************************************************************/
+
+uint8_t ReplaySource::readAll() {
+    if (!count) return 0;
+
+    if (!hasRecord() && loop && recordIndex) {
+        offset = bodyOffset;
+        recordIndex = 0;
+        DEBUG_LOG_TEMP("Trace restarted");
+    }
+    if (!hasRecord()) {
+        finished = true;
+        markFailed();
+        return 0;
+    }
+
+    const uint8_t* record = &data[offset];
+    resolution = TemperatureSource::clampBits(record[2]);
+    uint8_t validMask = record[3];
+
+    uint8_t validCount = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        Reading& reading = readings[i];
+        int16_t raw = static_cast<int16_t>(TraceFormat::getU16(&record[TraceFormat::RECORD_HEADER_SIZE + i * sizeof(int16_t)]));
+        reading.tempC = raw / TraceFormat::TEMP_SCALE;
+
+        if (validMask & (1 << i)) {
+            reading.valid = true;
+            reading.failures = 0;
+            validCount++;
+        } else {
+            reading.valid = false;
+            if (reading.failures < UINT8_MAX) {
+                reading.failures++;
+            }
+        }
+    }
+
+    offset += TraceFormat::recordSize(count);
+    recordIndex++;
+    return validCount;
+}
+
+uint32_t ReplaySource::samplePeriodMs(uint32_t nominalMs) const {
+    // Nothing recorded to follow, at the end or across a loop restart
+    if (!count || !hasRecord() || !recordIndex) return nominalMs;
+    if (speed <= 0.0f) return 0;
+
+    return static_cast<uint32_t>(TraceFormat::getU16(&data[offset]) / speed);
+}
+
+void ReplaySource::markFailed() {
+    for (uint8_t i = 0; i < count; i++) {
+        readings[i].valid = false;
+        if (readings[i].failures < UINT8_MAX) {
+            readings[i].failures++;
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "config.h"
+#include "temperature_source.h"
+#include "trace_format.h"
+
+/**
+ * @brief Temperature source that plays back a recorded trace
+ *
+ * Each readAll() returns the next record of the trace. The record's
+ * recorded delay, divided by the speed factor, becomes the sample period
+ * of the acquisition cycle, so a trace replays at its original pace, or
+ * accelerated. Conversions complete at once and resolution requests are
+ * only recorded; the recorded resolution is reported instead.
+ *
+ * The replay driver in src/replay steps the acquisition cycle with a
+ * clock that jumps by each returned delay, so it runs a day-long trace
+ * in well under a second and still reports the recorded timestamps.
+ *
+ * The trace buffer is not copied and must outlive the source. Not
+ * thread-safe; only the temperature task uses it.
+ */
+class ReplaySource : public TemperatureSource {
+public:
+    /**
+     * @param speed Replay speed, 1 for the recorded pace, 0 for no delay at all
+     * @param loop Restart at the first record once the trace is exhausted
+     */
+    explicit ReplaySource(float speed = 1.0f, bool loop = false);
+
+    // Prevent copying
+    ReplaySource(const ReplaySource&) = delete;
+    ReplaySource& operator=(const ReplaySource&) = delete;
+
+    /**
+     * @brief Set the trace to replay, before begin()
+     */
+    void load(const uint8_t* trace, size_t size);
+
+    /**
+     * @brief Validate the trace header and take over its probes
+     * @return Number of probes in the trace, 0 if the trace is invalid
+     */
+    uint8_t begin() override;
+
+    void requestConversion() override {}
+    bool isConversionComplete() override { return true; }
+
+    /**
+     * @brief Advance to the next record
+     *
+     * At the end of a trace that does not loop every probe reads as
+     * failed from then on.
+     */
+    uint8_t readAll() override;
+
+    bool setResolution(uint8_t bits) override {
+        requestedResolution = clampBits(bits);
+        return true;
+    }
+    uint8_t getResolution() const override { return resolution; }
+
+    uint8_t getCount() const override { return count; }
+    const Reading& getReading(uint8_t index) const override { return readings[index]; }
+
+    const char* getName() const override { return "replay"; }
+    uint32_t maxConversionMs() const override { return 0; }
+
+    /**
+     * @brief Recorded delay before the next record, scaled by the speed
+     */
+    uint32_t samplePeriodMs(uint32_t nominalMs) const override;
+
+    bool isFinished() const { return finished; }
+    uint32_t getRecordIndex() const { return recordIndex; }
+    uint8_t getRequestedResolution() const { return requestedResolution; }    ///< 0 before any request
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t bodyOffset;      // First record
+    size_t offset;          // Next record
+    const float speed;
+    const bool loop;
+    uint8_t count;
+    uint8_t resolution;
+    uint8_t requestedResolution;
+    uint32_t recordIndex;
+    bool finished;
+    Reading readings[MAX_SENSORS];
+
+    bool hasRecord() const { return offset + TraceFormat::recordSize(count) <= size; }
+    void markFailed();
+};
@@ -0,0 +1,249 @@
+/**
+ * @file rmt_onewire.cpp
+ * @brief Implementation of the RMT based OneWire transport
+ */
+
+#include "rmt_onewire.h"
+#include "driver/gpio.h"
+#include "soc/gpio_periph.h"
+#include "soc/gpio_struct.h"
+#include "config.h"
+#include "debug_log.h"
+
+namespace {
+    // Standard speed slot timing, one RMT tick per microsecond
+    constexpr uint32_t CLOCK_DIVIDER = 80;          // 80 MHz APB clock
+    constexpr uint32_t RESET_LOW_US = 480;
+    constexpr uint32_t RESET_HIGH_US = 480;         // Presence pulse and recovery
+    constexpr uint32_t WRITE_1_LOW_US = 6;
+    constexpr uint32_t WRITE_1_HIGH_US = 64;
+    constexpr uint32_t WRITE_0_LOW_US = 60;
+    constexpr uint32_t WRITE_0_HIGH_US = 10;
+    constexpr uint32_t READ_LOW_US = 3;
+    constexpr uint32_t READ_HIGH_US = 67;
+    constexpr uint32_t READ_SAMPLE_US = 15;         // A device holding the line longer sends 0
+
+    // The RX frame ends once the line stays high longer than any high
+    // phase within a burst
+    constexpr uint16_t RX_IDLE_US = 100;
+    constexpr uint8_t RX_FILTER_APB_CYCLES = 30;    // Ignore ringing below ~0.4 us
+    constexpr size_t RX_BUFFER_BYTES = 512;
+
+    constexpr uint8_t MAX_SLOTS = 8;                // One byte per burst
+}
+
+/*******************************************************************************
+ * Construction / Destruction
+ ******************************************************************************/
+
+RmtOneWire::RmtOneWire(uint8_t busPin, rmt_channel_t tx, rmt_channel_t rx)
+    : pin(busPin)
+    , txChannel(tx)
+    , rxChannel(rx)
+    , initialized(false)
+    , txDone(nullptr)
+    , rxBuffer(nullptr) {
+}
+
+RmtOneWire::~RmtOneWire() {
+    if (initialized) {
+        rmt_register_tx_end_callback(nullptr, nullptr);
+        rmt_driver_uninstall(rxChannel);
+        rmt_driver_uninstall(txChannel);
+    }
+    if (txDone) {
+        vSemaphoreDelete(txDone);
+    }
+}
+
+/*******************************************************************************
+ * Initialization
+ ******************************************************************************/
+
+bool RmtOneWire::begin() {
+    if (initialized) return true;
+
+    txDone = xSemaphoreCreateBinary();
+    if (!txDone) {
+        return false;
+    }
+
+    gpio_num_t gpio = static_cast<gpio_num_t>(pin);
+
+    rmt_config_t txConfig = RMT_DEFAULT_CONFIG_TX(gpio, txChannel);
+    txConfig.clk_div = CLOCK_DIVIDER;
+    txConfig.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;
+    txConfig.tx_config.idle_output_en = true;
+    if (rmt_config(&txConfig) != ESP_OK || rmt_driver_install(txChannel, 0, 0) != ESP_OK) {
+        DEBUG_LOG_TEMP("RMT TX channel %d setup failed", txChannel);
+        return false;
+    }
+
+    rmt_config_t rxConfig = RMT_DEFAULT_CONFIG_RX(gpio, rxChannel);
+    rxConfig.clk_div = CLOCK_DIVIDER;
+    rxConfig.rx_config.filter_en = true;
+    rxConfig.rx_config.filter_ticks_thresh = RX_FILTER_APB_CYCLES;
+    rxConfig.rx_config.idle_threshold = RX_IDLE_US;
+    if (rmt_config(&rxConfig) != ESP_OK ||
+        rmt_driver_install(rxChannel, RX_BUFFER_BYTES, 0) != ESP_OK ||
+        rmt_get_ringbuf_handle(rxChannel, &rxBuffer) != ESP_OK) {
+        DEBUG_LOG_TEMP("RMT RX channel %d setup failed", rxChannel);
+        rmt_driver_uninstall(txChannel);
+        return false;
+    }
+
+    // Both channels share one open-drain pad. Routing TX makes the pad
+    // output only, so RX goes first and the input path is restored after.
+    rmt_set_gpio(rxChannel, RMT_MODE_RX, gpio, false);
+    rmt_set_gpio(txChannel, RMT_MODE_TX, gpio, false);
+    PIN_INPUT_ENABLE(GPIO_PIN_MUX_REG[pin]);
+    GPIO.pin[pin].pad_driver = 1;
+    gpio_set_pull_mode(gpio, GPIO_PULLUP_ONLY);
+
+    rmt_register_tx_end_callback(handleTxEnd, this);
+
+    initialized = true;
+    return true;
+}
+
+/*******************************************************************************
+ * Link Layer
+ ******************************************************************************/
+
+bool RmtOneWire::reset() {
+    rmt_item32_t item = slot(RESET_LOW_US, RESET_HIGH_US);
+    rmt_item32_t received[4];
+    int count = transmit(&item, 1, received, 4);
+
+    // The first low phase is the reset pulse itself, any later one a presence pulse
+    uint8_t lowPhases = 0;
+    for (int i = 0; i < count; i++) {
+        if (!received[i].level0 && received[i].duration0) lowPhases++;
+        if (!received[i].level1 && received[i].duration1) lowPhases++;
+    }
+    return lowPhases >= 2;
+}
+
+bool RmtOneWire::write(const uint8_t* data, size_t length, bool holdHigh) {
+    (void)holdHigh;     // Open drain, the pull-up is all there is
+    for (size_t i = 0; i < length; i++) {
+        if (!writeBits(data[i], 8)) return false;
+    }
+    return true;
+}
+
+bool RmtOneWire::read(uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (!readBits(&data[i], 8)) return false;
+    }
+    return true;
+}
+
+bool RmtOneWire::writeBit(bool bit) {
+    return writeBits(bit ? 1 : 0, 1);
+}
+
+bool RmtOneWire::readBit(bool& bit) {
+    uint8_t value;
+    if (!readBits(&value, 1)) return false;
+    bit = value & 0x01;
+    return true;
+}
+
+bool RmtOneWire::writeBits(uint8_t value, uint8_t bits) {
+    rmt_item32_t items[MAX_SLOTS];
+    for (uint8_t i = 0; i < bits; i++) {
+        items[i] = (value >> i) & 0x01
+            ? slot(WRITE_1_LOW_US, WRITE_1_HIGH_US)
+            : slot(WRITE_0_LOW_US, WRITE_0_HIGH_US);
+    }
+    return transmit(items, bits, nullptr, 0) >= 0;
+}
+
+bool RmtOneWire::readBits(uint8_t* value, uint8_t bits) {
+    rmt_item32_t items[MAX_SLOTS];
+    for (uint8_t i = 0; i < bits; i++) {
+        items[i] = slot(READ_LOW_US, READ_HIGH_US);
+    }
+
+    rmt_item32_t received[MAX_SLOTS + 1];
+    int count = transmit(items, bits, received, MAX_SLOTS + 1);
+
+    // One low phase per slot, stretched by the device for a 0
+    uint8_t found = 0;
+    *value = 0;
+    for (int i = 0; i < count && found < bits; i++) {
+        if (!received[i].level0 && received[i].duration0) {
+            if (received[i].duration0 <= READ_SAMPLE_US) *value |= 1 << found;
+            found++;
+        }
+        if (found < bits && !received[i].level1 && received[i].duration1) {
+            if (received[i].duration1 <= READ_SAMPLE_US) *value |= 1 << found;
+            found++;
+        }
+    }
+    return found == bits;
+}
+
+int RmtOneWire::transmit(const rmt_item32_t* items, size_t count,
+                         rmt_item32_t* received, size_t maxReceived) {
+    if (!initialized) return -1;
+
+    if (received) {
+        // Drop anything left from an aborted burst
+        size_t size;
+        while (void* stale = xRingbufferReceive(rxBuffer, &size, 0)) {
+            vRingbufferReturnItem(rxBuffer, stale);
+        }
+        rmt_rx_start(rxChannel, true);
+    }
+
+    // The task sleeps here while the RMT clocks the slots
+    xSemaphoreTake(txDone, 0);
+    bool sent = rmt_write_items(txChannel, items, count, false) == ESP_OK &&
+                xSemaphoreTake(txDone, pdMS_TO_TICKS(Config::Temperature::Bus::RMT_TIMEOUT_MS)) == pdTRUE;
+
+    int recorded = 0;
+    if (received) {
+        size_t size = 0;
+        rmt_item32_t* frame = sent
+            ? static_cast<rmt_item32_t*>(xRingbufferReceive(rxBuffer, &size,
+                  pdMS_TO_TICKS(Config::Temperature::Bus::RMT_TIMEOUT_MS)))
+            : nullptr;
+        rmt_rx_stop(rxChannel);
+        if (!frame) {
+            DEBUG_LOG_TEMP("RMT OneWire frame timed out");
+            return -1;
+        }
+
+        recorded = min(size / sizeof(rmt_item32_t), maxReceived);
+        memcpy(received, frame, recorded * sizeof(rmt_item32_t));
+        vRingbufferReturnItem(rxBuffer, frame);
+    }
+
+    return sent ? recorded : -1;
+}
+
+/*******************************************************************************
+ * Utility Methods
+ ******************************************************************************/
+
+rmt_item32_t RmtOneWire::slot(uint32_t lowUs, uint32_t highUs) {
+    rmt_item32_t item;
+    item.level0 = 0;
+    item.duration0 = lowUs;
+    item.level1 = 1;
+    item.duration1 = highUs;
+    return item;
+}
+
+void IRAM_ATTR RmtOneWire::handleTxEnd(rmt_channel_t channel, void* arg) {
+    RmtOneWire* bus = static_cast<RmtOneWire*>(arg);
+    if (!bus || channel != bus->txChannel) return;
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(bus->txDone, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Arduino.h>
+#include "driver/rmt.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/ringbuf.h"
+#include "onewire_transport.h"
+
+/**
+ * @brief OneWire transport on the ESP32-S3 RMT peripheral
+ *
+ * A TX channel drives the slots and an RX channel on the same open-drain
+ * pin records the line, so both the slot timing and the sampling of
+ * presence pulses and read bits happen in hardware. The calling task
+ * sleeps until the TX end interrupt signals completion and the RX
+ * frame arrives in the driver's ring buffer; the CPU never spins and
+ * interrupts are never masked, so tach interrupts keep their timing.
+ *
+ * The line is open drain and only pulled up, parasite powered probes
+ * cannot be given a strong pull-up; use BitBangOneWire for those.
+ *
+ * Not thread-safe; one transaction at a time per instance. The TX end
+ * callback of the RMT driver is global, so one instance per firmware.
+ */
+class RmtOneWire : public OneWireTransport {
+public:
+    /**
+     * @param pin Bus GPIO, pulled up externally
+     * @param txChannel RMT TX channel, 0-3 on the ESP32-S3
+     * @param rxChannel RMT RX channel, 4-7 on the ESP32-S3
+     */
+    RmtOneWire(uint8_t pin, rmt_channel_t txChannel, rmt_channel_t rxChannel);
+    ~RmtOneWire() override;
+
+    // Prevent copying
+    RmtOneWire(const RmtOneWire&) = delete;
+    RmtOneWire& operator=(const RmtOneWire&) = delete;
+
+    bool begin() override;
+    bool reset() override;
+    bool write(const uint8_t* data, size_t length, bool holdHigh = false) override;
+    bool read(uint8_t* data, size_t length) override;
+    bool writeBit(bool bit) override;
+    bool readBit(bool& bit) override;
+    const char* getName() const override { return "rmt"; }
+
+private:
+    const uint8_t pin;
+    const rmt_channel_t txChannel;
+    const rmt_channel_t rxChannel;
+    bool initialized;
+    SemaphoreHandle_t txDone;
+    RingbufHandle_t rxBuffer;
+
+    /**
+     * @brief Run one burst of slots
+     * @param received Receives the recorded line levels, nullptr to skip recording
+     * @return Number of recorded items, -1 on a timeout
+     */
+    int transmit(const rmt_item32_t* items, size_t count, rmt_item32_t* received, size_t maxReceived);
+    bool readBits(uint8_t* value, uint8_t bits);
+    bool writeBits(uint8_t value, uint8_t bits);
+
+    static rmt_item32_t slot(uint32_t lowUs, uint32_t highUs);
+    static void IRAM_ATTR handleTxEnd(rmt_channel_t channel, void* arg);
+};
@@ -0,0 +1,252 @@
+/**
+ * @file sensor_bus.cpp
+ * @brief Implementation of the address-based DS18B20 bus
+ */
+
+#include "sensor_bus.h"
+#include "debug_log.h"
+#include <cmath>
+
+namespace {
+    // ROM and DS18B20 function commands
+    constexpr uint8_t CMD_MATCH_ROM = 0x55;
+    constexpr uint8_t CMD_SKIP_ROM = 0xCC;
+    constexpr uint8_t CMD_CONVERT_T = 0x44;
+    constexpr uint8_t CMD_READ_SCRATCHPAD = 0xBE;
+    constexpr uint8_t CMD_WRITE_SCRATCHPAD = 0x4E;
+    constexpr uint8_t CMD_READ_POWER_SUPPLY = 0xB4;
+
+    // Scratchpad layout
+    constexpr uint8_t SCRATCHPAD_TEMP_LSB = 0;
+    constexpr uint8_t SCRATCHPAD_TEMP_MSB = 1;
+    constexpr uint8_t SCRATCHPAD_TH = 2;
+    constexpr uint8_t SCRATCHPAD_TL = 3;
+    constexpr uint8_t SCRATCHPAD_CONFIG = 4;
+    constexpr uint8_t SCRATCHPAD_COUNT_REMAIN = 6;
+    constexpr uint8_t SCRATCHPAD_COUNT_PER_C = 7;
+    constexpr uint8_t SCRATCHPAD_CRC = 8;
+
+    // Family codes, the same set DallasTemperature accepts
+    constexpr uint8_t FAMILY_DS18S20 = 0x10;        // Fixed 9 bits, extended by COUNT_REMAIN
+    constexpr uint8_t FAMILY_DS1822 = 0x22;
+    constexpr uint8_t FAMILY_DS18B20 = 0x28;
+    constexpr uint8_t FAMILY_DS1825 = 0x3B;
+    constexpr uint8_t FAMILY_DS28EA00 = 0x42;
+}
+
+/*******************************************************************************
+ * Construction
+ ******************************************************************************/
+
+SensorBus::SensorBus(OneWireTransport& busTransport)
+    : transport(busTransport)
+    , addresses{}
+    , readings{}
+    , count(0)
+    , resolution(Config::Temperature::Resolution::MAX_BITS)
+    , parasitePowered(false) {
+}
+
+/*******************************************************************************
+ * Enumeration
+ ******************************************************************************/
+
+uint8_t SensorBus::begin() {
+    count = 0;
+    if (!transport.begin()) {
+        DEBUG_LOG_TEMP("OneWire %s transport failed to start", transport.getName());
+        return 0;
+    }
+
+    // Single search pass, the only one in the lifetime of the bus
+    OneWireTransport::SearchState search;
+    OneWireTransport::resetSearch(search);
+    Address address;
+    while (count < MAX_SENSORS && transport.search(search, address)) {
+        if (OneWireTransport::crc8(address, 7) != address[7] || !isSupportedFamily(address[0])) {
+            DEBUG_LOG_TEMP("Skipping invalid OneWire device");
+            continue;
+        }
+
+        memcpy(addresses[count], address, sizeof(Address));
+        Reading& reading = readings[count];
+        formatId(address, reading.id);
+        reading.tempC = Config::Temperature::DEFAULT_VALUE;
+        reading.valid = false;
+        reading.failures = 0;
+
+        DEBUG_LOG_TEMP("Found sensor %d: %s", count, reading.id);
+        count++;
+    }
+
+    if (count) {
+        parasitePowered = readPowerSupply();
+        DEBUG_LOG_TEMP("OneWire over %s, %s power", transport.getName(),
+                       parasitePowered ? "parasite" : "external");
+    }
+    return count;
+}
+
+bool SensorBus::readPowerSupply() {
+    // Any parasite powered probe pulls the answer low
+    bool externalPower = true;
+    if (!transport.reset() || !transport.writeByte(CMD_SKIP_ROM) ||
+        !transport.writeByte(CMD_READ_POWER_SUPPLY) || !transport.readBit(externalPower)) {
+        return false;
+    }
+    return !externalPower;
+}
+
+bool SensorBus::isSupportedFamily(uint8_t family) {
+    switch (family) {
+        case FAMILY_DS18S20:
+        case FAMILY_DS1822:
+        case FAMILY_DS18B20:
+        case FAMILY_DS1825:
+        case FAMILY_DS28EA00:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void SensorBus::formatId(const Address address, char* id) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    for (uint8_t i = 0; i < sizeof(Address); i++) {
+        id[i * 2] = HEX_DIGITS[address[i] >> 4];
+        id[i * 2 + 1] = HEX_DIGITS[address[i] & 0x0F];
+    }
+    id[ID_LENGTH - 1] = '\0';
+}
+
+/*******************************************************************************
+ * Conversion and Readout
+ ******************************************************************************/
+
+void SensorBus::requestConversion() {
+    // Skip ROM: every probe converts at once; parasite probes draw their
+    // conversion current through the line, kept high where the transport can
+    if (!transport.reset() || !transport.writeByte(CMD_SKIP_ROM) ||
+        !transport.writeByte(CMD_CONVERT_T, parasitePowered)) {
+        DEBUG_LOG_TEMP("Conversion request failed");
+    }
+}
+
+bool SensorBus::isConversionComplete() {
+    // Probes answer read slots with 0 while converting
+    bool done = false;
+    return !parasitePowered && transport.readBit(done) && done;
+}
+
+bool SensorBus::select(const Address address) {
+    return transport.reset() &&
+           transport.writeByte(CMD_MATCH_ROM) &&
+           transport.write(address, sizeof(Address));
+}
+
+bool SensorBus::readScratchPad(const Address address, uint8_t* scratchPad) {
+    if (!select(address) || !transport.writeByte(CMD_READ_SCRATCHPAD) ||
+        !transport.read(scratchPad, SCRATCHPAD_SIZE)) {
+        return false;
+    }
+
+    // A shorted line reads all zeros, which passes the CRC
+    bool allZero = true;
+    for (uint8_t i = 0; i < SCRATCHPAD_SIZE; i++) {
+        allZero &= scratchPad[i] == 0;
+    }
+    return !allZero && OneWireTransport::crc8(scratchPad, SCRATCHPAD_CRC) == scratchPad[SCRATCHPAD_CRC];
+}
+
+/*******************************************************************************
+ * Resolution
+ ******************************************************************************/
+
+bool SensorBus::setResolution(uint8_t bits) {
+    bits = clampBits(bits);
+
+    bool success = true;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!writeResolution(addresses[i], bits)) {
+            DEBUG_LOG_TEMP("Sensor %s rejected %d-bit resolution", readings[i].id, bits);
+            success = false;
+        }
+    }
+
+    resolution = bits;
+    return success;
+}
+
+bool SensorBus::writeResolution(const Address address, uint8_t bits) {
+    // Fixed resolution, nothing to configure
+    if (address[0] == FAMILY_DS18S20) {
+        return true;
+    }
+
+    // No Copy Scratchpad, the EEPROM is never written
+    uint8_t scratchPad[SCRATCHPAD_SIZE];
+    if (!readScratchPad(address, scratchPad)) {
+        return false;
+    }
+
+    uint8_t config = ((bits - Config::Temperature::Resolution::MIN_BITS) << 5) | 0x1F;
+    if (scratchPad[SCRATCHPAD_CONFIG] == config) {
+        return true;
+    }
+
+    // The alarm registers share the write and are rewritten unchanged
+    const uint8_t command[] = {
+        CMD_WRITE_SCRATCHPAD, scratchPad[SCRATCHPAD_TH], scratchPad[SCRATCHPAD_TL], config
+    };
+    return select(address) && transport.write(command, sizeof(command)) && transport.reset();
+}
+
+uint8_t SensorBus::readAll() {
+    uint8_t validCount = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        Reading& reading = readings[i];
+        uint8_t scratchPad[SCRATCHPAD_SIZE];
+        float tempC = readScratchPad(addresses[i], scratchPad)
+            ? toCelsius(addresses[i], scratchPad)
+            : NAN;
+
+        if (isValidTemperature(tempC)) {
+            reading.tempC = tempC;
+            reading.valid = true;
+            reading.failures = 0;
+            validCount++;
+        } else {
+            reading.valid = false;
+            if (reading.failures < UINT8_MAX) {
+                reading.failures++;
+            }
+            DEBUG_LOG_TEMP("Sensor %s read failed (%d)", reading.id, reading.failures);
+        }
+    }
+
+    return validCount;
+}
+
+float SensorBus::toCelsius(const Address address, const uint8_t* scratchPad) {
+    int16_t raw = static_cast<int16_t>((scratchPad[SCRATCHPAD_TEMP_MSB] << 8) | scratchPad[SCRATCHPAD_TEMP_LSB]);
+
+    if (address[0] == FAMILY_DS18S20) {
+        // 0.5°C register refined by the count registers, datasheet formula
+        uint8_t countPerC = scratchPad[SCRATCHPAD_COUNT_PER_C];
+        if (!countPerC) return raw * 0.5f;
+        return (raw >> 1) - 0.25f +
+               static_cast<float>(countPerC - scratchPad[SCRATCHPAD_COUNT_REMAIN]) / countPerC;
+    }
+
+    // Bits below the configured resolution are undefined
+    uint8_t bits = ((scratchPad[SCRATCHPAD_CONFIG] >> 5) & 0x03) + Config::Temperature::Resolution::MIN_BITS;
+    raw &= ~((1 << (Config::Temperature::Resolution::MAX_BITS - bits)) - 1);
+    return raw * 0.0625f;
+}
+
+bool SensorBus::isValidTemperature(float tempC) {
+    // 85°C is the power-on value of a probe that did not convert
+    return !std::isnan(tempC) && tempC != 85.0f &&
+           tempC > -55.0f && tempC < 125.0f;
+}
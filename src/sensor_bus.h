@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "onewire_transport.h"
+#include "temperature_source.h"
+
+/**
+ * @brief DS18B20 probes on one OneWire bus, addressed by ROM code
+ *
+ * The hardware implementation of TemperatureSource.
+ *
+ * The bus is searched once in begin() and the ROM codes are cached. A
+ * cycle is one broadcast conversion for all probes followed by one
+ * addressed scratchpad read per probe, so bus time grows linearly with
+ * the probe count and no search runs after startup.
+ *
+ * The DS18B20 commands are issued here; slot timing is left to the
+ * OneWireTransport, on the RMT peripheral or bit-banged.
+ *
+ * Not thread-safe; owned by TempSensor and used under its mutex.
+ */
+class SensorBus : public TemperatureSource {
+public:
+    explicit SensorBus(OneWireTransport& transport);
+
+    // Prevent copying
+    SensorBus(const SensorBus&) = delete;
+    SensorBus& operator=(const SensorBus&) = delete;
+
+    /**
+     * @brief Search the bus once and cache the probe addresses
+     * @return Number of probes found
+     */
+    uint8_t begin() override;
+
+    void requestConversion() override;
+    bool isConversionComplete() override;
+
+    /**
+     * @brief Set the resolution of every cached probe
+     *
+     * Writes the scratchpad only, never the EEPROM, so frequent switching
+     * does not wear the probes. They fall back to their stored resolution
+     * after a power cycle until the next call.
+     */
+    bool setResolution(uint8_t bits) override;
+    uint8_t getResolution() const override { return resolution; }
+
+    /**
+     * @brief Read every cached probe by address
+     */
+    uint8_t readAll() override;
+
+    uint8_t getCount() const override { return count; }
+    const Reading& getReading(uint8_t index) const override { return readings[index]; }
+
+    const char* getName() const override { return transport.getName(); }
+
+    static bool isValidTemperature(float tempC);
+
+private:
+    using Address = uint8_t[OneWireTransport::ROM_SIZE];
+    static constexpr uint8_t SCRATCHPAD_SIZE = 9;
+
+    OneWireTransport& transport;
+    Address addresses[MAX_SENSORS];
+    Reading readings[MAX_SENSORS];
+    uint8_t count;
+    uint8_t resolution;
+    bool parasitePowered;
+
+    bool select(const Address address);
+    bool readScratchPad(const Address address, uint8_t* scratchPad);
+    bool writeResolution(const Address address, uint8_t bits);
+    bool readPowerSupply();
+    static bool isSupportedFamily(uint8_t family);
+    static float toCelsius(const Address address, const uint8_t* scratchPad);
+    static void formatId(const Address address, char* id);
+};
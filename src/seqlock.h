@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+#include "freertos/FreeRTOS.h"
+
+/**
+ * @brief Sequence lock publishing a small value to lock-free readers
+ *
+ * Writers bump the sequence to an odd value, copy the data and bump it
+ * back to even. Readers copy the data and retry if the sequence was odd
+ * or changed during the copy, so they never block and always observe a
+ * value that was written as a whole.
+ *
+ * Writes run inside a spinlock critical section. This serializes writers
+ * and, more importantly, keeps a writer from being preempted mid-update
+ * by a higher priority reader on the same core, which would otherwise
+ * spin forever. Keep T small: the critical section lasts one copy.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock() : sequence(0), data{} {
+        portMUX_INITIALIZE(&writeLock);
+    }
+
+    explicit SeqLock(const T& initial) : sequence(0), data(initial) {
+        portMUX_INITIALIZE(&writeLock);
+    }
+
+    // Prevent copying
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Publish a new value
+     */
+    void write(const T& value) {
+        modify([&value](T& current) { current = value; });
+    }
+
+    /**
+     * @brief Update part of the value in place
+     *
+     * Lets independent writers each own a subset of the fields without
+     * overwriting the others' latest values. The function runs inside the
+     * critical section and must be short and non-blocking.
+     */
+    template <typename F>
+    void modify(F&& fn) {
+        portENTER_CRITICAL(&writeLock);
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        fn(data);
+        std::atomic_thread_fence(std::memory_order_release);
+        sequence.store(seq + 2, std::memory_order_release);
+        portEXIT_CRITICAL(&writeLock);
+    }
+
+    /**
+     * @brief Read a consistent copy of the latest value without blocking
+     */
+    T read() const {
+        T copy;
+        uint32_t before;
+        uint32_t after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            copy = data;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        return copy;
+    }
+
+private:
+    std::atomic<uint32_t> sequence;
+    T data;
+    portMUX_TYPE writeLock;
+};
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include <tuple>
+
+/**
+ * @brief Composable O(1) filters for sampled signals
+ *
+ * Every filter offers the same interface:
+ * - float update(float sample) feeds one sample and returns the output
+ * - void reset(float value) primes the state as if value had been steady
+ *
+ * FilterChain strings filters together at compile time; parameters of the
+ * individual stages stay tunable at runtime through get<>().
+ *
+ * Header only, on the C++ standard library alone; test_signal_filter
+ * checks the step response of each filter.
+ */
+
+/**
+ * @brief Boxcar average over the last N samples
+ *
+ * Keeps a running sum instead of re-adding the window. Samples are summed
+ * in fixed point (1/SCALE units) so additions and removals cancel exactly
+ * and the sum never drifts.
+ */
+template <size_t N>
+class MovingAverage {
+    static_assert(N > 0, "MovingAverage needs at least one sample");
+
+public:
+    static constexpr float SCALE = 1000.0f;
+
+    MovingAverage() { reset(0.0f); }
+
+    float update(float sample) {
+        int32_t fixed = toFixed(sample);
+        sum += fixed - window[index];
+        window[index] = fixed;
+        index = (index + 1) % N;
+        return sum / (SCALE * N);
+    }
+
+    void reset(float value) {
+        int32_t fixed = toFixed(value);
+        for (size_t i = 0; i < N; i++) {
+            window[i] = fixed;
+        }
+        sum = static_cast<int64_t>(fixed) * N;
+        index = 0;
+    }
+
+private:
+    int32_t window[N];
+    int64_t sum;
+    size_t index;
+
+    static int32_t toFixed(float value) {
+        return static_cast<int32_t>(lroundf(value * SCALE));
+    }
+};
+
+/**
+ * @brief Exponential moving average, y += alpha * (x - y)
+ *
+ * alpha in (0, 1]; larger follows faster. For a time constant tau at
+ * sample period T, alpha = T / (tau + T).
+ */
+class ExponentialAverage {
+public:
+    explicit ExponentialAverage(float smoothing = 0.3f)
+        : alpha(smoothing)
+        , output(0.0f) {
+    }
+
+    float update(float sample) {
+        output += alpha * (sample - output);
+        return output;
+    }
+
+    void reset(float value) { output = value; }
+
+    void setAlpha(float smoothing) { alpha = smoothing; }
+    float getAlpha() const { return alpha; }
+
+private:
+    float alpha;
+    float output;
+};
+
+/**
+ * @brief Median of the last N samples, rejects isolated spikes
+ *
+ * A single outlier never reaches the output as long as N >= 3. The
+ * window is kept sorted; each update moves at most N entries, constant
+ * for the small odd N this is meant for.
+ */
+template <size_t N>
+class MedianFilter {
+    static_assert(N % 2 == 1, "MedianFilter needs an odd window");
+
+public:
+    MedianFilter() { reset(0.0f); }
+
+    float update(float sample) {
+        // Drop the oldest sample from the sorted window
+        float oldest = history[index];
+        size_t pos = 0;
+        while (pos < N - 1 && sorted[pos] != oldest) {
+            pos++;
+        }
+        for (; pos < N - 1; pos++) {
+            sorted[pos] = sorted[pos + 1];
+        }
+
+        // Insert the new one in order
+        pos = N - 1;
+        while (pos > 0 && sorted[pos - 1] > sample) {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        sorted[pos] = sample;
+
+        history[index] = sample;
+        index = (index + 1) % N;
+        return sorted[N / 2];
+    }
+
+    void reset(float value) {
+        for (size_t i = 0; i < N; i++) {
+            history[i] = value;
+            sorted[i] = value;
+        }
+        index = 0;
+    }
+
+private:
+    float history[N];   // Arrival order
+    float sorted[N];    // Same samples, ascending
+    size_t index;
+};
+
+/**
+ * @brief Scalar Kalman filter for a slowly drifting level
+ *
+ * Random walk model: the true value drifts with variance processNoise per
+ * sample and is measured with variance measurementNoise. A low ratio of
+ * process to measurement noise smooths harder.
+ */
+class KalmanFilter1D {
+public:
+    KalmanFilter1D(float processNoise = 0.001f, float measurementNoise = 0.01f)
+        : q(processNoise)
+        , r(measurementNoise)
+        , estimate(0.0f)
+        , covariance(measurementNoise) {
+    }
+
+    float update(float sample) {
+        covariance += q;
+        float gain = covariance / (covariance + r);
+        estimate += gain * (sample - estimate);
+        covariance *= 1.0f - gain;
+        return estimate;
+    }
+
+    void reset(float value) {
+        estimate = value;
+        covariance = r;
+    }
+
+    void setProcessNoise(float processNoise) { q = processNoise; }
+    void setMeasurementNoise(float measurementNoise) { r = measurementNoise; }
+    float getProcessNoise() const { return q; }
+    float getMeasurementNoise() const { return r; }
+
+private:
+    float q;
+    float r;
+    float estimate;
+    float covariance;
+};
+
+/**
+ * @brief Filters applied in order, each feeding the next
+ *
+ * The composition is fixed at compile time, e.g.
+ *   FilterChain<MedianFilter<3>, KalmanFilter1D>
+ * and a stage is reached for tuning with get<KalmanFilter1D>() or get<1>().
+ */
+template <typename... Filters>
+class FilterChain {
+    static_assert(sizeof...(Filters) > 0, "FilterChain needs at least one filter");
+
+public:
+    float update(float sample) {
+        std::apply([&sample](auto&... stage) { ((sample = stage.update(sample)), ...); }, stages);
+        return sample;
+    }
+
+    void reset(float value) {
+        std::apply([value](auto&... stage) { (stage.reset(value), ...); }, stages);
+    }
+
+    template <size_t I>
+    auto& get() { return std::get<I>(stages); }
+
+    template <typename F>
+    F& get() { return std::get<F>(stages); }
+
+private:
+    std::tuple<Filters...> stages;
+};
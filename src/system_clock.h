@@ -0,0 +1,14 @@
+#pragma once
+
+#include "esp_timer.h"
+#include "clock.h"
+
+/**
+ * @brief Clock backed by esp_timer
+ */
+class SystemClock : public Clock {
+public:
+    uint32_t nowUs() const override {
+        return static_cast<uint32_t>(esp_timer_get_time());
+    }
+};
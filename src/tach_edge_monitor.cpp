@@ -0,0 +1,105 @@
+/**
+ * @file tach_edge_monitor.cpp
+ * @brief Implementation of the tach edge loss measurement
+ */
+
+#include "tach_edge_monitor.h"
+#include "config.h"
+#include "debug_log.h"
+
+static_assert(!Config::Temperature::Bus::MEASURE_TACH_LOSS ||
+              (Config::Temperature::Bus::MEASURE_FAN_CHANNEL < Config::Fan::Channels::COUNT &&
+               Config::Temperature::Bus::MEASURE_FAN_CHANNEL < Config::Fan::Tach::PCNT_UNITS),
+              "The tach loss measurement needs a fan that would count on a PCNT unit");
+
+/*******************************************************************************
+ * Construction / Destruction
+ ******************************************************************************/
+
+TachEdgeMonitor::TachEdgeMonitor(uint8_t tachPin, pcnt_unit_t pcntUnit)
+    : pin(tachPin)
+    , unit(pcntUnit)
+    , source(nullptr)
+    , initialized(false)
+    , windowOpen(false)
+    , windowStartEdges(0)
+    , stats{} {
+}
+
+TachEdgeMonitor::~TachEdgeMonitor() {
+    if (initialized) {
+        pcnt_counter_pause(unit);
+    }
+}
+
+/*******************************************************************************
+ * Initialization
+ ******************************************************************************/
+
+bool TachEdgeMonitor::begin(const GpioTachSource* tachSource) {
+    if (initialized) return true;
+    if (!tachSource) {
+        DEBUG_LOG_TEMP("Tach loss measurement needs the fan's GPIO tach source");
+        return false;
+    }
+
+    pcnt_config_t pcntConfig = {};
+    pcntConfig.pulse_gpio_num = pin;
+    pcntConfig.ctrl_gpio_num = PCNT_PIN_NOT_USED;
+    pcntConfig.channel = PCNT_CHANNEL_0;
+    pcntConfig.unit = unit;
+    pcntConfig.pos_mode = PCNT_COUNT_DIS;
+    pcntConfig.neg_mode = PCNT_COUNT_INC;
+    pcntConfig.lctrl_mode = PCNT_MODE_KEEP;
+    pcntConfig.hctrl_mode = PCNT_MODE_KEEP;
+    pcntConfig.counter_h_lim = INT16_MAX;
+    pcntConfig.counter_l_lim = 0;
+
+    if (pcnt_unit_config(&pcntConfig) != ESP_OK) {
+        DEBUG_LOG_TEMP("Tach loss PCNT unit %d configuration failed", unit);
+        return false;
+    }
+    pcnt_set_filter_value(unit, Config::Fan::Tach::GLITCH_FILTER_APB_CYCLES);
+    pcnt_filter_enable(unit);
+    pcnt_counter_clear(unit);
+    pcnt_counter_resume(unit);
+
+    source = tachSource;
+    initialized = true;
+    return true;
+}
+
+/*******************************************************************************
+ * Measurement
+ ******************************************************************************/
+
+void TachEdgeMonitor::startWindow() {
+    if (!initialized) return;
+
+    pcnt_counter_clear(unit);
+    windowStartEdges = source->getEdges();
+    windowOpen = true;
+}
+
+void TachEdgeMonitor::endWindow() {
+    if (!initialized || !windowOpen) return;
+    windowOpen = false;
+
+    // An edge still on its way to the ISR at this instant reads as missed
+    int16_t hardwareEdges = 0;
+    pcnt_get_counter_value(unit, &hardwareEdges);
+    uint32_t counted = source->getEdges() - windowStartEdges;
+    uint32_t missed = static_cast<uint32_t>(hardwareEdges) > counted ? hardwareEdges - counted : 0;
+
+    stats.reads++;
+    stats.edges += hardwareEdges;
+    stats.lastMissed = missed;
+    stats.totalMissed += missed;
+    if (missed > stats.maxMissed) {
+        stats.maxMissed = missed;
+    }
+
+    if (missed) {
+        DEBUG_LOG_TEMP("Probe readout missed %u of %d tach edges", (unsigned)missed, hardwareEdges);
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Arduino.h>
+#include "driver/pcnt.h"
+#include "freertos/FreeRTOS.h"
+#include "gpio_tach_source.h"
+
+/**
+ * @brief Measures tach edges lost to interrupt latency during bus traffic
+ *
+ * Counts the falling edges of one fan's tach pin twice: in hardware on a
+ * PCNT unit, which cannot miss one, and in the fan's own GpioTachSource.
+ * Around each probe readout the difference is the number of edges the
+ * interrupt driven tachometer lost to masked interrupts.
+ *
+ * Diagnostic only, enabled by Config::Temperature::Bus::MEASURE_TACH_LOSS.
+ * Not thread-safe. Only the Temp task opens and closes windows; stats are
+ * written and read under the TempSensor mutex, startWindow() leaves them
+ * alone.
+ */
+class TachEdgeMonitor {
+public:
+    struct Stats {
+        uint32_t reads;         ///< Measured readouts
+        uint32_t edges;         ///< Edges counted in hardware during them
+        uint32_t lastMissed;
+        uint32_t maxMissed;
+        uint32_t totalMissed;
+    };
+
+    /**
+     * @param pin Tach GPIO already configured by the fan's own source
+     * @param unit PCNT unit not used by any fan
+     */
+    TachEdgeMonitor(uint8_t pin, pcnt_unit_t unit);
+    ~TachEdgeMonitor();
+
+    // Prevent copying
+    TachEdgeMonitor(const TachEdgeMonitor&) = delete;
+    TachEdgeMonitor& operator=(const TachEdgeMonitor&) = delete;
+
+    /**
+     * @param source The fan's started tach source on the same pin
+     */
+    bool begin(const GpioTachSource* source);
+
+    // Bracket one readout
+    void startWindow();
+    void endWindow();
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    const uint8_t pin;
+    const pcnt_unit_t unit;
+    const GpioTachSource* source;
+    bool initialized;
+    bool windowOpen;
+    uint32_t windowStartEdges;
+    Stats stats;
+};
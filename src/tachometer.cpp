@@ -0,0 +1,117 @@
+/**
+ * @file tachometer.cpp
+ * @brief Implementation of the period-based RPM estimator and simulated source
+ */
+
+#include "tachometer.h"
+#include "config.h"
+
+namespace {
+    constexpr uint32_t MICROS_PER_MINUTE = 60000000UL;
+    constexpr uint32_t TIMEOUT_US = Config::Fan::RPM::TIMEOUT_MS * 1000UL;
+}
+
+/*******************************************************************************
+ * Tachometer
+ ******************************************************************************/
+
+Tachometer::Tachometer()
+    : source(nullptr)
+    , lastRevolutions(0)
+    , lastRevolutionUs(0)
+    , hasReference(false)
+    , rpm(0) {
+}
+
+bool Tachometer::begin(TachSource* tachSource) {
+    source = tachSource;
+    hasReference = false;
+    rpm = 0;
+    return source && source->begin();
+}
+
+uint16_t Tachometer::update(uint32_t nowUs) {
+    if (!source) return 0;
+
+    TachSource::Capture capture = source->capture(nowUs);
+
+    if (capture.revolutions == 0) {
+        rpm = 0;
+        return rpm;
+    }
+
+    if (!hasReference) {
+        // Need two revolution timestamps before a period is known
+        lastRevolutions = capture.revolutions;
+        lastRevolutionUs = capture.lastRevolutionUs;
+        hasReference = true;
+        return rpm;
+    }
+
+    uint32_t newRevolutions = capture.revolutions - lastRevolutions;
+    if (newRevolutions > 0) {
+        // Average period over every revolution since the last update
+        uint32_t periodUs = (capture.lastRevolutionUs - lastRevolutionUs) / newRevolutions;
+        rpm = periodToRPM(periodUs);
+        lastRevolutions = capture.revolutions;
+        lastRevolutionUs = capture.lastRevolutionUs;
+        return rpm;
+    }
+
+    // No revolution since the last update: the true period is at least the
+    // time since the last one, which bounds the estimate while slowing down
+    uint32_t sinceLastUs = nowUs - lastRevolutionUs;
+    if (sinceLastUs >= TIMEOUT_US) {
+        rpm = 0;
+    } else {
+        uint16_t bound = periodToRPM(sinceLastUs);
+        if (bound < rpm) rpm = bound;
+    }
+    return rpm;
+}
+
+uint16_t Tachometer::periodToRPM(uint32_t periodUs) {
+    if (periodUs == 0) return 0;
+    uint32_t value = (MICROS_PER_MINUTE + periodUs / 2) / periodUs;
+    return value > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(value);
+}
+
+/*******************************************************************************
+ * SimulatedTachSource
+ ******************************************************************************/
+
+SimulatedTachSource::SimulatedTachSource()
+    : rpm(0)
+    , revolutions(0)
+    , lastRevolutionUs(0)
+    , nextRevolutionUs(0)
+    , started(false) {
+}
+
+void SimulatedTachSource::setRPM(uint16_t value) {
+    if (value == rpm) return;
+
+    // Reschedule the next revolution from the last one at the new speed
+    if (value > 0) {
+        nextRevolutionUs = lastRevolutionUs + MICROS_PER_MINUTE / value;
+    }
+    rpm = value;
+}
+
+TachSource::Capture SimulatedTachSource::capture(uint32_t nowUs) {
+    if (!started) {
+        started = true;
+        lastRevolutionUs = nowUs;
+        nextRevolutionUs = rpm > 0 ? nowUs + MICROS_PER_MINUTE / rpm : nowUs;
+    }
+
+    if (rpm > 0 && static_cast<int32_t>(nowUs - nextRevolutionUs) >= 0) {
+        uint32_t periodUs = MICROS_PER_MINUTE / rpm;
+        uint32_t elapsed = (nowUs - nextRevolutionUs) / periodUs + 1;
+        revolutions += elapsed;
+        lastRevolutionUs = nextRevolutionUs + (elapsed - 1) * periodUs;
+        nextRevolutionUs = lastRevolutionUs + periodUs;
+    }
+
+    return Capture{revolutions, lastRevolutionUs};
+}
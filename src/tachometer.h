@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Source of fan revolution events
+ *
+ * Implementations count tachometer pulses and report completed revolutions
+ * together with the timestamp of the most recent one. The hardware backend
+ * are PcntTachSource and GpioTachSource; SimulatedTachSource generates
+ * revolutions from a commanded RPM for test mode and host-side testing.
+ */
+class TachSource {
+public:
+    /**
+     * @brief Consistent view of the revolution counter
+     */
+    struct Capture {
+        uint32_t revolutions;       ///< Completed revolutions since begin()
+        uint32_t lastRevolutionUs;  ///< Timestamp of the latest revolution
+    };
+
+    /**
+     * @brief Called on every completed revolution, from interrupt context
+     */
+    typedef void (*RevolutionHandler)(void* context);
+
+    virtual ~TachSource() = default;
+
+    virtual bool begin() = 0;
+
+    /**
+     * @brief Snapshot the revolution counter
+     * @param nowUs Current time, used by sources that are not interrupt driven
+     */
+    virtual Capture capture(uint32_t nowUs) = 0;
+
+    /**
+     * @brief Whether the tach line is currently pulled low
+     *
+     * The input idles high through its pull-up when nothing is connected.
+     * A line held low while no revolutions arrive means the fan
+     * electronics are present but the rotor does not turn.
+     */
+    virtual bool isLineLow() const { return false; }
+
+    /**
+     * @brief Get told about revolutions as they happen instead of polling
+     *
+     * Only interrupt driven sources call the handler; it must be IRAM-safe.
+     * Set before begin().
+     */
+    void setRevolutionHandler(RevolutionHandler handler, void* context) {
+        revolutionHandler = handler;
+        revolutionContext = context;
+    }
+
+protected:
+    RevolutionHandler revolutionHandler = nullptr;
+    void* revolutionContext = nullptr;
+};
+
+/**
+ * @brief Period-based RPM estimator
+ *
+ * Derives RPM from the time between revolution events rather than from a
+ * pulse count over a fixed window, so the resolution does not depend on
+ * the sampling interval and low speeds are reported within one revolution.
+ * When no revolution arrives, the estimate decays with the elapsed time
+ * and drops to zero after Config::Fan::RPM::TIMEOUT_MS.
+ *
+ * Not thread-safe; owned and updated by a single task.
+ */
+class Tachometer {
+public:
+    Tachometer();
+
+    /**
+     * @brief Attach to a source and start it
+     */
+    bool begin(TachSource* source);
+
+    /**
+     * @brief Refresh the estimate from the source
+     * @param nowUs Current time in microseconds
+     * @return Estimated RPM
+     */
+    uint16_t update(uint32_t nowUs);
+
+    uint16_t getRPM() const { return rpm; }
+    bool isLineLow() const { return source && source->isLineLow(); }
+
+private:
+    TachSource* source;
+    uint32_t lastRevolutions;
+    uint32_t lastRevolutionUs;
+    bool hasReference;
+    uint16_t rpm;
+
+    static uint16_t periodToRPM(uint32_t periodUs);
+};
+
+/**
+ * @brief Tach source synthesizing revolutions at a commanded RPM
+ */
+class SimulatedTachSource : public TachSource {
+public:
+    SimulatedTachSource();
+
+    bool begin() override { return true; }
+    Capture capture(uint32_t nowUs) override;
+
+    void setRPM(uint16_t value);
+
+private:
+    uint16_t rpm;
+    uint32_t revolutions;
+    uint32_t lastRevolutionUs;
+    uint32_t nextRevolutionUs;
+    bool started;
+};
@@ -4,6 +4,56 @@
  */
 
 #include "task_manager.h"
+#include "esp_heap_caps.h"
+#include <algorithm>
+
+namespace {
+    using namespace Config::TaskManager::StaticAllocation;
+    using Config::System::TaskMemory;
+
+    constexpr size_t aligned(size_t bytes) {
+        return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    /**
+     * @brief Bytes one task takes from a pool, as reserveStaticMemory()
+     * takes them: a stack from its own pool, two TCBs from the internal one
+     */
+    constexpr size_t poolBytes(TaskMemory pool, TaskMemory memory, uint32_t stackSize,
+                               bool created = true) {
+        if (!created || memory == TaskMemory::HEAP) return 0;
+        size_t bytes = memory == pool ? aligned(stackSize) : 0;
+        if (pool == TaskMemory::STATIC_INTERNAL) bytes += aligned(2 * sizeof(StaticTask_t));
+        return bytes;
+    }
+
+    /**
+     * @brief Pool bytes of every task that opted in and runs in this build
+     */
+    constexpr size_t staticTaskBytes(TaskMemory pool) {
+        using namespace Config;
+        return poolBytes(pool, WiFi::Task::MEMORY, WiFi::Task::STACK_SIZE, !Executor::ENABLED)
+             + poolBytes(pool, NTP::Task::MEMORY, NTP::Task::STACK_SIZE, !Executor::ENABLED)
+             + poolBytes(pool, Executor::Task::MEMORY, Executor::Task::STACK_SIZE, Executor::ENABLED)
+             + poolBytes(pool, Temperature::Task::MEMORY, Temperature::Task::STACK_SIZE)
+             + poolBytes(pool, Fan::Task::MEMORY, Fan::Task::STACK_SIZE)
+             + poolBytes(pool, MQTT::Task::MEMORY, MQTT::Task::STACK_SIZE)
+             + poolBytes(pool, History::Task::MEMORY, History::Task::STACK_SIZE)
+             + poolBytes(pool, Display::DisplayRender::MEMORY, Display::DisplayRender::STACK_SIZE)
+             + poolBytes(pool, Display::DisplayUpdate::MEMORY, Display::DisplayUpdate::STACK_SIZE);
+    }
+
+    constexpr size_t INTERNAL_POOL_BYTES = staticTaskBytes(TaskMemory::STATIC_INTERNAL);
+    constexpr size_t PSRAM_POOL_BYTES = staticTaskBytes(TaskMemory::STATIC_PSRAM);
+
+    // Static task storage in internal .bss, owned by the one TaskManager;
+    // never zero-length, the pool capacity stays exact
+    alignas(ALIGNMENT) uint8_t internalPoolStorage[INTERNAL_POOL_BYTES ? INTERNAL_POOL_BYTES : 1];
+
+#if CONFIG_SPIRAM_ALLOW_STACK_EXTERNAL_MEMORY && CONFIG_SPIRAM_ALLOW_BSS_SEG_EXTERNAL_MEMORY
+    alignas(ALIGNMENT) EXT_RAM_ATTR uint8_t psramPoolStorage[PSRAM_POOL_BYTES ? PSRAM_POOL_BYTES : 1];
+#endif
+}
 
 /*******************************************************************************
  * Construction / Destruction
@@ -35,6 +85,32 @@ esp_err_t TaskManager::begin() {
         return ESP_ERR_NO_MEM;
     }
 
+    // Pools are set up once; slots keep their storage across stop()
+    if (!internalPool.base) {
+        internalPool.base = internalPoolStorage;
+        internalPool.capacity = INTERNAL_POOL_BYTES;
+#if CONFIG_SPIRAM_ALLOW_STACK_EXTERNAL_MEMORY
+#if CONFIG_SPIRAM_ALLOW_BSS_SEG_EXTERNAL_MEMORY
+        psramPool.base = psramPoolStorage;
+#else
+        // One allocation before any other heap churn, never freed
+        if (PSRAM_POOL_BYTES > 0) {
+            psramPool.base = static_cast<uint8_t*>(
+                heap_caps_aligned_alloc(ALIGNMENT, PSRAM_POOL_BYTES, MALLOC_CAP_SPIRAM));
+        }
+#endif
+        psramPool.capacity = psramPool.base ? PSRAM_POOL_BYTES : 0;
+#endif
+    }
+
+    // Reconfigures the watchdog the startup code already runs. It only
+    // logs: resets stay with the supervisor and each task's Policy, which a
+    // panicking watchdog would turn into reboots for LOG and RESTART tasks
+    esp_err_t err = esp_task_wdt_init(Config::TaskManager::Watchdog::TIMEOUT_S, false);
+    if (err != ESP_OK) {
+        DEBUG_LOG_TASK_MANAGER("Task watchdog setup failed: %d", err);
+    }
+
     initialized = true;
     return ESP_OK;
 }
@@ -45,13 +121,17 @@ void TaskManager::stop() {
     if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
         // Clean up all active tasks
         for (size_t i = 0; i < Config::TaskManager::MAX_TASKS; i++) {
+            tasks[i].restartPending = false;
             if (tasks[i].active && tasks[i].handle) {
-                vTaskDelete(tasks[i].handle);
-                tasks[i].active = false;
-                tasks[i].handle = nullptr;
+                removeTask(i);
             }
         }
+        bool settle = hasRetiringTasks();
         xSemaphoreGive(mutex);
+
+        if (settle) {
+            settleRetiredTasks();
+        }
     }
 
     initialized = false;
@@ -62,7 +142,12 @@ void TaskManager::stop() {
  * Task Management
  ******************************************************************************/
 
-esp_err_t TaskManager::createTask(const TaskConfig& config, TaskFunction_t function, void* parameters) {
+esp_err_t TaskManager::createTask(const TaskConfig& config, TaskFunction_t function,
+                                  void* parameters, TaskId* id) {
+    if (id) {
+        *id = TaskId();
+    }
+
     if (!initialized || !mutex || !function) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -74,7 +159,7 @@ esp_err_t TaskManager::createTask(const TaskConfig& config, TaskFunction_t funct
     // Find available task slot
     int taskIndex = -1;
     for (size_t i = 0; i < Config::TaskManager::MAX_TASKS; i++) {
-        if (!tasks[i].active) {
+        if (!tasks[i].active && !tasks[i].retiring) {
             taskIndex = i;
             break;
         }
@@ -85,26 +170,39 @@ esp_err_t TaskManager::createTask(const TaskConfig& config, TaskFunction_t funct
         return ESP_ERR_NO_MEM;
     }
 
-    // Create FreeRTOS task
-    BaseType_t result = xTaskCreatePinnedToCore(
-        function,
-        config.name,
-        config.stackSize,
-        parameters,
-        config.priority,
-        &tasks[taskIndex].handle,
-        config.coreID
-    );
+    // Initialize task information; the task may run before this returns
+    tasks[taskIndex].config = config;
+    tasks[taskIndex].function = function;
+    tasks[taskIndex].parameters = parameters;
+    tasks[taskIndex].restartStreak = 0;
+    tasks[taskIndex].stallReported = false;
+    resetTaskHealth(taskIndex);
+    resetStackUsage(taskIndex);
+    timings[taskIndex].clear();
+    reserveStaticMemory(taskIndex);
+    if (id) {
+        *id = TaskId(taskIndex);
+    }
 
-    if (result != pdPASS) {
+    if (!startTask(taskIndex)) {
+        if (id) {
+            *id = TaskId();
+        }
         xSemaphoreGive(mutex);
         return ESP_ERR_NO_MEM;
     }
 
-    // Initialize task information
-    tasks[taskIndex].config = config;
     tasks[taskIndex].active = true;
-    resetTaskHealth(taskIndex);
+
+    if (config.watchdog) {
+        if (config.deadlineMs >= Config::TaskManager::Watchdog::TIMEOUT_S * 1000) {
+            DEBUG_LOG_TASK_MANAGER("%s: deadline %lu ms beyond the watchdog timeout",
+                                   config.name, config.deadlineMs);
+        }
+        if (esp_task_wdt_add(tasks[taskIndex].handle) != ESP_OK) {
+            DEBUG_LOG_TASK_MANAGER("%s: task watchdog registration failed", config.name);
+        }
+    }
 
     xSemaphoreGive(mutex);
     return ESP_OK;
@@ -127,12 +225,15 @@ esp_err_t TaskManager::deleteTask(const char* taskName) {
 
     // Delete task and clean up resources
     if (tasks[taskIndex].handle) {
-        vTaskDelete(tasks[taskIndex].handle);
-        tasks[taskIndex].handle = nullptr;
-        tasks[taskIndex].active = false;
+        removeTask(taskIndex);
     }
 
+    bool settle = hasRetiringTasks();
     xSemaphoreGive(mutex);
+
+    if (settle) {
+        settleRetiredTasks();
+    }
     return ESP_OK;
 }
 
@@ -178,13 +279,20 @@ bool TaskManager::checkTaskHealth() {
     for (size_t i = 0; i < Config::TaskManager::MAX_TASKS; i++) {
         if (tasks[i].active) {
             updateTaskHealth(i);
+            superviseTask(i);
             if (!tasks[i].health.healthy) {
                 allHealthy = false;
             }
         }
     }
 
+    bool settle = hasRetiringTasks();
     xSemaphoreGive(mutex);
+
+    // Restarts of tasks on static storage complete here
+    if (settle) {
+        settleRetiredTasks();
+    }
     return allHealthy;
 }
 
@@ -195,32 +303,284 @@ void TaskManager::updateTaskHealth(size_t taskIndex) {
     }
 
     TaskHealth& health = tasks[taskIndex].health;
+    const Heartbeat& beat = heartbeats[taskIndex];
+    // Heartbeat first, a later clock read never precedes it
+    health.lastRunTime = beat.lastRunMs.load(std::memory_order_relaxed);
     uint32_t currentTime = millis();
+
+    // Lateness statistics, written by the task itself
+    health.intervals = beat.intervals.load(std::memory_order_relaxed);
+    health.meanLateUs = health.intervals
+        ? beat.lateTotalUs.load(std::memory_order_relaxed) / health.intervals
+        : 0;
+    health.maxLateUs = beat.lateMaxUs.load(std::memory_order_relaxed);
+    health.missedDeadlines = beat.deadlineMisses.load(std::memory_order_relaxed);
     
     // Monitor stack usage
     health.stackHighWaterMark = uxTaskGetStackHighWaterMark(tasks[taskIndex].handle);
-    if (health.stackHighWaterMark < 200) {  // Critical stack threshold
-        health.consecutiveFailures++;
-        health.healthy = false;
-        return;
-    }
+    recordStackUsage(taskIndex);
+    bool stackLow = health.stackHighWaterMark < Config::TaskManager::STACK_WARNING_THRESHOLD;
 
-    // Check task state and runtime
+    // Check task state and heartbeat
     eTaskState state = eTaskGetState(tasks[taskIndex].handle);
-    const uint32_t TASK_TIMEOUT_MS = 30000;  // 30 seconds timeout
-    
-    if ((state == eRunning || state == eReady || state == eBlocked) &&
-        (currentTime - health.lastRunTime) < TASK_TIMEOUT_MS) {
-        health.missedDeadlines = 0;
+    bool alive = state == eRunning || state == eReady || state == eBlocked;
+    health.overdue = currentTime - health.lastRunTime > deadlineMs(tasks[taskIndex].config);
+
+    if (alive && !health.overdue && !stackLow) {
         health.consecutiveFailures = 0;
         health.healthy = true;
     } else {
-        health.missedDeadlines++;
         health.consecutiveFailures++;
         health.healthy = false;
     }
 }
 
+void TaskManager::recordStackUsage(size_t taskIndex) {
+    using namespace Config::TaskManager::StackSizing;
+    TaskInfo& task = tasks[taskIndex];
+    uint32_t size = task.config.stackSize;
+    uint32_t unused = task.health.stackHighWaterMark;
+    uint32_t used = size > unused ? size - unused : 0;
+    // The high water mark only ever grows while the task runs, so there is
+    // no per-interval peak to sample; a restart starts it over
+    if (used > task.stackPeak) {
+        task.stackPeak = used;
+    }
+
+    if (task.stackPeak * 100 <= size * BUDGET_PERCENT) {
+        return;
+    }
+
+    if (ENFORCE) {
+        Serial.printf("\n[TASK] %s: STACK BUDGET EXCEEDED, %lu of %lu bytes used (budget %u%%)\n",
+                      task.config.name, (unsigned long)task.stackPeak, (unsigned long)size,
+                      BUDGET_PERCENT);
+        Serial.flush();
+        abort();
+    }
+    if (!task.stackBudgetReported) {
+        Serial.printf("[TASK] %s: stack peak %lu of %lu bytes, over the %u%% budget\n",
+                      task.config.name, (unsigned long)task.stackPeak, (unsigned long)size,
+                      BUDGET_PERCENT);
+        task.stackBudgetReported = true;
+    }
+}
+
+void TaskManager::superviseTask(size_t taskIndex) {
+    TaskInfo& task = tasks[taskIndex];
+    if (!task.health.overdue) {
+        // A heartbeat since the last restart ends the streak
+        if (task.health.lastRunTime != task.startTime) {
+            task.restartStreak = 0;
+        }
+        task.stallReported = false;
+        return;
+    }
+
+    uint32_t silentMs = millis() - task.health.lastRunTime;
+    Policy policy = task.config.policy;
+    if (policy == Policy::RESTART &&
+        task.restartStreak >= Config::TaskManager::Supervisor::MAX_RESTARTS) {
+        policy = Policy::REBOOT;
+    }
+
+    switch (policy) {
+        case Policy::LOG:
+            if (!task.stallReported) {
+                Serial.printf("[TASK] %s: no heartbeat for %lu ms\n", task.config.name, silentMs);
+                task.stallReported = true;
+            }
+            break;
+
+        case Policy::RESTART:
+            Serial.printf("[TASK] %s: no heartbeat for %lu ms, restarting (%u)\n",
+                          task.config.name, silentMs, task.restartStreak + 1);
+            if (!restartTask(taskIndex)) {
+                Serial.printf("[TASK] %s: restart failed, rebooting\n", task.config.name);
+                Serial.flush();
+                esp_restart();
+            }
+            break;
+
+        case Policy::REBOOT:
+            Serial.printf("[TASK] %s: no heartbeat for %lu ms, rebooting\n", task.config.name, silentMs);
+            Serial.flush();
+            esp_restart();
+            break;
+    }
+}
+
+bool TaskManager::restartTask(size_t taskIndex) {
+    TaskInfo& task = tasks[taskIndex];
+    uint32_t restarts = task.health.restarts + 1;
+    uint8_t streak = task.restartStreak + 1;
+
+    // Resources the stalled task holds stay taken; a restart that then
+    // blocks on them runs into MAX_RESTARTS and a reboot
+    removeTask(taskIndex);
+    resetTaskHealth(taskIndex);
+    task.health.restarts = restarts;
+    task.restartStreak = streak;
+
+    // The static stack is reused once settleRetiredTasks() has waited
+    if (task.retiring) {
+        task.restartPending = true;
+        return true;
+    }
+    return resumeTask(taskIndex);
+}
+
+bool TaskManager::resumeTask(size_t taskIndex) {
+    TaskInfo& task = tasks[taskIndex];
+    if (!startTask(taskIndex)) {
+        return false;
+    }
+
+    task.active = true;
+    if (task.config.watchdog) {
+        esp_task_wdt_add(task.handle);
+    }
+    return true;
+}
+
+void TaskManager::removeTask(size_t taskIndex) {
+    TaskInfo& task = tasks[taskIndex];
+    if (task.config.watchdog) {
+        esp_task_wdt_delete(task.handle);
+    }
+    vTaskDelete(task.handle);
+    task.handle = nullptr;
+    task.active = false;
+
+    // A task running on the other core only switches out once that core
+    // takes the yield; its static stack stays out of use until then
+    task.retiring = task.staticMemory;
+}
+
+bool TaskManager::hasRetiringTasks() const {
+    for (size_t i = 0; i < Config::TaskManager::MAX_TASKS; i++) {
+        if (tasks[i].retiring) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskManager::settleRetiredTasks() {
+    // Waits without the mutex, so callers of the manager are not held up
+    vTaskDelay(1);
+
+    if (xSemaphoreTake(mutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+
+    for (size_t i = 0; i < Config::TaskManager::MAX_TASKS; i++) {
+        TaskInfo& task = tasks[i];
+        if (!task.retiring) continue;
+
+        task.retiring = false;
+        if (task.restartPending) {
+            task.restartPending = false;
+            if (!resumeTask(i)) {
+                Serial.printf("[TASK] %s: restart failed, rebooting\n", task.config.name);
+                Serial.flush();
+                esp_restart();
+            }
+        }
+    }
+
+    xSemaphoreGive(mutex);
+}
+
+bool TaskManager::startTask(size_t taskIndex) {
+    TaskInfo& task = tasks[taskIndex];
+    const TaskConfig& config = task.config;
+
+    if (task.staticMemory) {
+        // The idle task finishes deleting a task that ran on the other core
+        // later; its TCB stays linked until then, so starts alternate TCBs
+        task.tcbIndex ^= 1;
+        task.handle = xTaskCreateStaticPinnedToCore(
+            task.function,
+            config.name,
+            config.stackSize,
+            task.parameters,
+            config.priority,
+            task.stack,
+            task.tcbs[task.tcbIndex],
+            config.coreID
+        );
+        return task.handle != nullptr;
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        task.function,
+        config.name,
+        config.stackSize,
+        task.parameters,
+        config.priority,
+        &task.handle,
+        config.coreID
+    );
+    if (result != pdPASS) {
+        task.handle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void TaskManager::reserveStaticMemory(size_t taskIndex) {
+    TaskInfo& task = tasks[taskIndex];
+    const TaskConfig& config = task.config;
+    task.staticMemory = false;
+    if (config.memory == Memory::HEAP) {
+        return;
+    }
+
+    // TCBs must be internal whatever the stack's pool
+    if (!task.tcbs[0]) {
+        auto* tcbs = static_cast<StaticTask_t*>(internalPool.reserve(2 * sizeof(StaticTask_t)));
+        if (!tcbs) {
+            Serial.printf("[TASK] %s: static pool exhausted, allocating from the heap\n", config.name);
+            return;
+        }
+        task.tcbs[0] = &tcbs[0];
+        task.tcbs[1] = &tcbs[1];
+    }
+
+    // A stack an earlier task in this slot left is reused if large enough
+    if (!task.stack || task.stackBytes < config.stackSize) {
+        Memory region = config.memory;
+        void* stack = region == Memory::STATIC_PSRAM ? psramPool.reserve(config.stackSize) : nullptr;
+        if (!stack) {
+            region = Memory::STATIC_INTERNAL;
+            stack = internalPool.reserve(config.stackSize);
+        }
+        if (!stack) {
+            Serial.printf("[TASK] %s: static pool exhausted, allocating from the heap\n", config.name);
+            return;
+        }
+        if (region != config.memory) {
+            Serial.printf("[TASK] %s: no PSRAM stack, using the internal pool\n", config.name);
+        }
+        task.stack = static_cast<StackType_t*>(stack);
+        task.stackBytes = config.stackSize;
+        task.stackMemory = region;
+    }
+
+    task.staticMemory = true;
+}
+
+void* TaskManager::Pool::reserve(size_t bytes) {
+    using Config::TaskManager::StaticAllocation::ALIGNMENT;
+    size_t start = (used + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (!base || start + bytes > capacity) {
+        return nullptr;
+    }
+    used = start + bytes;
+    return base + start;
+}
+
 void TaskManager::dumpTaskStatus() {
     if (!initialized || !mutex) {
         DEBUG_LOG_TASK_MANAGER("Task Manager not initialized!");
@@ -239,9 +599,18 @@ void TaskManager::dumpTaskStatus() {
             DEBUG_LOG_TASK_MANAGER("\nTask: %s\n", tasks[i].config.name);
             DEBUG_LOG_TASK_MANAGER("State: %d\n", eTaskGetState(tasks[i].handle));
             DEBUG_LOG_TASK_MANAGER("Priority: %d\n", tasks[i].config.priority);
+            DEBUG_LOG_TASK_MANAGER("Memory: %s\n", memoryToString(
+                tasks[i].staticMemory ? tasks[i].stackMemory : Memory::HEAP));
             DEBUG_LOG_TASK_MANAGER("Stack High Water: %d\n", tasks[i].health.stackHighWaterMark);
             DEBUG_LOG_TASK_MANAGER("Last Run: %lu ms ago\n", millis() - tasks[i].health.lastRunTime);
+            DEBUG_LOG_TASK_MANAGER("Period: %lu ms, Deadline: %lu ms, Policy: %s\n",
+                                   tasks[i].config.periodMs, deadlineMs(tasks[i].config),
+                                   policyToString(tasks[i].config.policy));
+            DEBUG_LOG_TASK_MANAGER("Late: mean %lu us, max %lu us (%lu intervals)\n",
+                                   tasks[i].health.meanLateUs, tasks[i].health.maxLateUs,
+                                   tasks[i].health.intervals);
             DEBUG_LOG_TASK_MANAGER("Missed Deadlines: %lu\n", tasks[i].health.missedDeadlines);
+            DEBUG_LOG_TASK_MANAGER("Restarts: %lu\n", tasks[i].health.restarts);
             DEBUG_LOG_TASK_MANAGER("Consecutive Failures: %lu\n", tasks[i].health.consecutiveFailures);
             DEBUG_LOG_TASK_MANAGER("Health: %s\n", tasks[i].health.healthy ? "HEALTHY" : "UNHEALTHY");
         }
@@ -252,15 +621,248 @@ void TaskManager::dumpTaskStatus() {
     xSemaphoreGive(mutex);
 }
 
-void TaskManager::updateTaskRunTime(const char* taskName) {
-    if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
-        int taskIndex = findTaskIndex(taskName);
-        if (taskIndex >= 0) {
-            tasks[taskIndex].health.lastRunTime = millis();
-            tasks[taskIndex].health.consecutiveFailures = 0;
+void TaskManager::printMemoryBudget() {
+    if (!initialized || !mutex) {
+        return;
+    }
+
+    if (xSemaphoreTake(mutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+
+    Serial.println("\n=== Task Memory Budget ===");
+    Serial.printf("%-16s %-9s %6s %6s %7s\n", "Task", "Memory", "Stack", "TCB", "Unused");
+
+    size_t heapBytes = 0;
+    for (size_t i = 0; i < Config::TaskManager::MAX_TASKS; i++) {
+        const TaskInfo& task = tasks[i];
+        if (!task.active || !task.handle) continue;
+
+        Memory memory = task.staticMemory ? task.stackMemory : Memory::HEAP;
+        size_t tcbBytes = (task.staticMemory ? 2 : 1) * sizeof(StaticTask_t);
+        if (!task.staticMemory) {
+            heapBytes += task.config.stackSize + tcbBytes;
         }
-        xSemaphoreGive(mutex);
+        Serial.printf("%-16s %-9s %6lu %6u %7u\n",
+                      task.config.name, memoryToString(memory),
+                      (unsigned long)task.config.stackSize, (unsigned)tcbBytes,
+                      (unsigned)uxTaskGetStackHighWaterMark(task.handle));
+    }
+
+    Serial.printf("Internal pool: %u of %u bytes\n",
+                  (unsigned)internalPool.used, (unsigned)internalPool.capacity);
+    Serial.printf("PSRAM pool:    %u of %u bytes\n",
+                  (unsigned)psramPool.used, (unsigned)psramPool.capacity);
+    Serial.printf("Heap tasks:    %u bytes\n", (unsigned)heapBytes);
+
+    // Largest block against free space shows the fragmentation
+    const uint32_t internalCaps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    Serial.printf("Internal heap: %u free, %u largest block, %u lowest\n",
+                  (unsigned)heap_caps_get_free_size(internalCaps),
+                  (unsigned)heap_caps_get_largest_free_block(internalCaps),
+                  (unsigned)heap_caps_get_minimum_free_size(internalCaps));
+    if (heap_caps_get_total_size(MALLOC_CAP_SPIRAM)) {
+        Serial.printf("PSRAM heap:    %u free, %u largest block, %u lowest\n",
+                      (unsigned)heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+                      (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM),
+                      (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM));
+    }
+    Serial.println("==========================\n");
+
+    xSemaphoreGive(mutex);
+}
+
+size_t TaskManager::getStackUsage(StackUsage* usage, size_t maxTasks) {
+    if (!initialized || !mutex || !usage) {
+        return 0;
     }
+
+    if (xSemaphoreTake(mutex, portMAX_DELAY) != pdTRUE) {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < Config::TaskManager::MAX_TASKS && count < maxTasks; i++) {
+        const TaskInfo& task = tasks[i];
+        if (!task.active) continue;
+
+        StackUsage& entry = usage[count++];
+        entry.name = task.config.name;
+        entry.size = task.config.stackSize;
+        entry.peak = task.stackPeak;
+        entry.recommended = recommendedStackSize(task.stackPeak);
+    }
+
+    xSemaphoreGive(mutex);
+    return count;
+}
+
+void TaskManager::printStackReport() {
+    StackUsage usage[Config::TaskManager::MAX_TASKS];
+    size_t count = getStackUsage(usage, Config::TaskManager::MAX_TASKS);
+    if (!count) {
+        return;
+    }
+
+    Serial.println("\n=== Stack Report ===");
+    Serial.printf("%-16s %6s %6s %5s %6s\n", "Task", "Size", "Peak", "Use", "Rec.");
+
+    uint32_t reclaimable = 0;
+    for (size_t i = 0; i < count; i++) {
+        const StackUsage& entry = usage[i];
+        Serial.printf("%-16s %6lu %6lu %4lu%% %6lu\n",
+                      entry.name, (unsigned long)entry.size, (unsigned long)entry.peak,
+                      (unsigned long)(entry.peak * 100 / entry.size),
+                      (unsigned long)entry.recommended);
+        reclaimable += entry.reclaimable();
+    }
+
+    Serial.printf("Recommended sizes reclaim %lu bytes (%u%% margin)\n",
+                  (unsigned long)reclaimable, Config::TaskManager::StackSizing::MARGIN_PERCENT);
+    Serial.println("====================\n");
+}
+
+size_t TaskManager::getTaskTiming(TaskTiming* timing, size_t maxTasks, bool reset) {
+    if (!initialized || !mutex || !timing) {
+        return 0;
+    }
+
+    if (xSemaphoreTake(mutex, portMAX_DELAY) != pdTRUE) {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < Config::TaskManager::MAX_TASKS && count < maxTasks; i++) {
+        const TaskInfo& task = tasks[i];
+        if (!task.active) continue;
+
+        TaskTiming& entry = timing[count++];
+        entry.name = task.config.name;
+        entry.periodMs = task.config.periodMs;
+        timings[i].period.getPercentiles(entry.period);
+        timings[i].execution.getPercentiles(entry.execution);
+        if (reset) {
+            timings[i].resetRequested.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    xSemaphoreGive(mutex);
+    return count;
+}
+
+void TaskManager::printTimingReport() {
+    TaskTiming timing[Config::TaskManager::MAX_TASKS];
+    size_t count = getTaskTiming(timing, Config::TaskManager::MAX_TASKS);
+    if (!count) {
+        return;
+    }
+
+    Serial.println("\n=== Loop Timing (us) ===");
+    Serial.printf("%-16s %6s %8s %8s %8s %8s %8s %8s\n",
+                  "Task", "Period", "p50", "p99", "max", "exec p50", "p99", "max");
+
+    for (size_t i = 0; i < count; i++) {
+        const TaskTiming& entry = timing[i];
+        Serial.printf("%-16s %6lu %8lu %8lu %8lu %8lu %8lu %8lu\n",
+                      entry.name, (unsigned long)entry.periodMs,
+                      (unsigned long)entry.period.p50Us, (unsigned long)entry.period.p99Us,
+                      (unsigned long)entry.period.maxUs,
+                      (unsigned long)entry.execution.p50Us, (unsigned long)entry.execution.p99Us,
+                      (unsigned long)entry.execution.maxUs);
+    }
+    Serial.println("========================\n");
+}
+
+uint32_t TaskManager::recommendedStackSize(uint32_t peak) {
+    using namespace Config::TaskManager::StackSizing;
+    uint32_t size = peak + peak * MARGIN_PERCENT / 100;
+    size = (size + ROUND_BYTES - 1) / ROUND_BYTES * ROUND_BYTES;
+    return std::max(size, MIN_BYTES);
+}
+
+/*******************************************************************************
+ * Loop Timing Histograms
+ ******************************************************************************/
+
+void TaskManager::Histogram::record(uint32_t durationUs) {
+    using namespace Config::TaskManager::LoopTiming;
+    constexpr uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    // Linear up to SUB_BUCKETS units, then the top SUB_BUCKET_BITS + 1
+    // bits select the bucket within the power of two
+    uint32_t units = durationUs / UNIT_US;
+    uint32_t bucket = units;
+    if (units >= SUB_BUCKETS) {
+        uint32_t shift = 31 - __builtin_clz(units) - SUB_BUCKET_BITS;
+        bucket = shift * SUB_BUCKETS + (units >> shift);
+    }
+    if (bucket >= BUCKETS) {
+        bucket = BUCKETS - 1;
+    }
+
+    // Single writer, relaxed load and store suffice
+    buckets[bucket].store(buckets[bucket].load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+    if (durationUs > maxUs.load(std::memory_order_relaxed)) {
+        maxUs.store(durationUs, std::memory_order_relaxed);
+    }
+}
+
+void TaskManager::Histogram::clear() {
+    for (uint8_t bucket = 0; bucket < BUCKETS; bucket++) {
+        buckets[bucket].store(0, std::memory_order_relaxed);
+    }
+    maxUs.store(0, std::memory_order_relaxed);
+}
+
+void TaskManager::Histogram::getPercentiles(Percentiles& percentiles) const {
+    uint32_t counts[BUCKETS];
+    uint32_t total = 0;
+    for (uint8_t bucket = 0; bucket < BUCKETS; bucket++) {
+        counts[bucket] = buckets[bucket].load(std::memory_order_relaxed);
+        total += counts[bucket];
+    }
+
+    percentiles.count = total;
+    percentiles.maxUs = maxUs.load(std::memory_order_relaxed);
+
+    const uint8_t percents[] = {50, 95, 99};
+    uint32_t* results[] = {&percentiles.p50Us, &percentiles.p95Us, &percentiles.p99Us};
+    for (uint8_t i = 0; i < 3; i++) {
+        *results[i] = 0;
+        if (!total) continue;
+
+        uint32_t target = (static_cast<uint64_t>(total) * percents[i] + 99) / 100;
+        uint32_t cumulative = 0;
+        uint8_t bucket = 0;
+        for (; bucket < BUCKETS - 1; bucket++) {
+            cumulative += counts[bucket];
+            if (cumulative >= target) break;
+        }
+
+        // The bound overshoots the slowest sample in its bucket at most
+        uint32_t limitUs = bucket < BUCKETS - 1 ? bucketLimitUs(bucket) : UINT32_MAX;
+        *results[i] = std::min(limitUs, percentiles.maxUs);
+    }
+}
+
+uint32_t TaskManager::Histogram::bucketLimitUs(uint8_t bucket) {
+    using namespace Config::TaskManager::LoopTiming;
+    constexpr uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    if (bucket < SUB_BUCKETS) {
+        return (bucket + 1) * UNIT_US;
+    }
+    uint32_t shift = bucket / SUB_BUCKETS - 1;
+    uint32_t mantissa = bucket % SUB_BUCKETS + SUB_BUCKETS;
+    return ((mantissa + 1) << shift) * UNIT_US;
+}
+
+void TaskManager::LoopTiming::clear() {
+    period.clear();
+    execution.clear();
+    working = false;
+    resetRequested.store(false, std::memory_order_relaxed);
 }
 
 /*******************************************************************************
@@ -278,6 +880,49 @@ int TaskManager::findTaskIndex(const char* taskName) const {
 
 void TaskManager::resetTaskHealth(size_t taskIndex) {
     if (taskIndex < Config::TaskManager::MAX_TASKS) {
+        const TaskConfig& config = tasks[taskIndex].config;
         tasks[taskIndex].health = TaskHealth();
+        tasks[taskIndex].startTime = millis();
+
+        // Set up before the task runs; creation counts as the first heartbeat
+        Heartbeat& beat = heartbeats[taskIndex];
+        beat.intervals.store(0, std::memory_order_relaxed);
+        beat.lateTotalUs.store(0, std::memory_order_relaxed);
+        beat.lateMaxUs.store(0, std::memory_order_relaxed);
+        beat.deadlineMisses.store(0, std::memory_order_relaxed);
+        beat.lastRunUs = 0;
+        beat.lastFeedMs = 0;
+        beat.periodUs = config.periodMs * 1000;
+        beat.deadlineUs = config.deadlineMs * 1000;
+        beat.watchdog = config.watchdog;
+        beat.lastRunMs.store(tasks[taskIndex].startTime, std::memory_order_relaxed);
+    }
+}
+
+void TaskManager::resetStackUsage(size_t taskIndex) {
+    TaskInfo& task = tasks[taskIndex];
+    task.stackPeak = 0;
+    task.stackBudgetReported = false;
+}
+
+uint32_t TaskManager::deadlineMs(const TaskConfig& config) {
+    return config.deadlineMs ? config.deadlineMs : Config::TaskManager::DEFAULT_DEADLINE_MS;
+}
+
+const char* TaskManager::policyToString(Policy policy) {
+    switch (policy) {
+        case Policy::LOG:     return "log";
+        case Policy::RESTART: return "restart";
+        case Policy::REBOOT:  return "reboot";
+        default:              return "unknown";
     }
-}
\ No newline at end of file
+}
+
+const char* TaskManager::memoryToString(Memory memory) {
+    switch (memory) {
+        case Memory::HEAP:            return "heap";
+        case Memory::STATIC_INTERNAL: return "internal";
+        case Memory::STATIC_PSRAM:    return "psram";
+        default:                      return "unknown";
+    }
+}
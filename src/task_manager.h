@@ -2,12 +2,15 @@
 #define TASK_MANAGER_H
 
 #include <Arduino.h>
+#include <atomic>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "freertos/event_groups.h"
 #include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_task_wdt.h"
 #include "config.h"
 #include "debug_log.h"
 
@@ -16,6 +19,14 @@
  * 
  * Features:
  * - Task creation and lifecycle management
+ * - Lock-free O(1) heartbeats addressed by TaskId
+ * - Per-task period and deadline with lateness and deadline miss statistics
+ * - Supervisor policy per task: log, restart the task or reboot
+ * - Hardware task watchdog registration, fed from the heartbeat
+ * - Opt-in static stacks and TCBs from internal .bss or PSRAM pools
+ * - Boot-time memory budget of every task
+ * - Stack high water per task with recommended stack sizes
+ * - Per-task histograms of the wake-to-wake period and execution time
  * - Task health monitoring and status reporting
  * - Resource management (queues, semaphores, event groups)
  * - System health monitoring
@@ -25,11 +36,19 @@ public:
     //--------------------------------------------------------------------------
     // Types & Structures
     //--------------------------------------------------------------------------
+    using Policy = Config::System::TaskPolicy;
+    using Memory = Config::System::TaskMemory;
+
     struct TaskHealth {
         uint32_t lastRunTime;          ///< Last recorded runtime timestamp
-        uint32_t missedDeadlines;      ///< Count of missed execution deadlines
+        uint32_t missedDeadlines;      ///< Heartbeat gaps longer than the deadline
         uint32_t consecutiveFailures;   ///< Count of consecutive health check failures
         UBaseType_t stackHighWaterMark; ///< Lowest free stack space observed
+        uint32_t intervals;             ///< Heartbeat gaps measured against the period
+        uint32_t meanLateUs;            ///< Mean lateness past the period
+        uint32_t maxLateUs;             ///< Worst lateness past the period
+        uint32_t restarts;              ///< Restarts by the supervisor
+        bool overdue;                   ///< No heartbeat within the deadline
         bool healthy;                   ///< Current health status
 
         TaskHealth() 
@@ -37,26 +56,108 @@ public:
             , missedDeadlines(0)
             , consecutiveFailures(0)
             , stackHighWaterMark(0)
+            , intervals(0)
+            , meanLateUs(0)
+            , maxLateUs(0)
+            , restarts(0)
+            , overdue(false)
             , healthy(true) {}
     };
 
+    /**
+     * @brief Stack use of a task, across its restarts
+     */
+    struct StackUsage {
+        const char* name;
+        uint32_t size;              ///< Configured stack size in bytes
+        uint32_t peak;              ///< Most bytes ever in use
+        uint32_t recommended;       ///< Peak plus margin, rounded
+
+        /**
+         * @brief Bytes the recommended size would free, 0 before a sample
+         */
+        uint32_t reclaimable() const {
+            return peak && size > recommended ? size - recommended : 0;
+        }
+    };
+
+    /**
+     * @brief Percentiles of a histogram, as the upper bound of the bucket
+     * they fall in; at most 1/2^SUB_BUCKET_BITS above the true value
+     */
+    struct Percentiles {
+        uint32_t count;
+        uint32_t p50Us;
+        uint32_t p95Us;
+        uint32_t p99Us;
+        uint32_t maxUs;
+    };
+
+    /**
+     * @brief Loop timing of a task, since its creation or the last reset
+     */
+    struct TaskTiming {
+        const char* name;
+        uint32_t periodMs;          ///< Configured period, 0 if not periodic
+        Percentiles period;         ///< Heartbeat to heartbeat
+        Percentiles execution;      ///< Heartbeat to workDone()
+    };
+
+    /**
+     * @brief Slot of a managed task, handed out by createTask()
+     *
+     * Indexes the heartbeat table directly, so a heartbeat needs neither a
+     * name lookup nor the manager mutex. Default constructed ids are
+     * invalid and their heartbeats are ignored.
+     */
+    class TaskId {
+    public:
+        TaskId() : slot(INVALID) {}
+        bool isValid() const { return slot != INVALID; }
+        uint8_t index() const { return slot; }
+
+    private:
+        friend class TaskManager;
+        static constexpr uint8_t INVALID = 0xFF;
+        explicit TaskId(uint8_t index) : slot(index) {}
+        uint8_t slot;
+    };
+
     struct TaskConfig {
         const char* name;       ///< Task identifier name
         uint32_t stackSize;     ///< Stack size in bytes
         UBaseType_t priority;   ///< Task priority (0-configMAX_PRIORITIES)
         BaseType_t coreID;      ///< Core affinity (-1 for no affinity)
+        uint32_t periodMs;      ///< Expected heartbeat period, 0 if not periodic
+        uint32_t deadlineMs;    ///< Longest tolerated heartbeat gap, 0 for the default
+        Policy policy;          ///< Supervisor action once the deadline has passed
+        bool watchdog;          ///< Register with the hardware task watchdog
+        Memory memory;          ///< Stack and TCB allocation
         
         TaskConfig() 
             : name("")
             , stackSize(0)
             , priority(0)
-            , coreID(0) {}
+            , coreID(0)
+            , periodMs(0)
+            , deadlineMs(0)
+            , policy(Policy::LOG)
+            , watchdog(false)
+            , memory(Memory::HEAP) {}
         
-        TaskConfig(const char* taskName, uint32_t stack, UBaseType_t prio, BaseType_t core)
+        TaskConfig(const char* taskName, uint32_t stack, UBaseType_t prio, BaseType_t core,
+                   uint32_t period = 0, uint32_t deadline = 0,
+                   Policy supervisorPolicy = Policy::LOG, bool useWatchdog = false,
+                   Memory taskMemory = Memory::HEAP)
             : name(taskName)
             , stackSize(stack)
             , priority(prio)
-            , coreID(core) {}
+            , coreID(core)
+            , periodMs(period)
+            , deadlineMs(deadline)
+            , policy(supervisorPolicy)
+            , watchdog(useWatchdog)
+            , memory(taskMemory) {}
     };
 
     //--------------------------------------------------------------------------
@@ -78,7 +179,17 @@ public:
     //--------------------------------------------------------------------------
     // Task Management
     //--------------------------------------------------------------------------
-    esp_err_t createTask(const TaskConfig& config, TaskFunction_t function, void* parameters = nullptr);
+    /**
+     * @brief Create a task in a free slot
+     * @param id Receives the slot before the task starts, so the task can
+     *           heartbeat from its first iteration; invalid on failure
+     *
+     * Static tasks take their stack and TCBs from the pools on first use
+     * of a slot and keep them for good; when a pool runs out the task
+     * falls back to the heap and the memory budget shows it.
+     */
+    esp_err_t createTask(const TaskConfig& config, TaskFunction_t function,
+                         void* parameters = nullptr, TaskId* id = nullptr);
     esp_err_t deleteTask(const char* taskName);
     esp_err_t suspendTask(const char* taskName);
     esp_err_t resumeTask(const char* taskName);
@@ -86,10 +197,127 @@ public:
     //--------------------------------------------------------------------------
     // Health Monitoring
     //--------------------------------------------------------------------------
+    /**
+     * @brief Update the health of every task and apply its policy
+     *
+     * A task without a heartbeat within its deadline is overdue. LOG
+     * reports it once, RESTART deletes and recreates it and REBOOT
+     * restarts the system. A task restarted MAX_RESTARTS times in a row
+     * without a heartbeat in between is escalated to a reboot, which also
+     * covers a task that stalled holding a mutex its restart then waits on.
+     * Call every Supervisor::CHECK_INTERVAL_MS.
+     *
+     * @return true if every task is healthy
+     */
     bool checkTaskHealth();
     void dumpTaskStatus();
+
+    /**
+     * @brief Print where every task's stack and TCB live, pool usage and
+     * heap fragmentation; call once all tasks are created
+     */
+    void printMemoryBudget();
+
+    /**
+     * @brief Stack use of every task
+     * @return Number of entries written
+     */
+    size_t getStackUsage(StackUsage* usage, size_t maxTasks);
+
+    /**
+     * @brief Print size, peak and recommended size of every stack, and
+     * the bytes the recommendations would reclaim
+     */
+    void printStackReport();
+
+    /**
+     * @brief Peak plus StackSizing::MARGIN_PERCENT, rounded up
+     */
+    static uint32_t recommendedStackSize(uint32_t peak);
+
+    /**
+     * @brief Loop timing of every task
+     * @param reset Start a new window; each task clears its histograms at
+     *              its next heartbeat, so the entries cover the old one
+     * @return Number of entries written
+     */
+    size_t getTaskTiming(TaskTiming* timing, size_t maxTasks, bool reset = false);
+
+    /**
+     * @brief Print period and execution percentiles of every task
+     */
+    void printTimingReport();
     bool isSystemHealthy() const { return initialized && !suspended; }
-    void updateTaskRunTime(const char* taskName);
+
+    /**
+     * @brief Mark the task alive, called once per loop iteration
+     *
+     * Relaxed atomic stores into the task's own cache lines: no lock, no
+     * lookup, safe at any rate. The gap since the previous heartbeat is
+     * checked against the period and deadline, and the hardware watchdog
+     * is fed once per FEED_INTERVAL_MS. The gap also goes to the period
+     * histogram, so call it right after the task wakes. Only the task
+     * itself may call it.
+     */
+    void heartbeat(TaskId id) {
+        if (id.slot >= Config::TaskManager::MAX_TASKS) return;
+
+        Heartbeat& beat = heartbeats[id.slot];
+        LoopTiming& timing = timings[id.slot];
+        int64_t now = esp_timer_get_time();
+        uint32_t nowUs = static_cast<uint32_t>(now);
+        uint32_t nowMs = static_cast<uint32_t>(now / 1000);
+        beat.lastRunMs.store(nowMs, std::memory_order_relaxed);
+
+        if (timing.resetRequested.load(std::memory_order_relaxed)) {
+            timing.clear();
+        }
+
+        // The first heartbeat after a start has no gap to measure
+        if (beat.lastRunUs) {
+            uint32_t gap = nowUs - beat.lastRunUs;
+            timing.period.record(gap);
+            if (beat.periodUs) {
+                uint32_t late = gap > beat.periodUs ? gap - beat.periodUs : 0;
+                uint32_t total = beat.lateTotalUs.load(std::memory_order_relaxed);
+                beat.lateTotalUs.store(total + late >= total ? total + late : UINT32_MAX,
+                                       std::memory_order_relaxed);
+                if (late > beat.lateMaxUs.load(std::memory_order_relaxed)) {
+                    beat.lateMaxUs.store(late, std::memory_order_relaxed);
+                }
+                beat.intervals.store(beat.intervals.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+            }
+            if (beat.deadlineUs && gap > beat.deadlineUs) {
+                beat.deadlineMisses.store(beat.deadlineMisses.load(std::memory_order_relaxed) + 1,
+                                          std::memory_order_relaxed);
+            }
+        }
+        beat.lastRunUs = nowUs ? nowUs : 1;
+        timing.working = true;
+
+        if (beat.watchdog && nowMs - beat.lastFeedMs >= Config::TaskManager::Watchdog::FEED_INTERVAL_MS) {
+            esp_task_wdt_reset();
+            beat.lastFeedMs = nowMs;
+        }
+    }
+
+    /**
+     * @brief Mark the end of the iteration's work, right before the task
+     * blocks again
+     *
+     * The time since the heartbeat goes to the execution histogram;
+     * without it only the period is recorded. Only the task itself may
+     * call it.
+     */
+    void workDone(TaskId id) {
+        if (id.slot >= Config::TaskManager::MAX_TASKS) return;
+
+        LoopTiming& timing = timings[id.slot];
+        if (!timing.working) return;
+        timing.working = false;
+        timing.execution.record(static_cast<uint32_t>(esp_timer_get_time()) - heartbeats[id.slot].lastRunUs);
+    }
 
     //--------------------------------------------------------------------------
     // Resource Management
@@ -106,9 +334,122 @@ private:
         TaskHandle_t handle;   ///< FreeRTOS task handle
         TaskHealth health;     ///< Health monitoring data
         TaskConfig config;     ///< Task configuration
+        TaskFunction_t function;  ///< Entry point, kept for restarts
+        void* parameters;      ///< Entry point argument, kept for restarts
+        uint32_t startTime;    ///< Creation or last restart
+        uint8_t restartStreak; ///< Restarts without a heartbeat in between
+        bool stallReported;    ///< Current stall already logged
         bool active;           ///< Task status flag
+        bool retiring;         ///< Deleted, static stack not yet reusable
+        bool restartPending;   ///< Start again once no longer retiring
+
+        // Static storage, reserved for the slot and reused by later tasks in it
+        StackType_t* stack;
+        uint32_t stackBytes;   ///< Size reserved for the slot
+        Memory stackMemory;    ///< Pool the stack came from
+        StaticTask_t* tcbs[2]; ///< Alternated on every start
+        uint8_t tcbIndex;
+        bool staticMemory;     ///< Current task runs on the static storage
+
+        // Stack high water, kept across restarts
+        uint32_t stackPeak;    ///< Most bytes in use
+        bool stackBudgetReported;
+
+        TaskInfo()
+            : handle(nullptr)
+            , function(nullptr)
+            , parameters(nullptr)
+            , startTime(0)
+            , restartStreak(0)
+            , stallReported(false)
+            , active(false)
+            , retiring(false)
+            , restartPending(false)
+            , stack(nullptr)
+            , stackBytes(0)
+            , stackMemory(Memory::HEAP)
+            , tcbs{}
+            , tcbIndex(0)
+            , staticMemory(false)
+            , stackPeak(0)
+            , stackBudgetReported(false) {}
+    };
+
+    /**
+     * @brief Bump allocator over one static region, never frees
+     */
+    struct Pool {
+        uint8_t* base;
+        size_t capacity;
+        size_t used;
+
+        Pool() : base(nullptr), capacity(0), used(0) {}
+        void* reserve(size_t bytes);
+    };
+
+    // Written by the task without the mutex, read by the supervisor.
+    // Aligned to cache lines so tasks on both cores never contend for
+    // the same line; the plain fields belong to the task alone once it
+    // runs and are set up before it starts.
+    struct alignas(Config::TaskManager::CACHE_LINE_SIZE) Heartbeat {
+        std::atomic<uint32_t> lastRunMs;
+        std::atomic<uint32_t> intervals;
+        std::atomic<uint32_t> lateTotalUs;    // Saturates
+        std::atomic<uint32_t> lateMaxUs;
+        std::atomic<uint32_t> deadlineMisses;
+        uint32_t lastRunUs;                   // 0 before the first heartbeat
+        uint32_t lastFeedMs;
+        uint32_t periodUs;
+        uint32_t deadlineUs;
+        bool watchdog;
+
+        Heartbeat()
+            : lastRunMs(0)
+            , intervals(0)
+            , lateTotalUs(0)
+            , lateMaxUs(0)
+            , deadlineMisses(0)
+            , lastRunUs(0)
+            , lastFeedMs(0)
+            , periodUs(0)
+            , deadlineUs(0)
+            , watchdog(false) {}
+    };
+
+    /**
+     * @brief Log-linear histogram of durations, written by one task only
+     *
+     * Bucket b below 2^SUB_BUCKET_BITS holds b UNIT_US steps; above, every
+     * power of two is split into 2^SUB_BUCKET_BITS buckets. The last
+     * bucket holds everything longer. Readers sum the buckets instead of
+     * keeping a count, so a read racing a record stays consistent.
+     */
+    struct Histogram {
+        static constexpr uint8_t BUCKETS = Config::TaskManager::LoopTiming::BUCKETS;
+
+        std::atomic<uint32_t> buckets[BUCKETS];
+        std::atomic<uint32_t> maxUs;
+
+        Histogram() : buckets{}, maxUs(0) {}
+        void record(uint32_t durationUs);
+        void clear();
+        void getPercentiles(Percentiles& percentiles) const;
+
+        /**
+         * @brief Exclusive upper bound of a bucket
+         */
+        static uint32_t bucketLimitUs(uint8_t bucket);
+    };
+
+    // Written by the task, like its heartbeat, on cache lines of its own
+    struct alignas(Config::TaskManager::CACHE_LINE_SIZE) LoopTiming {
+        Histogram period;
+        Histogram execution;
+        std::atomic<bool> resetRequested;     // Cleared by the task at its next heartbeat
+        bool working;                         // Heartbeat seen, workDone() not yet
 
-        TaskInfo() : handle(nullptr), active(false) {}
+        LoopTiming() : resetRequested(false), working(false) {}
+        void clear();
     };
 
     //--------------------------------------------------------------------------
@@ -118,13 +459,30 @@ private:
     bool suspended;                                   ///< System suspension state
     SemaphoreHandle_t mutex;                          ///< Protection for shared resources
     TaskInfo tasks[Config::TaskManager::MAX_TASKS];   ///< Task tracking array
+    Heartbeat heartbeats[Config::TaskManager::MAX_TASKS];  ///< Indexed by TaskId
+    LoopTiming timings[Config::TaskManager::MAX_TASKS];    ///< Indexed by TaskId
+    Pool internalPool;                                ///< Static stacks and all static TCBs
+    Pool psramPool;                                   ///< Static stacks only, empty without PSRAM stacks
 
     //--------------------------------------------------------------------------
     // Internal Methods
     //--------------------------------------------------------------------------
     void updateTaskHealth(size_t taskIndex);
+    void superviseTask(size_t taskIndex);
+    void recordStackUsage(size_t taskIndex);
+    void resetStackUsage(size_t taskIndex);
+    bool restartTask(size_t taskIndex);
+    bool resumeTask(size_t taskIndex);
+    void removeTask(size_t taskIndex);
+    bool hasRetiringTasks() const;
+    void settleRetiredTasks();
     int findTaskIndex(const char* taskName) const;
     void resetTaskHealth(size_t taskIndex);
+    bool startTask(size_t taskIndex);
+    void reserveStaticMemory(size_t taskIndex);
+    static const char* memoryToString(Memory memory);
+    static uint32_t deadlineMs(const TaskConfig& config);
+    static const char* policyToString(Policy policy);
 };
 
 #endif // TASK_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,208 @@
+/**
+ * @file temp_acquisition.cpp
+ * @brief Implementation of the temperature acquisition state machine
+ */
+
+#include "temp_acquisition.h"
+#include "debug_log.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+/*******************************************************************************
+ * Construction
+ ******************************************************************************/
+
+TempAcquisition::TempAcquisition(TemperatureSource& temperatureSource, const Clock& timeSource, Listener& sampleListener)
+    : source(temperatureSource)
+    , clock(timeSource)
+    , listener(sampleListener)
+    , phase(Phase::IDLE)
+    , phaseStartUs(0)
+    , cycleStartUs(0)
+    , started(false)
+    , sample{}
+    , histograms{}
+    , rateTemp(Config::Temperature::DEFAULT_VALUE)
+    , rateTimeUs(0)
+    , rateBits(Config::Temperature::Resolution::DEFAULT_BITS)
+    , haveRate(false)
+    , stableSamples(0) {
+}
+
+/*******************************************************************************
+ * State Machine
+ ******************************************************************************/
+
+uint32_t TempAcquisition::step() {
+    uint32_t nowUs = clock.nowUs();
+
+    switch (phase) {
+        case Phase::IDLE: {
+            if (started) {
+                uint32_t elapsedUs = nowUs - cycleStartUs;
+                uint32_t intervalUs = getSampleIntervalMs() * 1000;
+                if (elapsedUs < intervalUs) {
+                    return (intervalUs - elapsedUs + 999) / 1000;
+                }
+            }
+
+            // Skip ROM: every probe converts at once
+            source.requestConversion();
+            cycleStartUs = nowUs;
+            enterPhase(Phase::CONVERTING, nowUs);
+            started = true;
+            return Config::Temperature::Resolution::POLL_MS;
+        }
+
+        case Phase::CONVERTING: {
+            // Parasite powered probes never report completion, the datasheet time bounds the wait
+            uint32_t conversionUs = source.maxConversionMs() * 1000;
+            if (nowUs - phaseStartUs < conversionUs && !source.isConversionComplete()) {
+                return Config::Temperature::Resolution::POLL_MS;
+            }
+            enterPhase(Phase::READING, nowUs);
+            return 0;
+        }
+
+        case Phase::READING: {
+            sample.validCount = source.readAll();
+            sample.resolution = source.getResolution();
+            sample.controlTemp = -FLT_MAX;
+            for (uint8_t i = 0; i < source.getCount(); i++) {
+                const TemperatureSource::Reading& reading = source.getReading(i);
+                if (reading.valid && reading.tempC > sample.controlTemp) {
+                    sample.controlTemp = reading.tempC;
+                }
+            }
+            sample.timestampUs = clock.nowUs();
+            enterPhase(Phase::PUBLISH, sample.timestampUs);
+            return 0;
+        }
+
+        case Phase::PUBLISH: {
+            // Applied between conversions, the next one runs at the new resolution
+            uint8_t bits = selectResolution(sample);
+            if (bits != source.getResolution()) {
+                DEBUG_LOG_TEMP("Resolution %d -> %d bits", source.getResolution(), bits);
+                source.setResolution(bits);
+            }
+
+            listener.onSample(sample);
+            enterPhase(Phase::IDLE, clock.nowUs());
+            return 0;
+        }
+
+        default:
+            enterPhase(Phase::IDLE, nowUs);
+            return 0;
+    }
+}
+
+void TempAcquisition::enterPhase(Phase next, uint32_t nowUs) {
+    // The idle time before the first cycle is not a sample period
+    if (started || phase != Phase::IDLE) {
+        histograms[static_cast<uint8_t>(phase)].record(nowUs - phaseStartUs);
+    }
+    phase = next;
+    phaseStartUs = nowUs;
+}
+
+uint32_t TempAcquisition::getSampleIntervalMs() const {
+    uint8_t bits = TemperatureSource::clampBits(source.getResolution());
+    return source.samplePeriodMs(Config::Temperature::READ_INTERVAL_MS >> (Config::Temperature::Resolution::MAX_BITS - bits));
+}
+
+/*******************************************************************************
+ * Adaptive Resolution
+ ******************************************************************************/
+
+uint8_t TempAcquisition::selectResolution(const Sample& current) {
+    uint8_t bits = current.resolution;
+    if (!Config::Temperature::Resolution::ADAPTIVE) {
+        return Config::Temperature::Resolution::DEFAULT_BITS;
+    }
+    if (!current.validCount) {
+        return bits;
+    }
+
+    float previousTemp = rateTemp;
+    uint32_t elapsedUs = current.timestampUs - rateTimeUs;
+    bool havePrevious = haveRate;
+    uint8_t coarsestBits = std::min(bits, rateBits);
+
+    rateTemp = current.controlTemp;
+    rateTimeUs = current.timestampUs;
+    rateBits = bits;
+    haveRate = true;
+    if (!havePrevious || elapsedUs == 0) return bits;
+
+    // A change of one LSB is indistinguishable from rounding
+    float change = fabsf(current.controlTemp - previousTemp) - TemperatureSource::stepC(coarsestBits);
+    float rate = change > 0 ? change * 1e6f / elapsedUs : 0.0f;
+
+    if (rate > Config::Temperature::Resolution::FAST_RATE) {
+        stableSamples = 0;
+        return Config::Temperature::Resolution::MIN_BITS;
+    }
+
+    if (rate >= Config::Temperature::Resolution::STABLE_RATE) {
+        stableSamples = 0;
+        return bits;
+    }
+
+    if (++stableSamples >= Config::Temperature::Resolution::STABLE_SAMPLES) {
+        stableSamples = 0;
+        if (bits < Config::Temperature::Resolution::MAX_BITS) {
+            return bits + 1;
+        }
+    }
+    return bits;
+}
+
+/*******************************************************************************
+ * Phase Histogram
+ ******************************************************************************/
+
+void TempAcquisition::Histogram::record(uint32_t durationUs) {
+    uint8_t bucket = 0;
+    uint32_t limitUs = Config::Temperature::Acquisition::HISTOGRAM_BASE_US;
+    while (bucket < BUCKETS - 1 && durationUs >= limitUs) {
+        limitUs <<= 1;
+        bucket++;
+    }
+
+    buckets[bucket]++;
+    count++;
+    if (durationUs > maxUs) {
+        maxUs = durationUs;
+    }
+}
+
+uint32_t TempAcquisition::Histogram::percentileUs(uint8_t percent) const {
+    if (!count) return 0;
+
+    uint32_t target = (static_cast<uint64_t>(count) * percent + 99) / 100;
+    uint32_t cumulative = 0;
+    for (uint8_t bucket = 0; bucket < BUCKETS - 1; bucket++) {
+        cumulative += buckets[bucket];
+        if (cumulative >= target) {
+            return Config::Temperature::Acquisition::HISTOGRAM_BASE_US << bucket;
+        }
+    }
+    return maxUs;
+}
+
+/*******************************************************************************
+ * Utility Methods
+ ******************************************************************************/
+
+const char* TempAcquisition::phaseToString(Phase p) {
+    switch (p) {
+        case Phase::IDLE:       return "idle";
+        case Phase::CONVERTING: return "converting";
+        case Phase::READING:    return "reading";
+        case Phase::PUBLISH:    return "publish";
+        default:                return "unknown";
+    }
+}
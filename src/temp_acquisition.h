@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include "config.h"
+#include "clock.h"
+#include "temperature_source.h"
+
+/**
+ * @brief Non-blocking temperature acquisition cycle
+ *
+ * One explicit state machine drives the probes:
+ *
+ *   IDLE -> CONVERTING -> READING -> PUBLISH -> IDLE
+ *
+ * Each step() performs at most one bus transaction: the broadcast
+ * conversion when leaving IDLE, one completion poll in CONVERTING, the
+ * addressed readout in READING and a pending resolution change in
+ * PUBLISH. Time comes from a Clock and the probes from a
+ * TemperatureSource; test_temp_acquisition steps it with a fake of each.
+ *
+ * Features:
+ * - Adaptive 9-12 bit resolution, sampling up to 8x faster during transients
+ * - Hottest valid probe as the control temperature
+ * - Log2 histogram of the time spent in each phase
+ *
+ * Not thread-safe; only the temperature task steps it. TempSensor copies
+ * the results for other tasks under its mutex.
+ */
+class TempAcquisition {
+public:
+    enum class Phase : uint8_t {
+        IDLE,           // Waiting for the next sample period
+        CONVERTING,     // Probes converting, polled for completion
+        READING,        // Scratchpads read out
+        PUBLISH,        // Sample handed to the listener
+        COUNT
+    };
+
+    /**
+     * @brief Result of one acquisition cycle
+     */
+    struct Sample {
+        float controlTemp;      ///< Hottest valid probe, undefined without one
+        uint8_t validCount;     ///< Probes that returned a valid reading
+        uint8_t resolution;     ///< Bits the conversion ran at
+        uint32_t timestampUs;   ///< End of the readout
+    };
+
+    /**
+     * @brief Receives every sample in the PUBLISH phase
+     */
+    class Listener {
+    public:
+        virtual ~Listener() = default;
+        virtual void onSample(const Sample& sample) = 0;
+    };
+
+    /**
+     * @brief Log2 histogram of phase durations
+     *
+     * Bucket i holds durations below HISTOGRAM_BASE_US << i; the last
+     * bucket holds everything longer.
+     */
+    struct Histogram {
+        static constexpr uint8_t BUCKETS = Config::Temperature::Acquisition::HISTOGRAM_BUCKETS;
+
+        uint32_t buckets[BUCKETS];
+        uint32_t count;
+        uint32_t maxUs;
+
+        void record(uint32_t durationUs);
+
+        /**
+         * @brief Upper bound of the bucket holding the given percentile
+         */
+        uint32_t percentileUs(uint8_t percent) const;
+    };
+
+    TempAcquisition(TemperatureSource& source, const Clock& clock, Listener& listener);
+
+    // Prevent copying
+    TempAcquisition(const TempAcquisition&) = delete;
+    TempAcquisition& operator=(const TempAcquisition&) = delete;
+
+    /**
+     * @brief Run the current phase
+     * @return Milliseconds until the next step is due, 0 to step again at once
+     */
+    uint32_t step();
+
+    Phase getPhase() const { return phase; }
+    const Histogram& getHistogram(Phase p) const { return histograms[static_cast<uint8_t>(p)]; }
+
+    /**
+     * @brief Sample period at the current resolution
+     *
+     * Scales with the conversion time, READ_INTERVAL_MS at 12 bits down to
+     * an eighth of it at 9 bits. A replayed trace sets its own period.
+     */
+    uint32_t getSampleIntervalMs() const;
+
+    static const char* phaseToString(Phase p);
+
+private:
+    TemperatureSource& source;
+    const Clock& clock;
+    Listener& listener;
+
+    Phase phase;
+    uint32_t phaseStartUs;
+    uint32_t cycleStartUs;
+    bool started;
+    Sample sample;
+    Histogram histograms[static_cast<uint8_t>(Phase::COUNT)];
+
+    // Adaptive resolution, rate of change between successive samples
+    float rateTemp;
+    uint32_t rateTimeUs;
+    uint8_t rateBits;
+    bool haveRate;
+    uint8_t stableSamples;
+
+    void enterPhase(Phase next, uint32_t nowUs);
+    uint8_t selectResolution(const Sample& sample);
+};
@@ -5,33 +5,39 @@
 
 #include "temp_sensor.h"
 #include "fan_controller.h"
+#include "trace_recorder.h"
+#include "tach_edge_monitor.h"
 
 /*******************************************************************************
  * Construction / Destruction
  ******************************************************************************/
 
-TempSensor::TempSensor(TaskManager& tm)
+TempSensor::TempSensor(TaskManager& tm, TemperatureSource& temperatureSource)
     : taskManager(tm)
-    , fanController(nullptr)
-    , oneWire(Config::Temperature::SENSOR_PIN)
-    , sensors(&oneWire)
+    , source(temperatureSource)
+    , acquisition(source, clock, *this)
     , mutex(xSemaphoreCreateMutex())
+    , fanController(nullptr)
+    , traceRecorder(nullptr)
+    , tachEdgeMonitor(nullptr)
     , currentTemp(Config::Temperature::DEFAULT_VALUE)
     , smoothedTemp(Config::Temperature::DEFAULT_VALUE)
-    , historyIndex(0)
+    , smoothingPrimed(false)
+    , trend(Config::Temperature::Trend::WINDOW_MS, Config::Temperature::Trend::MIN_SAMPLES)
     , lastReadSuccess(false)
     , lastReadTime(0)
     , consecutiveFailures(0)
-    , initialized(false) 
+    , initialized(false)
+    , readings{}
+    , resolution(Config::Temperature::Resolution::DEFAULT_BITS)
+    , sampleIntervalMs(Config::Temperature::READ_INTERVAL_MS)
+    , histograms{}
 {
     if (!mutex) {
         DEBUG_LOG_TEMP("TempSensor - Mutex creation failed!");
     }
-    
-    // Initialize temperature history buffer
-    for (int i = 0; i < Config::Temperature::SMOOTH_SAMPLES; i++) {
-        tempHistory[i] = Config::Temperature::DEFAULT_VALUE;
-    }
+
+    smoothing.reset(Config::Temperature::DEFAULT_VALUE);
 }
 
 TempSensor::~TempSensor() {
@@ -54,37 +60,42 @@ esp_err_t TempSensor::begin() {
     // Add delay to let display SPI initialize first
     delay(300);
 
-    // Initialize the Dallas temperature sensor
-    sensors.begin();
-    sensors.setWaitForConversion(false);  // Enable async reading
-
-    if (!sensors.getDeviceCount()) {
+    // Enumerate the probes once; later cycles address them directly
+    uint8_t sensorCount = source.begin();
+    if (!sensorCount) {
         Serial.println("No temperature sensors detected!");
         return ESP_ERR_NOT_FOUND;
     }
+    DEBUG_LOG_TEMP("%d temperature sensor(s) found", sensorCount);
+
+    if (!source.setResolution(Config::Temperature::Resolution::DEFAULT_BITS)) {
+        DEBUG_LOG_TEMP("Failed to set initial resolution");
+    }
+
+    {
+        MutexGuard guard(mutex);
+        if (guard.isLocked()) {
+            publishAcquisition();
+        }
+    }
 
     // Create temperature monitoring task
     TaskManager::TaskConfig taskConfig("Temp", 
                                        Config::Temperature::Task::STACK_SIZE, 
                                        Config::Temperature::Task::TASK_PRIORITY, 
-                                       Config::Temperature::Task::TASK_CORE);
-    esp_err_t err = taskManager.createTask(taskConfig, tempTask, this);
+                                       Config::Temperature::Task::TASK_CORE,
+                                       Config::Temperature::Task::PERIOD_MS,
+                                       Config::Temperature::Task::DEADLINE_MS,
+                                       Config::Temperature::Task::POLICY,
+                                       Config::Temperature::Task::WATCHDOG,
+                                       Config::Temperature::Task::MEMORY);
+    esp_err_t err = taskManager.createTask(taskConfig, tempTask, this, &taskId);
     
     if (err != ESP_OK) {
         return err;
     }
 
     initialized = true;
-    
-    // Start first temperature conversion
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) {
-        return ESP_ERR_TIMEOUT;
-    }
-    
-    sensors.requestTemperatures();
-    conversionRequested = true;
-    conversionRequestTime = millis();
 
     DEBUG_LOG_TEMP("Temperature sensor initialized successfully");
     return ESP_OK;
@@ -97,113 +108,87 @@ void TempSensor::registerFanController(FanController* controller) {
     }
 }
 
+void TempSensor::registerTraceRecorder(TraceRecorder* recorder) {
+    MutexGuard guard(mutex);
+    if (guard.isLocked()) {
+        traceRecorder = recorder;
+    }
+}
+
+void TempSensor::registerTachEdgeMonitor(TachEdgeMonitor* monitor) {
+    MutexGuard guard(mutex);
+    if (guard.isLocked()) {
+        tachEdgeMonitor = monitor;
+    }
+}
+
 /*******************************************************************************
  * Temperature Reading and Processing
  ******************************************************************************/
 
-void TempSensor::processReading() {
-    if (!initialized) return;
-
-    uint32_t currentTime = millis();
-
-    // Start new conversion if none is in progress
-    if (!conversionRequested) {
+void TempSensor::onSample(const TempAcquisition::Sample& sample) {
+    // Called from acquisition.step() in the PUBLISH phase, after the bus I/O
+    TraceRecorder* recorder = nullptr;
+    FanController* controller = nullptr;
+    {
         MutexGuard guard(mutex);
         if (!guard.isLocked()) return;
-        
-        DEBUG_LOG_TEMP("Starting new temperature conversion");  // Add this
-        sensors.requestTemperatures();
-        conversionRequested = true;
-        conversionRequestTime = millis();
-        return;
-    }
-
-    // Wait for conversion to complete (750ms minimum)
-    if (currentTime - conversionRequestTime < 750) {
-        return;
-    }
 
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return;
+        publishAcquisition();
 
-    float tempC = sensors.getTempCByIndex(0);
-    DEBUG_LOG_TEMP("Raw temperature reading: %.2f°C", tempC);  // Add this
-    
-    bool tempChanged = false;
-    
-    // Validate temperature reading
-    if (tempC != DEVICE_DISCONNECTED_C && tempC != 85.0 && tempC > -55.0 && tempC < 125.0) {
-        lastReadSuccess = true;
-        consecutiveFailures = 0;
-        tempChanged = (abs(tempC - currentTemp) > 0.1);
-        currentTemp = tempC;
-        updateSmoothing(tempC);  // Always update smoothing
-    } else {
-        consecutiveFailures++;
-        lastReadSuccess = false;
-        if (consecutiveFailures >= Config::Temperature::MAX_RETRIES) {
-            currentTemp = Config::Temperature::DEFAULT_VALUE;
-        }
-    }
+        if (sample.validCount) {
+            DEBUG_LOG_TEMP("Control temperature: %.2f°C (%d bits)", sample.controlTemp, sample.resolution);
+            lastReadSuccess = true;
+            consecutiveFailures = 0;
+            currentTemp = sample.controlTemp;
 
-    lastReadTime = currentTime;
-    conversionRequested = false;
+            // Start from the first reading rather than the default value
+            if (!smoothingPrimed) {
+                smoothing.reset(sample.controlTemp);
+                smoothingPrimed = true;
+            }
+            smoothedTemp = smoothing.update(sample.controlTemp);
+            trend.update(sample.timestampUs, sample.controlTemp);
+        } else {
+            consecutiveFailures++;
+            lastReadSuccess = false;
 
-    // Always notify of temperature update if successful, not just on changes
-    if (lastReadSuccess && fanController) {
-        EventGroupHandle_t events = fanController->getEventGroup();
-        if (events) {
-            DEBUG_LOG_TEMP("Notifying fan controller of temperature update");
-            xEventGroupSetBits(events, FanController::TEMP_UPDATED);
+            if (consecutiveFailures >= Config::Temperature::MAX_RETRIES) {
+                currentTemp = Config::Temperature::DEFAULT_VALUE;
+            }
         }
-    }
-}
-
-bool TempSensor::startConversion() {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return false;
-
-    sensors.requestTemperatures();
-    conversionRequested = true;
-    conversionRequestTime = millis();
-    return true;
-}
 
-bool TempSensor::readTemperature() {
-    MutexGuard guard(mutex);
-    if (!guard.isLocked()) return false;
-
-    float tempC = sensors.getTempCByIndex(0);
-    bool success = false;
+        lastReadTime = millis();
+        recorder = traceRecorder;
+        controller = lastReadSuccess ? fanController : nullptr;
+    }
 
-    if (tempC != DEVICE_DISCONNECTED_C && tempC != 85.0 && tempC > -55.0 && tempC < 125.0) {
-        lastReadSuccess = true;
-        consecutiveFailures = 0;
-        currentTemp = tempC;
-        updateSmoothing(tempC);
-        success = true;
-    } else {
-        consecutiveFailures++;
-        lastReadSuccess = false;
-        
-        if (consecutiveFailures >= Config::Temperature::MAX_RETRIES) {
-            currentTemp = Config::Temperature::DEFAULT_VALUE;
+    // Failed cycles are recorded too, a replay reproduces them. The
+    // recorder flushes to flash now and then, so it runs without the
+    // mutex; the source is only written by this task, in step().
+    if (recorder && !recorder->record(sample.timestampUs, source)) {
+        MutexGuard guard(mutex);
+        if (guard.isLocked() && traceRecorder == recorder) {
+            traceRecorder = nullptr;
         }
     }
 
-    lastReadTime = millis();
-    return success;
+    // Always notify of temperature update if successful, not just on changes
+    if (controller) {
+        DEBUG_LOG_TEMP("Notifying fan controller of temperature update");
+        controller->notifyTemperatureUpdated();
+    }
 }
 
-void TempSensor::updateSmoothing(float newTemp) {
-    tempHistory[historyIndex] = newTemp;
-    historyIndex = (historyIndex + 1) % Config::Temperature::SMOOTH_SAMPLES;
-    
-    float sum = 0;
-    for (int i = 0; i < Config::Temperature::SMOOTH_SAMPLES; i++) {
-        sum += tempHistory[i];
+void TempSensor::publishAcquisition() {
+    for (uint8_t i = 0; i < source.getCount(); i++) {
+        readings[i] = source.getReading(i);
+    }
+    resolution = source.getResolution();
+    sampleIntervalMs = acquisition.getSampleIntervalMs();
+    for (uint8_t i = 0; i < static_cast<uint8_t>(TempAcquisition::Phase::COUNT); i++) {
+        histograms[i] = acquisition.getHistogram(static_cast<TempAcquisition::Phase>(i));
     }
-    smoothedTemp = sum / Config::Temperature::SMOOTH_SAMPLES;
 }
 
 /*******************************************************************************
@@ -222,6 +207,57 @@ float TempSensor::getSmoothedTemp() const {
     return smoothedTemp;
 }
 
+uint8_t TempSensor::getSensorCount() const {
+    // Fixed after begin(), no lock needed
+    return source.getCount();
+}
+
+bool TempSensor::getSensorReading(uint8_t index, TemperatureSource::Reading& reading) const {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked() || index >= source.getCount()) return false;
+    reading = readings[index];
+    return true;
+}
+
+uint8_t TempSensor::getResolution() const {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return Config::Temperature::Resolution::DEFAULT_BITS;
+    return resolution;
+}
+
+uint32_t TempSensor::getSampleIntervalMs() const {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return Config::Temperature::READ_INTERVAL_MS;
+    return sampleIntervalMs;
+}
+
+bool TempSensor::getPhaseHistogram(TempAcquisition::Phase phase,
+                                   TempAcquisition::Histogram& histogram) const {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return false;
+    histogram = histograms[static_cast<uint8_t>(phase)];
+    return true;
+}
+
+bool TempSensor::getTachLoss(uint32_t& reads, uint32_t& lastMissed,
+                             uint32_t& maxMissed, uint32_t& totalMissed) const {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked() || !tachEdgeMonitor) return false;
+
+    const TachEdgeMonitor::Stats& stats = tachEdgeMonitor->getStats();
+    reads = stats.reads;
+    lastMissed = stats.lastMissed;
+    maxMissed = stats.maxMissed;
+    totalMissed = stats.totalMissed;
+    return true;
+}
+
+float TempSensor::getTrend() const {
+    MutexGuard guard(mutex);
+    if (!guard.isLocked()) return 0.0f;
+    return trend.getSlope() * 60.0f;
+}
+
 bool TempSensor::isLastReadSuccess() const {
     MutexGuard guard(mutex);
     if (!guard.isLocked()) return false;
@@ -247,32 +283,39 @@ String TempSensor::getStatusString() const {
 
 void TempSensor::tempTask(void* parameters) {
     TempSensor* temp = static_cast<TempSensor*>(parameters);
-    TickType_t lastConversionStart = 0;
-    bool conversionInProgress = false;
     
     while (true) {
-        temp->taskManager.updateTaskRunTime("Temp");
-        uint32_t currentTime = millis();
-        
-        if (!conversionInProgress) {
-            // Start new conversion
-            if (temp->startConversion()) {
-                lastConversionStart = xTaskGetTickCount();
-                conversionInProgress = true;
-                vTaskDelay(pdMS_TO_TICKS(800)); // Slightly longer than conversion time
-                continue;
-            }
-        } else {
-            // Check if conversion is complete
-            if ((xTaskGetTickCount() - lastConversionStart) >= pdMS_TO_TICKS(750)) {
-                temp->processReading();
-                conversionInProgress = false;
-                // Wait remainder of the interval
-                vTaskDelay(pdMS_TO_TICKS(Config::Temperature::READ_INTERVAL_MS - 800));
-                continue;
-            }
+        temp->taskManager.heartbeat(temp->taskId);
+
+        uint32_t delayMs = temp->processReading();
+        temp->taskManager.workDone(temp->taskId);
+        if (delayMs) {
+            vTaskDelay(pdMS_TO_TICKS(delayMs));
+        }
+    }
+}
+
+uint32_t TempSensor::processReading() {
+    TachEdgeMonitor* monitor = nullptr;
+    {
+        MutexGuard guard(mutex);
+        if (!guard.isLocked()) {
+            return Config::Temperature::Resolution::POLL_MS;
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(100)); // Short delay if neither condition met
+        monitor = tachEdgeMonitor;
+    }
+
+    // One phase per step, the machine says when the next one is due. The
+    // step runs without the mutex so getters never wait on a bus
+    // transaction; onSample() publishes the results under it. Only the
+    // readout is measured, it is the longest bus transaction.
+    // Windows belong to this task, the stats endWindow() writes to the mutex.
+    bool measured = monitor && acquisition.getPhase() == TempAcquisition::Phase::READING;
+    if (measured) monitor->startWindow();
+    uint32_t delayMs = acquisition.step();
+    if (measured) {
+        MutexGuard guard(mutex);
+        if (guard.isLocked()) monitor->endWindow();
     }
-}
\ No newline at end of file
+    return delayMs;
+}
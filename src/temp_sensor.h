@@ -2,34 +2,45 @@
 #define TEMP_SENSOR_H
 
 #include <Arduino.h>
-#include <OneWire.h>
-#include <DallasTemperature.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "config.h"
 #include "task_manager.h"
 #include "mutex_guard.h"
 #include "debug_log.h"
+#include "temperature_source.h"
+#include "system_clock.h"
+#include "temp_acquisition.h"
+#include "signal_filter.h"
+#include "trend_estimator.h"
 
 // Forward declarations
 class FanController;
+class TraceRecorder;
+class TachEdgeMonitor;
 
 /**
- * @brief Temperature sensor management using Dallas Temperature sensors
+ * @brief Temperature sensor management on top of a TemperatureSource
  * 
  * Provides thread-safe temperature sensing with:
- * - Asynchronous temperature reading
- * - Temperature smoothing using rolling average
+ * - DS18B20 probes (SensorBus) or a replayed trace (ReplaySource) as the source
+ * - Optional binary trace of every sample (TraceRecorder)
+ * - Asynchronous temperature reading through one acquisition state machine
+ * - Multiple probes read by cached ROM address, hottest one drives the fan
+ * - Adaptive 9-12 bit resolution, sampling up to 8x faster during transients
+ * - Temperature smoothing through a compile-time filter chain
+ * - Least-squares trend in °C/min for predictive control
  * - Error detection and recovery
  * - Status monitoring and reporting
  */
-class TempSensor {
+class TempSensor : private TempAcquisition::Listener {
 public:
     /**
      * @brief Construct a new Temperature Sensor object
      * @param taskManager Reference to the task manager for FreeRTOS task handling
+     * @param source Probes to acquire from, must outlive the sensor
      */
-    explicit TempSensor(TaskManager& taskManager);
+    TempSensor(TaskManager& taskManager, TemperatureSource& source);
     ~TempSensor();
 
     // Prevent copying
@@ -47,38 +58,72 @@ public:
     float getSmoothedTemp() const;    
     bool isLastReadSuccess() const;    
     String getStatusString() const;    
+    float getTrend() const;             // °C/min, positive while heating
+
+    // Per-probe readings - all thread-safe
+    uint8_t getSensorCount() const;
+    bool getSensorReading(uint8_t index, TemperatureSource::Reading& reading) const;
+
+    // Acquisition timing - all thread-safe
+    uint8_t getResolution() const;
+    uint32_t getSampleIntervalMs() const;
+    bool getPhaseHistogram(TempAcquisition::Phase phase, TempAcquisition::Histogram& histogram) const;
+    const char* getSourceName() const { return source.getName(); }
+
+    // Tach edges missed during probe readouts, false when not measured
+    bool getTachLoss(uint32_t& reads, uint32_t& lastMissed, uint32_t& maxMissed, uint32_t& totalMissed) const;
 
     // Task and process handling
     static void tempTask(void* parameters);
-    void processReading();
     void registerFanController(FanController* controller);
+    void registerTraceRecorder(TraceRecorder* recorder);    // nullptr stops recording
+    void registerTachEdgeMonitor(TachEdgeMonitor* monitor);
 
 private:
+    /**
+     * @brief Smoothing applied to the control temperature
+     *
+     * Median spike rejection ahead of a rolling average. Change the stages
+     * here to select another chain, see signal_filter.h.
+     */
+    using SmoothingFilter = FilterChain<MedianFilter<Config::Temperature::MEDIAN_SAMPLES>,
+                                        MovingAverage<Config::Temperature::SMOOTH_SAMPLES>>;
+
     // Hardware and system components
     TaskManager& taskManager;
-    OneWire oneWire;
-    DallasTemperature sensors;
+    TaskManager::TaskId taskId;
+    TemperatureSource& source;
+    SystemClock clock;
+    TempAcquisition acquisition;
     SemaphoreHandle_t mutex;
     FanController* fanController;
+    TraceRecorder* traceRecorder;
+    TachEdgeMonitor* tachEdgeMonitor;
 
     // Temperature data
     float currentTemp;         
     float smoothedTemp;        
-    float tempHistory[Config::Temperature::SMOOTH_SAMPLES];
-    size_t historyIndex;      
+    SmoothingFilter smoothing;
+    bool smoothingPrimed;
+    TrendEstimator<Config::Temperature::Trend::MAX_SAMPLES> trend;
 
     // Status tracking
     bool lastReadSuccess;      
     uint32_t lastReadTime;     
     uint8_t consecutiveFailures;
     bool initialized;         
-    bool conversionRequested; 
-    uint32_t conversionRequestTime;
+
+    // Copies for the getters; the acquisition steps without the mutex and
+    // only the owning task touches the source and the state machine
+    TemperatureSource::Reading readings[TemperatureSource::MAX_SENSORS];
+    uint8_t resolution;
+    uint32_t sampleIntervalMs;
+    TempAcquisition::Histogram histograms[static_cast<uint8_t>(TempAcquisition::Phase::COUNT)];
 
     // Helper methods
-    void updateSmoothing(float newTemp);
-    bool startConversion();
-    bool readTemperature();
+    uint32_t processReading();  // One acquisition step, returns the ms until the next
+    void onSample(const TempAcquisition::Sample& sample) override;  // Takes the mutex to publish
+    void publishAcquisition();  // Caller holds the mutex
 };
 
 #endif // TEMP_SENSOR_H
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "config.h"
+
+/**
+ * @brief Set of temperature probes, as seen by the acquisition cycle
+ *
+ * Implementations:
+ * - SensorBus: DS18B20 probes on the OneWire bus
+ * - ReplaySource: a recorded trace, see trace_format.h
+ *
+ * No OneWire or Arduino types appear here, so TempAcquisition can be
+ * tested against a fake source on the host.
+ */
+class TemperatureSource {
+public:
+    static constexpr uint8_t MAX_SENSORS = Config::Temperature::MAX_SENSORS;
+    static constexpr size_t ID_LENGTH = 17;     ///< 16 hex digits and terminator
+
+    /**
+     * @brief Latest result of one probe
+     */
+    struct Reading {
+        char id[ID_LENGTH];     ///< ROM code as hex, stable across reboots
+        float tempC;            ///< Last valid temperature
+        bool valid;             ///< Latest read succeeded
+        uint8_t failures;       ///< Consecutive failed reads
+    };
+
+    virtual ~TemperatureSource() = default;
+
+    /**
+     * @brief Enumerate the probes, once before the first conversion
+     * @return Number of probes found
+     */
+    virtual uint8_t begin() = 0;
+
+    /**
+     * @brief Start a conversion on every probe with one broadcast command
+     */
+    virtual void requestConversion() = 0;
+
+    /**
+     * @brief Check whether the running conversion has finished
+     *
+     * Only externally powered probes signal completion; parasite powered
+     * probes read as busy until conversionTimeMs() has passed.
+     */
+    virtual bool isConversionComplete() = 0;
+
+    /**
+     * @brief Read every probe
+     * @return Number of probes with a valid reading
+     */
+    virtual uint8_t readAll() = 0;
+
+    /**
+     * @brief Set the resolution of every probe
+     * @param bits 9 to 12
+     * @return true if every probe accepted it
+     */
+    virtual bool setResolution(uint8_t bits) = 0;
+    virtual uint8_t getResolution() const = 0;
+
+    virtual uint8_t getCount() const = 0;
+    virtual const Reading& getReading(uint8_t index) const = 0;
+
+    /**
+     * @brief Short name for status reports
+     */
+    virtual const char* getName() const = 0;
+
+    /**
+     * @brief Upper bound of the running conversion
+     */
+    virtual uint32_t maxConversionMs() const {
+        return conversionTimeMs(getResolution());
+    }
+
+    /**
+     * @brief Period from one conversion to the next
+     * @param nominalMs Period the acquisition cycle chose for the resolution
+     *
+     * Live probes sample at the nominal period; a replay follows the
+     * timing of its trace instead.
+     */
+    virtual uint32_t samplePeriodMs(uint32_t nominalMs) const {
+        return nominalMs;
+    }
+
+    /**
+     * @brief Datasheet maximum conversion time
+     */
+    static uint32_t conversionTimeMs(uint8_t bits) {
+        static constexpr uint32_t CONVERSION_MS[] = { 94, 188, 375, 750 };
+        return CONVERSION_MS[clampBits(bits) - Config::Temperature::Resolution::MIN_BITS];
+    }
+
+    /**
+     * @brief Size of one LSB
+     */
+    static float stepC(uint8_t bits) {
+        return 0.5f / (1 << (clampBits(bits) - Config::Temperature::Resolution::MIN_BITS));
+    }
+
+    static uint8_t clampBits(uint8_t bits) {
+        return std::min(std::max(bits, Config::Temperature::Resolution::MIN_BITS),
+                        Config::Temperature::Resolution::MAX_BITS);
+    }
+};
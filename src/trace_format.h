@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Binary temperature trace, one record per acquisition cycle
+ *
+ * Written by TraceRecorder, read by ReplaySource and by host tools. All
+ * fields are little-endian.
+ *
+ * Header:
+ *   char[4]   magic "FTRC"
+ *   uint8     version
+ *   uint8     probe count n, 1 to 8
+ *   char[16]  ROM code of each probe as hex, n times, no terminator
+ *
+ * Record:
+ *   uint16    milliseconds since the previous record, 0 for the first,
+ *             saturating at 65535
+ *   uint8     resolution in bits
+ *   uint8     valid mask, bit i set when probe i read successfully
+ *   int16     temperature of each probe in 1/16 °C, n times; the last
+ *             valid value when the read failed
+ *
+ * 1/16 °C is the DS18B20 LSB, so recorded probe values are exact. Two
+ * probes sampled every 2 s take 8 bytes per record, about 340 kB a day.
+ *
+ * Header only with fixed-width types, so the host replay driver reads
+ * the same layout the firmware writes.
+ */
+namespace TraceFormat {
+    constexpr char MAGIC[4] = { 'F', 'T', 'R', 'C' };
+    constexpr uint8_t VERSION = 1;
+    constexpr uint8_t MAX_PROBES = 8;           // Bits in the valid mask
+
+    constexpr size_t FILE_HEADER_SIZE = 6;
+    constexpr size_t ID_SIZE = 16;
+    constexpr size_t RECORD_HEADER_SIZE = 4;
+    constexpr float TEMP_SCALE = 16.0f;         // Stored units per °C
+
+    constexpr size_t headerSize(uint8_t probes) {
+        return FILE_HEADER_SIZE + ID_SIZE * probes;
+    }
+
+    constexpr size_t recordSize(uint8_t probes) {
+        return RECORD_HEADER_SIZE + sizeof(int16_t) * probes;
+    }
+
+    inline void putU16(uint8_t* out, uint16_t value) {
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    inline uint16_t getU16(const uint8_t* in) {
+        return static_cast<uint16_t>(in[0] | (in[1] << 8));
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file trace_recorder.cpp
+ * @brief Implementation of the binary temperature trace recorder
+ */
+
+#include "trace_recorder.h"
+#include "debug_log.h"
+#include <cmath>
+
+static_assert(Config::Temperature::MAX_SENSORS <= TraceFormat::MAX_PROBES,
+              "The trace valid mask holds at most 8 probes");
+
+/*******************************************************************************
+ * Construction
+ ******************************************************************************/
+
+TraceRecorder::TraceRecorder(Print& sink, size_t limitBytes)
+    : out(sink)
+    , maxBytes(limitBytes)
+    , bytesWritten(0)
+    , records(0)
+    , lastUs(0)
+    , probes(0)
+    , stopped(false) {
+}
+
+/*******************************************************************************
+ * Recording
+ ******************************************************************************/
+
+bool TraceRecorder::record(uint32_t timestampUs, const TemperatureSource& source) {
+    if (stopped) return false;
+
+    if (!records) {
+        probes = source.getCount();
+        if (!probes || !writeHeader(source)) {
+            stop("header not written");
+            return false;
+        }
+    }
+
+    uint8_t buffer[TraceFormat::recordSize(TraceFormat::MAX_PROBES)];
+    size_t length = TraceFormat::recordSize(probes);
+    if (bytesWritten + length > maxBytes) {
+        stop("size limit reached");
+        return false;
+    }
+
+    uint32_t deltaMs = records ? (timestampUs - lastUs) / 1000 : 0;
+    TraceFormat::putU16(&buffer[0], deltaMs > UINT16_MAX ? UINT16_MAX : deltaMs);
+    buffer[2] = source.getResolution();
+    buffer[3] = 0;
+
+    for (uint8_t i = 0; i < probes; i++) {
+        const TemperatureSource::Reading& reading = source.getReading(i);
+        if (reading.valid) {
+            buffer[3] |= 1 << i;
+        }
+        int16_t raw = static_cast<int16_t>(lroundf(reading.tempC * TraceFormat::TEMP_SCALE));
+        TraceFormat::putU16(&buffer[TraceFormat::RECORD_HEADER_SIZE + i * sizeof(int16_t)], raw);
+    }
+
+    if (!write(buffer, length)) {
+        stop("write failed");
+        return false;
+    }
+
+    lastUs = timestampUs;
+    records++;
+    if (records % Config::Temperature::Trace::FLUSH_RECORDS == 0) {
+        out.flush();
+    }
+    return true;
+}
+
+bool TraceRecorder::writeHeader(const TemperatureSource& source) {
+    uint8_t header[TraceFormat::FILE_HEADER_SIZE];
+    memcpy(header, TraceFormat::MAGIC, sizeof(TraceFormat::MAGIC));
+    header[4] = TraceFormat::VERSION;
+    header[5] = probes;
+    if (!write(header, sizeof(header))) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < probes; i++) {
+        const TemperatureSource::Reading& reading = source.getReading(i);
+        if (!write(reinterpret_cast<const uint8_t*>(reading.id), TraceFormat::ID_SIZE)) {
+            return false;
+        }
+    }
+
+    DEBUG_LOG_TEMP("Trace started with %d probe(s)", probes);
+    return true;
+}
+
+bool TraceRecorder::write(const uint8_t* data, size_t length) {
+    size_t written = out.write(data, length);
+    bytesWritten += written;
+    return written == length;
+}
+
+void TraceRecorder::stop(const char* reason) {
+    stopped = true;
+    out.flush();
+    Serial.printf("Temperature trace stopped after %u records (%u bytes): %s\n",
+                  (unsigned)records, (unsigned)bytesWritten, reason);
+}
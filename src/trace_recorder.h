@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "temperature_source.h"
+#include "trace_format.h"
+
+/**
+ * @brief Writes every acquisition cycle to a binary trace
+ *
+ * The header is written with the first record, once the source has
+ * enumerated its probes. The sink is any Print, typically a LittleFS
+ * file. It is flushed every Config::Temperature::Trace::FLUSH_RECORDS
+ * records. Recording stops for good at the byte limit or on the first
+ * failed write, so a full filesystem never leaves a torn record behind.
+ *
+ * Not thread-safe; called by TempSensor under its mutex.
+ */
+class TraceRecorder {
+public:
+    /**
+     * @param out Sink for the trace, must outlive the recorder
+     * @param maxBytes Trace size at which recording stops
+     */
+    explicit TraceRecorder(Print& out, size_t maxBytes = Config::Temperature::Trace::MAX_BYTES);
+
+    // Prevent copying
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /**
+     * @brief Append the current readings of the source
+     * @param timestampUs Time of the readout
+     * @return false once recording has stopped
+     */
+    bool record(uint32_t timestampUs, const TemperatureSource& source);
+
+    bool isRecording() const { return !stopped; }
+    size_t getBytesWritten() const { return bytesWritten; }
+    uint32_t getRecordCount() const { return records; }
+
+private:
+    Print& out;
+    const size_t maxBytes;
+    size_t bytesWritten;
+    uint32_t records;
+    uint32_t lastUs;
+    uint8_t probes;
+    bool stopped;
+
+    bool writeHeader(const TemperatureSource& source);
+    bool write(const uint8_t* data, size_t length);
+    void stop(const char* reason);
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Least-squares slope of a signal over a sliding time window
+ *
+ * Every sample carries its own timestamp, so the fit stays correct while
+ * the sample rate changes. Samples older than the window, or beyond
+ * CAPACITY, drop out.
+ *
+ * The fit keeps running sums of t, y, t^2 and t*y: each update adds the
+ * new sample and subtracts the ones that drop out, so update() and the
+ * slope are O(1). Times and values are taken relative to a base sample,
+ * which moves to the newest one once per window or every CAPACITY
+ * updates by summing the buffer afresh. That keeps t small enough for
+ * single precision and discards the rounding error the subtractions
+ * accumulate, at an amortized O(1) cost.
+ */
+template <size_t CAPACITY>
+class TrendEstimator {
+    static_assert(CAPACITY >= 2, "TrendEstimator needs at least two samples");
+
+public:
+    /**
+     * @param windowMs Age of the oldest sample included in the fit
+     * @param minSamples Samples required before a slope is reported
+     */
+    TrendEstimator(uint32_t windowMs, size_t minSamples)
+        : windowUs(windowMs * 1000)
+        , minCount(minSamples < 2 ? 2 : minSamples) {
+        reset();
+    }
+
+    /**
+     * @brief Add a sample and update the fit
+     * @return Slope in units per second, 0 until minSamples are buffered
+     */
+    float update(uint32_t timestampUs, float value) {
+        if (count == 0) {
+            baseUs = timestampUs;
+            baseValue = value;
+        }
+
+        // A full buffer overwrites its oldest sample
+        if (count == CAPACITY) {
+            remove(oldest());
+            count--;
+        }
+        times[head] = timestampUs;
+        values[head] = value;
+        add(head);
+        head = (head + 1) % CAPACITY;
+        count++;
+
+        // Expire from the oldest end
+        while (count > 1 && timestampUs - times[oldest()] > windowUs) {
+            remove(oldest());
+            count--;
+        }
+
+        if (++sinceRebase >= CAPACITY || timestampUs - baseUs > windowUs) {
+            rebase(timestampUs, value);
+        }
+
+        slope = count >= minCount ? fit() : 0.0f;
+        return slope;
+    }
+
+    void reset() {
+        head = 0;
+        count = 0;
+        slope = 0.0f;
+        baseUs = 0;
+        baseValue = 0.0f;
+        sinceRebase = 0;
+        clearSums();
+    }
+
+    float getSlope() const { return slope; }
+    size_t getCount() const { return count; }
+
+private:
+    uint32_t times[CAPACITY];
+    float values[CAPACITY];
+    size_t head;
+    size_t count;
+    float slope;
+    const uint32_t windowUs;
+    const size_t minCount;
+
+    // Running sums relative to the base sample, t in seconds
+    uint32_t baseUs;
+    float baseValue;
+    size_t sinceRebase;
+    float sumT;
+    float sumY;
+    float sumTT;
+    float sumTY;
+
+    size_t oldest() const { return (head + CAPACITY - count) % CAPACITY; }
+
+    float relativeTime(size_t idx) const {
+        return static_cast<int32_t>(times[idx] - baseUs) * 1e-6f;
+    }
+
+    void add(size_t idx) {
+        float t = relativeTime(idx);
+        float y = values[idx] - baseValue;
+        sumT += t;
+        sumY += y;
+        sumTT += t * t;
+        sumTY += t * y;
+    }
+
+    void remove(size_t idx) {
+        float t = relativeTime(idx);
+        float y = values[idx] - baseValue;
+        sumT -= t;
+        sumY -= y;
+        sumTT -= t * t;
+        sumTY -= t * y;
+    }
+
+    void clearSums() {
+        sumT = 0.0f;
+        sumY = 0.0f;
+        sumTT = 0.0f;
+        sumTY = 0.0f;
+    }
+
+    void rebase(uint32_t newestUs, float newestValue) {
+        baseUs = newestUs;
+        baseValue = newestValue;
+        sinceRebase = 0;
+        clearSums();
+        for (size_t i = 0, idx = oldest(); i < count; i++, idx = (idx + 1) % CAPACITY) {
+            add(idx);
+        }
+    }
+
+    float fit() const {
+        float variance = sumTT - sumT * sumT / count;
+        float covariance = sumTY - sumT * sumY / count;
+
+        // Below the rounding error of the sums the timestamps do not spread
+        return variance > sumTT * 1e-5f ? covariance / variance : 0.0f;
+    }
+};
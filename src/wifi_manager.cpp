@@ -1,4 +1,5 @@
 #include "wifi_manager.h"
+#include "cooperative_executor.h"
 
 /*******************************************************************************
  * Construction / Destruction
@@ -6,6 +7,7 @@
 
 WifiManager::WifiManager(TaskManager& tm)
     : taskManager(tm)
+    , executor(nullptr)
     , mutex(xSemaphoreCreateMutex())
     , currentState(Config::System::State::STARTING)
     , initialized(false)
@@ -45,12 +47,28 @@ esp_err_t WifiManager::begin() {
     WiFi.disconnect(true);
     delay(100);
 
+    if (executor) {
+        esp_err_t err = executor->addJob("WiFi", wifiJob, this, 0);
+        if (err != ESP_OK) {
+            return err;
+        }
+
+        initialized = true;
+        DEBUG_LOG_WIFI("WiFi Manager initialized as executor job");
+        return ESP_OK;
+    }
+
     // Create background task for WiFi management
     TaskManager::TaskConfig taskConfig("WiFi", 
                                        Config::WiFi::Task::STACK_SIZE, 
                                        Config::WiFi::Task::TASK_PRIORITY, 
-                                       Config::WiFi::Task::TASK_CORE);
-    esp_err_t err = taskManager.createTask(taskConfig, wifiTask, this);
+                                       Config::WiFi::Task::TASK_CORE,
+                                       Config::WiFi::Task::PERIOD_MS,
+                                       Config::WiFi::Task::DEADLINE_MS,
+                                       Config::WiFi::Task::POLICY,
+                                       Config::WiFi::Task::WATCHDOG,
+                                       Config::WiFi::Task::MEMORY);
+    esp_err_t err = taskManager.createTask(taskConfig, wifiTask, this, &taskId);
     
     if (err != ESP_OK) {
         return err;
@@ -178,12 +196,25 @@ void WifiManager::wifiTask(void* parameters) {
     
     // Main task loop
     while (true) {
-        wifi->taskManager.updateTaskRunTime("WiFi");
+        wifi->taskManager.heartbeat(wifi->taskId);
         wifi->processUpdate();
+        wifi->taskManager.workDone(wifi->taskId);
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
 }
 
+uint32_t WifiManager::wifiJob(void* parameters) {
+    WifiManager* wifi = static_cast<WifiManager*>(parameters);
+
+    // The first run starts the connection, like the task before its loop
+    if (wifi->currentState == Config::System::State::STARTING && wifi->connect() != ESP_OK) {
+        DEBUG_LOG_WIFI("Initial WiFi connection failed");
+    }
+
+    wifi->processUpdate();
+    return Config::WiFi::Task::PERIOD_MS;
+}
+
 /*******************************************************************************
  * Utilities
  ******************************************************************************/
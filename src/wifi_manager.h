@@ -9,6 +9,8 @@
 #include "task_manager.h"
 #include "mutex_guard.h"
 
+class CooperativeExecutor;
+
 /**
  * @brief Manages WiFi connectivity for the ESP32
  * 
@@ -16,6 +18,7 @@
  * - Automatic connection and reconnection handling
  * - Connection status monitoring 
  * - Exponential backoff for retry attempts
+ * - Own task, or a job of the cooperative executor
  * - Thread-safe operation with FreeRTOS
  */
 class WifiManager {
@@ -37,6 +40,12 @@ public:
      */
     esp_err_t begin();
 
+    /**
+     * @brief Run as a job of the executor instead of a task of its own;
+     * call before begin()
+     */
+    void registerExecutor(CooperativeExecutor* jobExecutor) { executor = jobExecutor; }
+
     // Status queries
     bool isConnected() const { return WiFi.status() == WL_CONNECTED; }
     Config::System::State getState() const { return currentState; }
@@ -46,6 +55,7 @@ public:
     
     // Task management
     static void wifiTask(void* parameters);
+    static uint32_t wifiJob(void* parameters);
     void processUpdate();
 
     /**
@@ -63,6 +73,8 @@ public:
 private:    
     // Core components
     TaskManager& taskManager;
+    TaskManager::TaskId taskId;
+    CooperativeExecutor* executor;
     SemaphoreHandle_t mutex;
     
     // State tracking
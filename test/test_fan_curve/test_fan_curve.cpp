@@ -0,0 +1,152 @@
+/**
+ * @file test_fan_curve.cpp
+ * @brief FanCurve lookup tables, run with `pio test -e native`
+ *
+ * The default curve is built at compile time, as the firmware does. The
+ * other curves are built at runtime from points in ordinary arrays, the
+ * path a finished calibration takes.
+ */
+
+#include <unity.h>
+#include <cstdlib>
+#include "config.h"
+#include "fan_curve.h"
+
+namespace {
+    using Point = FanCurve::Point;
+
+    constexpr FanCurve DEFAULT_CURVE = FanCurve::defaultCurve();
+
+    /**
+     * @brief Largest duty change between neighbouring speeds
+     */
+    uint8_t largestPwmStep(const FanCurve& curve) {
+        uint8_t worst = 0;
+        for (int speed = 1; speed <= 100; speed++) {
+            uint8_t step = curve.speedToPwm(speed) - curve.speedToPwm(speed - 1);
+            if (step > worst) worst = step;
+        }
+        return worst;
+    }
+
+    void assertPassesThroughPoints(const FanCurve& curve, const Point* points, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            TEST_ASSERT_EQUAL_UINT8(points[i].pwm, curve.speedToPwm(points[i].speed));
+            TEST_ASSERT_EQUAL_UINT8(points[i].speed, curve.pwmToSpeed(points[i].pwm));
+        }
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+/*******************************************************************************
+ * Compile-Time Curve
+ ******************************************************************************/
+
+void test_default_curve_passes_through_its_points() {
+    assertPassesThroughPoints(DEFAULT_CURVE, Config::Fan::Curve::DEFAULT_POINTS,
+                              sizeof(Config::Fan::Curve::DEFAULT_POINTS) / sizeof(Point));
+}
+
+void test_default_curve_is_monotonic_and_round_trips() {
+    TEST_ASSERT_TRUE(DEFAULT_CURVE.isMonotonic());
+    TEST_ASSERT_LESS_OR_EQUAL(1, DEFAULT_CURVE.maxRoundTripError());
+
+    // Every duty maps back onto itself within one step of the speed table
+    uint8_t step = largestPwmStep(DEFAULT_CURVE);
+    for (int pwm = 0; pwm < 256; pwm++) {
+        uint8_t back = DEFAULT_CURVE.speedToPwm(DEFAULT_CURVE.pwmToSpeed(pwm));
+        TEST_ASSERT_UINT8_WITHIN(step, pwm, back);
+    }
+}
+
+void test_lookups_clamp_out_of_range_speeds() {
+    TEST_ASSERT_EQUAL_UINT8(255, DEFAULT_CURVE.speedToPwm(100));
+    TEST_ASSERT_EQUAL_UINT8(255, DEFAULT_CURVE.speedToPwm(101));
+    TEST_ASSERT_EQUAL_UINT8(255, DEFAULT_CURVE.speedToPwm(255));
+}
+
+/*******************************************************************************
+ * Runtime Curves
+ ******************************************************************************/
+
+void test_calibrated_curve_is_monotonic_and_round_trips() {
+    // Shaped like a calibration result: the fan only starts at 28% duty,
+    // so the first segment is steep
+    Point points[] = {{0, 0}, {8, 72}, {25, 96}, {50, 140}, {75, 196}, {90, 235}, {100, 255}};
+    FanCurve curve = FanCurve::fromPoints(points, sizeof(points) / sizeof(points[0]));
+
+    assertPassesThroughPoints(curve, points, sizeof(points) / sizeof(points[0]));
+    TEST_ASSERT_TRUE(curve.isMonotonic());
+    TEST_ASSERT_LESS_OR_EQUAL(1, curve.maxRoundTripError());
+
+    // Duties below the start duty report the speed they actually give
+    TEST_ASSERT_EQUAL_UINT8(0, curve.pwmToSpeed(0));
+    TEST_ASSERT_EQUAL_UINT8(4, curve.pwmToSpeed(36));
+}
+
+void test_random_curves_are_monotonic_and_round_trip() {
+    // Any curve with at least one duty step per percent round-trips
+    // within 1%; flatter segments cannot resolve every percent. Generated
+    // segments are steep enough, only the closing one may be flatter.
+    srand(5);
+    int curves = 0;
+    for (int run = 0; run < 1000; run++) {
+        Point points[12];
+        size_t count = 0;
+        points[count++] = {0, 0};
+        uint8_t speed = 0;
+        uint8_t pwm = static_cast<uint8_t>(rand() % 40);
+        while (speed < 100 && count < 11) {
+            uint8_t step = static_cast<uint8_t>(1 + rand() % 30);
+            if (speed + step > 100) step = 100 - speed;
+            uint8_t room = 255 - pwm;
+            uint8_t pwmStep = static_cast<uint8_t>(step + rand() % (step + 1));
+            if (pwmStep > room) break;
+            speed += step;
+            pwm += pwmStep;
+            points[count++] = {speed, pwm};
+        }
+        if (speed < 100) {
+            points[count++] = {100, 255};
+        }
+        if (!FanCurve::isValid(points, count)) continue;
+
+        FanCurve curve = FanCurve::fromPoints(points, count);
+        assertPassesThroughPoints(curve, points, count);
+        TEST_ASSERT_TRUE(curve.isMonotonic());
+        if (points[count - 1].pwm - points[count - 2].pwm >= points[count - 1].speed - points[count - 2].speed) {
+            TEST_ASSERT_LESS_OR_EQUAL(1, curve.maxRoundTripError());
+        }
+        curves++;
+    }
+    TEST_ASSERT_GREATER_THAN(900, curves);
+}
+
+void test_invalid_points_give_an_empty_curve() {
+    Point unsorted[] = {{0, 0}, {50, 140}, {40, 150}, {100, 255}};
+    Point flatPwm[] = {{0, 0}, {50, 140}, {60, 140}, {100, 255}};
+    Point shortRange[] = {{0, 0}, {90, 255}};
+
+    TEST_ASSERT_FALSE(FanCurve::isValid(unsorted, 4));
+    TEST_ASSERT_FALSE(FanCurve::isValid(flatPwm, 4));
+    TEST_ASSERT_FALSE(FanCurve::isValid(shortRange, 2));
+    TEST_ASSERT_FALSE(FanCurve::isValid(nullptr, 0));
+
+    FanCurve curve = FanCurve::fromPoints(unsorted, 4);
+    for (int speed = 0; speed <= 100; speed++) {
+        TEST_ASSERT_EQUAL_UINT8(0, curve.speedToPwm(speed));
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_curve_passes_through_its_points);
+    RUN_TEST(test_default_curve_is_monotonic_and_round_trips);
+    RUN_TEST(test_lookups_clamp_out_of_range_speeds);
+    RUN_TEST(test_calibrated_curve_is_monotonic_and_round_trips);
+    RUN_TEST(test_random_curves_are_monotonic_and_round_trip);
+    RUN_TEST(test_invalid_points_give_an_empty_curve);
+    return UNITY_END();
+}
@@ -0,0 +1,269 @@
+/**
+ * @file test_pid.cpp
+ * @brief PidController against a simulated enclosure, run with `pio test -e native`
+ *
+ * The plant is a single thermal mass heated by a constant load and cooled
+ * through a conductance that grows with the fan speed:
+ *
+ *   C dT/dt = Q - (G0 + G1 * speed / 100) * (T - T_ambient)
+ *
+ * The loop runs with the shipped gains at the nominal sample period, the
+ * sensor quantized to the DS18B20 LSB and the speed rounded to whole
+ * percent like FanController does.
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include "config.h"
+#include "pid_controller.h"
+
+namespace {
+    constexpr float AMBIENT_C = 22.0f;
+    constexpr float CAPACITY_J_PER_K = 400.0f;
+    constexpr float G0_W_PER_K = 1.0f;          // Natural convection, fan stopped
+    constexpr float G1_W_PER_K = 6.0f;          // Added at full speed
+    constexpr float LOAD_W = 20.0f;             // Holds the setpoint at 50% speed
+
+    constexpr float SETPOINT_C = Config::Fan::Control::DEFAULT_TARGET;
+    constexpr float MIN_SPEED = Config::Fan::Speed::MIN_PERCENT;
+    constexpr float MAX_SPEED = Config::Fan::Speed::MAX_PERCENT;
+    constexpr float PERIOD_S = Config::Fan::Control::PID::SAMPLE_PERIOD_MS / 1000.0f;
+    constexpr float SENSOR_LSB_C = 0.0625f;
+    constexpr float SETTLE_BAND_C = 0.5f;
+
+    struct Plant {
+        float tempC;
+        float loadW;
+
+        // Exact over one sample period with the speed held
+        void advance(float speed, float seconds) {
+            float conductance = G0_W_PER_K + G1_W_PER_K * speed / 100.0f;
+            float equilibrium = AMBIENT_C + loadW / conductance;
+            tempC = equilibrium + (tempC - equilibrium) * expf(-conductance * seconds / CAPACITY_J_PER_K);
+        }
+
+        float sense() const {
+            return roundf(tempC / SENSOR_LSB_C) * SENSOR_LSB_C;
+        }
+
+        static float equilibriumC(float speed, float loadW) {
+            return AMBIENT_C + loadW / (G0_W_PER_K + G1_W_PER_K * speed / 100.0f);
+        }
+    };
+
+    struct Response {
+        float settlingS;        ///< End of the last sample outside the band
+        float overshootC;       ///< Furthest past the setpoint, away from the start
+        float finalSpeed;
+    };
+
+    PidController makePid() {
+        return PidController({Config::Fan::Control::PID::KP,
+                              Config::Fan::Control::PID::KI,
+                              Config::Fan::Control::PID::KD},
+                             SETPOINT_C, MIN_SPEED, MAX_SPEED, PERIOD_S);
+    }
+
+    /**
+     * @brief Close the loop for the given time
+     * @param fromAbove The plant starts above the setpoint, overshoot is below it
+     */
+    Response simulate(PidController& pid, Plant& plant, float speed, float durationS, bool fromAbove) {
+        Response response = {0.0f, 0.0f, speed};
+        for (float t = 0.0f; t < durationS; t += PERIOD_S) {
+            speed = roundf(pid.update(plant.sense()));
+            plant.advance(speed, PERIOD_S);
+
+            float past = fromAbove ? SETPOINT_C - plant.tempC : plant.tempC - SETPOINT_C;
+            if (past > response.overshootC) response.overshootC = past;
+            if (fabsf(plant.tempC - SETPOINT_C) > SETTLE_BAND_C) response.settlingS = t + PERIOD_S;
+        }
+        response.finalSpeed = speed;
+        return response;
+    }
+
+    void report(const char* scenario, const Response& response) {
+        char message[128];
+        snprintf(message, sizeof(message), "%s: settling %.0f s (±%.1f °C), %.2f °C past the setpoint, speed %.0f%%",
+                 scenario, response.settlingS, SETTLE_BAND_C, response.overshootC, response.finalSpeed);
+        TEST_MESSAGE(message);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+/*******************************************************************************
+ * Bumpless Transfer
+ ******************************************************************************/
+
+void test_reset_continues_from_the_applied_output() {
+    PidController pid({10.0f, 0.2f, 20.0f}, 27.0f, 10.0f, 100.0f, 2.0f);
+
+    // 1 °C above the setpoint the P term is 10%; the first step may only
+    // add one step of integral action on top of the seeded output
+    pid.reset(28.0f, 30.0f);
+    float output = pid.update(28.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.2f * 1.0f * 2.0f + 1e-3f, 30.0f, output);
+
+    pid.reset(25.0f, 80.0f);
+    output = pid.update(25.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.2f * 2.0f * 2.0f + 1e-3f, 80.0f, output);
+}
+
+void test_reset_clamps_to_the_limits() {
+    PidController pid({10.0f, 0.0f, 0.0f}, 27.0f, 10.0f, 60.0f, 2.0f);
+
+    pid.reset(27.0f, 90.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 60.0f, pid.getLastOutput());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 60.0f, pid.update(27.0f));
+}
+
+void test_reset_past_the_limits_keeps_the_integrator_inside() {
+    PidController pid({10.0f, 0.0f, 0.0f}, 27.0f, 10.0f, 100.0f, 2.0f);
+
+    // The P term alone is 30%, more than the applied 10%; the integrator
+    // is seeded at the lower limit, not 20% below it
+    pid.reset(30.0f, 10.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 40.0f, pid.update(30.0f));
+}
+
+void test_unchanged_limits_keep_the_seed() {
+    PidController pid({10.0f, 0.0f, 0.0f}, 27.0f, 10.0f, 100.0f, 2.0f);
+
+    // FanController sets the limits before every step
+    pid.reset(28.0f, 20.0f);
+    pid.setOutputLimits(10.0f, 100.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 20.0f, pid.update(28.0f));
+}
+
+void test_narrowed_limits_clamp_the_integrator() {
+    PidController pid({10.0f, 0.0f, 0.0f}, 27.0f, 10.0f, 100.0f, 2.0f);
+
+    pid.reset(27.0f, 80.0f);
+    pid.setOutputLimits(10.0f, 50.0f);
+    pid.setOutputLimits(10.0f, 100.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 50.0f, pid.update(27.0f));
+
+    pid.reset(27.0f, 20.0f);
+    pid.setOutputLimits(40.0f, 100.0f);
+    pid.setOutputLimits(10.0f, 100.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 40.0f, pid.update(27.0f));
+}
+
+/*******************************************************************************
+ * Anti-Windup
+ ******************************************************************************/
+
+void test_integrator_stays_within_the_limits() {
+    // A steep fall seen by the D term holds the output inside the limits
+    // while the positive error keeps integrating
+    PidController pid({10.0f, 2.0f, 1000.0f}, 27.0f, 10.0f, 100.0f, 2.0f);
+    pid.reset(40.0f, 50.0f);
+    float measurement = 40.0f;
+    for (int i = 0; i < 20; i++) {
+        measurement -= 0.5f;
+        TEST_ASSERT_LESS_THAN(100.0f, pid.update(measurement));
+    }
+
+    // Once the fall stops 1 °C below the setpoint, only a bounded
+    // integrator lets the output drop below the upper limit at once
+    pid.update(26.0f);
+    TEST_ASSERT_LESS_THAN(100.0f, pid.update(26.0f));
+}
+
+/*******************************************************************************
+ * Closed Loop
+ ******************************************************************************/
+
+void test_settles_from_a_hot_start() {
+    // Fan at minimum speed, enclosure at its equilibrium for that speed
+    Plant plant = {Plant::equilibriumC(MIN_SPEED, LOAD_W), LOAD_W};
+    PidController pid = makePid();
+    pid.reset(plant.sense(), MIN_SPEED);
+
+    Response response = simulate(pid, plant, MIN_SPEED, 1800.0f, true);
+    report("Hot start", response);
+
+    TEST_ASSERT_LESS_THAN(600.0f, response.settlingS);
+    TEST_ASSERT_LESS_THAN(1.0f, response.overshootC);
+    TEST_ASSERT_FLOAT_WITHIN(SETTLE_BAND_C, SETPOINT_C, plant.tempC);
+}
+
+void test_rejects_a_load_step() {
+    // Settled at the setpoint, then the load rises by half
+    Plant plant = {SETPOINT_C, LOAD_W};
+    PidController pid = makePid();
+    pid.reset(plant.sense(), 50.0f);
+    simulate(pid, plant, 50.0f, 1200.0f, true);
+
+    plant.loadW = LOAD_W * 1.5f;
+    Response response = simulate(pid, plant, 50.0f, 1800.0f, false);
+    report("Load step +50%", response);
+
+    TEST_ASSERT_LESS_THAN(900.0f, response.settlingS);
+    TEST_ASSERT_LESS_THAN(2.0f, response.overshootC);
+    TEST_ASSERT_FLOAT_WITHIN(SETTLE_BAND_C, SETPOINT_C, plant.tempC);
+    TEST_ASSERT_GREATER_THAN(50.0f, response.finalSpeed);
+}
+
+void test_saturated_loop_recovers_without_windup() {
+    // Beyond what full speed can hold: the loop saturates, the integrator
+    // must not wind up and delay the recovery once the load drops again
+    Plant plant = {SETPOINT_C, LOAD_W};
+    PidController pid = makePid();
+    pid.reset(plant.sense(), 50.0f);
+
+    plant.loadW = 60.0f;
+    simulate(pid, plant, 50.0f, 1200.0f, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, MAX_SPEED, pid.getLastOutput());
+
+    plant.loadW = LOAD_W;
+    Response response = simulate(pid, plant, MAX_SPEED, 1800.0f, true);
+    report("Recovery from saturation", response);
+
+    TEST_ASSERT_LESS_THAN(900.0f, response.settlingS);
+    TEST_ASSERT_LESS_THAN(1.0f, response.overshootC);
+}
+
+void test_recovers_from_saturation_in_both_directions() {
+    // More load than full speed can hold, then none at all so the fan sits
+    // at its minimum far below the setpoint; each recovery must not wait
+    // for an integrator wound up by the saturation before it
+    Plant plant = {SETPOINT_C, LOAD_W};
+    PidController pid = makePid();
+    pid.reset(plant.sense(), 50.0f);
+
+    plant.loadW = 60.0f;
+    simulate(pid, plant, 50.0f, 1200.0f, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, MAX_SPEED, pid.getLastOutput());
+
+    plant.loadW = 0.0f;
+    simulate(pid, plant, MAX_SPEED, 3600.0f, true);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, MIN_SPEED, pid.getLastOutput());
+    TEST_ASSERT_LESS_THAN(SETPOINT_C - 2.0f, plant.tempC);
+
+    plant.loadW = LOAD_W;
+    Response response = simulate(pid, plant, MIN_SPEED, 3600.0f, false);
+    report("Recovery from low saturation", response);
+
+    TEST_ASSERT_LESS_THAN(1800.0f, response.settlingS);
+    TEST_ASSERT_LESS_THAN(1.0f, response.overshootC);
+    TEST_ASSERT_FLOAT_WITHIN(SETTLE_BAND_C, SETPOINT_C, plant.tempC);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reset_continues_from_the_applied_output);
+    RUN_TEST(test_reset_clamps_to_the_limits);
+    RUN_TEST(test_reset_past_the_limits_keeps_the_integrator_inside);
+    RUN_TEST(test_unchanged_limits_keep_the_seed);
+    RUN_TEST(test_narrowed_limits_clamp_the_integrator);
+    RUN_TEST(test_integrator_stays_within_the_limits);
+    RUN_TEST(test_settles_from_a_hot_start);
+    RUN_TEST(test_rejects_a_load_step);
+    RUN_TEST(test_saturated_loop_recovers_without_windup);
+    RUN_TEST(test_recovers_from_saturation_in_both_directions);
+    return UNITY_END();
+}
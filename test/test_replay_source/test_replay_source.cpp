@@ -0,0 +1,228 @@
+/**
+ * @file test_replay_source.cpp
+ * @brief ReplaySource through the acquisition cycle, run with `pio test -e native`
+ *
+ * Traces are built in memory in the TraceRecorder layout. The clock jumps
+ * by the delay each step returns, as in the host replay driver.
+ */
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "config.h"
+#include "clock.h"
+#include "replay_source.h"
+#include "temp_acquisition.h"
+#include "trace_format.h"
+
+namespace {
+    class JumpClock : public Clock {
+    public:
+        uint32_t nowUs() const override { return now; }
+        uint32_t now = 0;
+    };
+
+    class Recorder : public TempAcquisition::Listener {
+    public:
+        void onSample(const TempAcquisition::Sample& sample) override {
+            samples.push_back(sample);
+        }
+        std::vector<TempAcquisition::Sample> samples;
+    };
+
+    struct Record {
+        uint16_t delayMs;
+        uint8_t bits;
+        uint8_t validMask;
+        float tempC[2];
+    };
+
+    std::vector<uint8_t> buildTrace(const std::vector<Record>& records) {
+        std::vector<uint8_t> trace(TraceFormat::headerSize(2));
+        memcpy(trace.data(), TraceFormat::MAGIC, sizeof(TraceFormat::MAGIC));
+        trace[4] = TraceFormat::VERSION;
+        trace[5] = 2;
+        memcpy(&trace[TraceFormat::FILE_HEADER_SIZE], "28FF000000000001", TraceFormat::ID_SIZE);
+        memcpy(&trace[TraceFormat::FILE_HEADER_SIZE + TraceFormat::ID_SIZE], "28FF000000000002", TraceFormat::ID_SIZE);
+
+        for (const Record& record : records) {
+            size_t offset = trace.size();
+            trace.resize(offset + TraceFormat::recordSize(2));
+            TraceFormat::putU16(&trace[offset], record.delayMs);
+            trace[offset + 2] = record.bits;
+            trace[offset + 3] = record.validMask;
+            for (int i = 0; i < 2; i++) {
+                int16_t raw = static_cast<int16_t>(record.tempC[i] * TraceFormat::TEMP_SCALE);
+                TraceFormat::putU16(&trace[offset + TraceFormat::RECORD_HEADER_SIZE + i * 2], static_cast<uint16_t>(raw));
+            }
+        }
+        return trace;
+    }
+
+    const std::vector<Record> RECORDS = {
+        {0,    12, 0x3, {25.0625f, 24.5f}},
+        {2000, 12, 0x3, {25.5f, 24.5f}},
+        {250,  9,  0x1, {27.0f, 0.0f}},
+        {5000, 10, 0x2, {27.0f, 26.0f}},
+    };
+
+    /**
+     * @brief Step until the source runs out or the sample count is reached
+     */
+    void replay(ReplaySource& source, JumpClock& clock, Recorder& recorder, size_t maxSamples) {
+        TempAcquisition acquisition(source, clock, recorder);
+        for (int steps = 0; steps < 1000 && !source.isFinished() && recorder.samples.size() < maxSamples; steps++) {
+            clock.now += acquisition.step() * 1000;
+        }
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+/*******************************************************************************
+ * Header
+ ******************************************************************************/
+
+void test_rejects_invalid_traces() {
+    std::vector<uint8_t> trace = buildTrace(RECORDS);
+    ReplaySource source;
+
+    source.load(trace.data(), TraceFormat::FILE_HEADER_SIZE + TraceFormat::ID_SIZE);
+    TEST_ASSERT_EQUAL_UINT8(0, source.begin());
+
+    trace[4] = TraceFormat::VERSION + 1;
+    source.load(trace.data(), trace.size());
+    TEST_ASSERT_EQUAL_UINT8(0, source.begin());
+
+    trace[4] = TraceFormat::VERSION;
+    trace[0] = 'X';
+    TEST_ASSERT_EQUAL_UINT8(0, source.begin());
+
+    trace[0] = 'F';
+    TEST_ASSERT_EQUAL_UINT8(2, source.begin());
+    TEST_ASSERT_EQUAL_STRING("28FF000000000002", source.getReading(1).id);
+}
+
+/*******************************************************************************
+ * Playback
+ ******************************************************************************/
+
+void test_replays_values_masks_and_resolution() {
+    std::vector<uint8_t> trace = buildTrace(RECORDS);
+    ReplaySource source;
+    source.load(trace.data(), trace.size());
+    source.begin();
+
+    JumpClock clock;
+    Recorder recorder;
+    replay(source, clock, recorder, RECORDS.size());
+    TEST_ASSERT_EQUAL_UINT32(RECORDS.size(), recorder.samples.size());
+
+    TEST_ASSERT_EQUAL_FLOAT(25.0625f, recorder.samples[0].controlTemp);
+    TEST_ASSERT_EQUAL_UINT8(2, recorder.samples[0].validCount);
+    TEST_ASSERT_EQUAL_FLOAT(27.0f, recorder.samples[2].controlTemp);
+    TEST_ASSERT_EQUAL_UINT8(9, recorder.samples[2].resolution);
+
+    // Probe 0 failed in the last record, its value is not the control
+    TEST_ASSERT_EQUAL_FLOAT(26.0f, recorder.samples[3].controlTemp);
+    TEST_ASSERT_EQUAL_UINT8(1, recorder.samples[3].validCount);
+    TEST_ASSERT_FALSE(source.getReading(0).valid);
+    TEST_ASSERT_EQUAL_UINT8(1, source.getReading(0).failures);
+}
+
+void test_samples_keep_the_recorded_timing() {
+    std::vector<uint8_t> trace = buildTrace(RECORDS);
+    ReplaySource source(1.0f);
+    source.load(trace.data(), trace.size());
+    source.begin();
+
+    JumpClock clock;
+    Recorder recorder;
+    replay(source, clock, recorder, RECORDS.size());
+    for (size_t i = 1; i < RECORDS.size(); i++) {
+        uint32_t gapMs = (recorder.samples[i].timestampUs - recorder.samples[i - 1].timestampUs) / 1000;
+        TEST_ASSERT_EQUAL_UINT32(RECORDS[i].delayMs, gapMs);
+    }
+}
+
+void test_speed_scales_the_delays() {
+    std::vector<uint8_t> trace = buildTrace(RECORDS);
+    ReplaySource fast(4.0f);
+    fast.load(trace.data(), trace.size());
+    fast.begin();
+
+    JumpClock clock;
+    Recorder recorder;
+    replay(fast, clock, recorder, RECORDS.size());
+    uint32_t gapMs = (recorder.samples[3].timestampUs - recorder.samples[2].timestampUs) / 1000;
+    TEST_ASSERT_EQUAL_UINT32(RECORDS[3].delayMs / 4, gapMs);
+
+    ReplaySource unpaced(0.0f);
+    unpaced.load(trace.data(), trace.size());
+    unpaced.begin();
+    JumpClock unpacedClock;
+    Recorder unpacedRecorder;
+    replay(unpaced, unpacedClock, unpacedRecorder, RECORDS.size());
+
+    // Only the conversion poll is left between records
+    uint32_t spanUs = unpacedRecorder.samples[3].timestampUs - unpacedRecorder.samples[0].timestampUs;
+    TEST_ASSERT_LESS_OR_EQUAL(3 * Config::Temperature::Resolution::POLL_MS * 1000, spanUs);
+}
+
+void test_records_resolution_requests() {
+    if (!Config::Temperature::Resolution::ADAPTIVE) TEST_IGNORE();
+
+    // Recorded at 12 bits throughout, with a 2 °C step within 250 ms
+    std::vector<uint8_t> trace = buildTrace({
+        {0,    12, 0x3, {25.0f, 24.5f}},
+        {2000, 12, 0x3, {25.0f, 24.5f}},
+        {250,  12, 0x3, {27.0f, 24.5f}},
+    });
+    ReplaySource source;
+    source.load(trace.data(), trace.size());
+    source.begin();
+    TEST_ASSERT_EQUAL_UINT8(0, source.getRequestedResolution());
+
+    JumpClock clock;
+    Recorder recorder;
+    replay(source, clock, recorder, 3);
+    TEST_ASSERT_EQUAL_UINT8(Config::Temperature::Resolution::MIN_BITS, source.getRequestedResolution());
+
+    // The recorded resolution is still what the source reports
+    TEST_ASSERT_EQUAL_UINT8(12, source.getResolution());
+}
+
+void test_end_of_trace() {
+    std::vector<uint8_t> trace = buildTrace(RECORDS);
+
+    ReplaySource once(0.0f, false);
+    once.load(trace.data(), trace.size());
+    once.begin();
+    JumpClock clock;
+    Recorder recorder;
+    replay(once, clock, recorder, 100);
+    TEST_ASSERT_TRUE(once.isFinished());
+    TEST_ASSERT_EQUAL_UINT32(RECORDS.size(), once.getRecordIndex());
+    TEST_ASSERT_FALSE(once.getReading(1).valid);
+
+    ReplaySource looping(0.0f, true);
+    looping.load(trace.data(), trace.size());
+    looping.begin();
+    JumpClock loopClock;
+    Recorder loopRecorder;
+    replay(looping, loopClock, loopRecorder, 2 * RECORDS.size() + 1);
+    TEST_ASSERT_FALSE(looping.isFinished());
+    TEST_ASSERT_EQUAL_FLOAT(25.0625f, loopRecorder.samples[RECORDS.size()].controlTemp);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_rejects_invalid_traces);
+    RUN_TEST(test_replays_values_masks_and_resolution);
+    RUN_TEST(test_samples_keep_the_recorded_timing);
+    RUN_TEST(test_speed_scales_the_delays);
+    RUN_TEST(test_records_resolution_requests);
+    RUN_TEST(test_end_of_trace);
+    return UNITY_END();
+}
@@ -0,0 +1,258 @@
+/**
+ * @file test_signal_filter.cpp
+ * @brief Step responses and update cost of signal_filter.h, run with `pio test -e native`
+ *
+ * Every filter is primed at 0 and fed a unit step. The benchmarks time
+ * update() on the host CPU; they compare the filters with each other and
+ * do not predict cycles on the ESP32-S3.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "config.h"
+#include "signal_filter.h"
+
+namespace {
+    constexpr float STEP = 1.0f;
+
+    /**
+     * @brief Samples until the output first reaches the given fraction of the step
+     */
+    template <typename F>
+    int samplesToReach(F& filter, float fraction, int limit = 1000) {
+        filter.reset(0.0f);
+        for (int i = 1; i <= limit; i++) {
+            if (filter.update(STEP) >= fraction * STEP) return i;
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Mean cost of one update() over a noisy signal
+     */
+    template <typename F>
+    void benchmark(const char* name, F& filter) {
+        constexpr int SAMPLES = 1000000;
+        static float input[1024];
+        for (float& sample : input) {
+            sample = 25.0f + (rand() % 1000) / 1000.0f;
+        }
+
+        filter.reset(25.0f);
+        volatile float sink = 0.0f;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < SAMPLES; i++) {
+            sink = filter.update(input[i & 1023]);
+        }
+        auto end = std::chrono::steady_clock::now();
+        (void)sink;
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / SAMPLES;
+        char message[96];
+        snprintf(message, sizeof(message), "%-28s %6.1f ns/update", name, ns);
+        TEST_MESSAGE(message);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+/*******************************************************************************
+ * MovingAverage
+ ******************************************************************************/
+
+void test_moving_average_step_is_a_ramp() {
+    MovingAverage<5> filter;
+    filter.reset(0.0f);
+    for (int i = 1; i <= 5; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, STEP * i / 5, filter.update(STEP));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, STEP, filter.update(STEP));
+}
+
+void test_moving_average_does_not_drift() {
+    MovingAverage<5> filter;
+    filter.reset(25.0f);
+    srand(1);
+    for (int i = 0; i < 1000000; i++) {
+        filter.update(20.0f + (rand() % 10000) / 1000.0f);
+    }
+
+    // The fixed point sum cancels exactly once the noise has left the window
+    float output = 0.0f;
+    for (int i = 0; i < 5; i++) {
+        output = filter.update(25.0625f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f / 2, 25.0625f, output);
+}
+
+/*******************************************************************************
+ * ExponentialAverage
+ ******************************************************************************/
+
+void test_exponential_step_is_geometric() {
+    ExponentialAverage filter(0.3f);
+    filter.reset(0.0f);
+    for (int i = 1; i <= 10; i++) {
+        float expected = STEP * (1.0f - powf(0.7f, i));
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected, filter.update(STEP));
+    }
+}
+
+void test_exponential_alpha_sets_the_speed() {
+    ExponentialAverage slow(0.1f);
+    ExponentialAverage fast(0.5f);
+
+    // 90% after ln(0.1) / ln(1 - alpha) samples
+    TEST_ASSERT_EQUAL_INT(22, samplesToReach(slow, 0.9f));
+    TEST_ASSERT_EQUAL_INT(4, samplesToReach(fast, 0.9f));
+
+    fast.setAlpha(1.0f);
+    TEST_ASSERT_EQUAL_INT(1, samplesToReach(fast, 1.0f));
+}
+
+/*******************************************************************************
+ * MedianFilter
+ ******************************************************************************/
+
+void test_median_step_is_delayed_by_half_the_window() {
+    MedianFilter<5> filter;
+    filter.reset(0.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, filter.update(STEP));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, filter.update(STEP));
+    TEST_ASSERT_EQUAL_FLOAT(STEP, filter.update(STEP));
+}
+
+void test_median_rejects_isolated_spikes() {
+    MedianFilter<3> filter;
+    filter.reset(25.0f);
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, filter.update(85.0f));      // DS18B20 power-on value
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, filter.update(25.0f));
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, filter.update(-127.0f));    // Disconnected probe
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, filter.update(25.0f));
+}
+
+void test_median_tracks_a_noisy_signal() {
+    // Against a full sort of the window, with repeated values
+    MedianFilter<5> filter;
+    float window[5] = {};
+    filter.reset(0.0f);
+    srand(2);
+    for (int i = 0; i < 10000; i++) {
+        float sample = static_cast<float>(rand() % 8);
+        window[i % 5] = sample;
+
+        float sorted[5];
+        for (int j = 0; j < 5; j++) sorted[j] = window[j];
+        for (int j = 1; j < 5; j++) {
+            for (int k = j; k > 0 && sorted[k - 1] > sorted[k]; k--) {
+                float swap = sorted[k];
+                sorted[k] = sorted[k - 1];
+                sorted[k - 1] = swap;
+            }
+        }
+        TEST_ASSERT_EQUAL_FLOAT(sorted[2], filter.update(sample));
+    }
+}
+
+/*******************************************************************************
+ * KalmanFilter1D
+ ******************************************************************************/
+
+void test_kalman_step_rises_without_overshoot() {
+    KalmanFilter1D filter(0.001f, 0.01f);
+    filter.reset(0.0f);
+    float previous = 0.0f;
+    for (int i = 0; i < 200; i++) {
+        float output = filter.update(STEP);
+        TEST_ASSERT_GREATER_OR_EQUAL(previous, output);
+        TEST_ASSERT_LESS_OR_EQUAL(STEP, output);
+        previous = output;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, STEP, previous);
+}
+
+void test_kalman_noise_ratio_sets_the_speed() {
+    KalmanFilter1D smooth(0.0001f, 0.01f);
+    KalmanFilter1D responsive(0.01f, 0.01f);
+
+    int smoothSamples = samplesToReach(smooth, 0.9f);
+    int responsiveSamples = samplesToReach(responsive, 0.9f);
+    TEST_ASSERT_GREATER_THAN(responsiveSamples, smoothSamples);
+
+    char message[96];
+    snprintf(message, sizeof(message), "90%% of a step: q/r 0.01 after %d samples, q/r 1 after %d",
+             smoothSamples, responsiveSamples);
+    TEST_MESSAGE(message);
+}
+
+/*******************************************************************************
+ * FilterChain
+ ******************************************************************************/
+
+void test_chain_feeds_each_stage_into_the_next() {
+    FilterChain<MedianFilter<3>, MovingAverage<4>> chain;
+    MedianFilter<3> median;
+    MovingAverage<4> average;
+    chain.reset(0.0f);
+    median.reset(0.0f);
+    average.reset(0.0f);
+
+    srand(3);
+    for (int i = 0; i < 1000; i++) {
+        float sample = (rand() % 1000) / 100.0f;
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, average.update(median.update(sample)), chain.update(sample));
+    }
+}
+
+void test_chain_stages_are_tunable() {
+    FilterChain<MedianFilter<3>, ExponentialAverage> chain;
+    chain.get<ExponentialAverage>().setAlpha(1.0f);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, chain.get<1>().getAlpha());
+
+    // With alpha 1 the chain is the median alone
+    chain.reset(0.0f);
+    chain.update(STEP);
+    TEST_ASSERT_EQUAL_FLOAT(STEP, chain.update(STEP));
+}
+
+/*******************************************************************************
+ * Benchmarks
+ ******************************************************************************/
+
+void test_update_cost() {
+    MovingAverage<Config::Temperature::SMOOTH_SAMPLES> average;
+    ExponentialAverage exponential;
+    MedianFilter<Config::Temperature::MEDIAN_SAMPLES> median;
+    MedianFilter<9> wideMedian;
+    KalmanFilter1D kalman;
+    FilterChain<MedianFilter<Config::Temperature::MEDIAN_SAMPLES>,
+                MovingAverage<Config::Temperature::SMOOTH_SAMPLES>> smoothing;
+
+    benchmark("MovingAverage<5>", average);
+    benchmark("ExponentialAverage", exponential);
+    benchmark("MedianFilter<3>", median);
+    benchmark("MedianFilter<9>", wideMedian);
+    benchmark("KalmanFilter1D", kalman);
+    benchmark("TempSensor smoothing chain", smoothing);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_moving_average_step_is_a_ramp);
+    RUN_TEST(test_moving_average_does_not_drift);
+    RUN_TEST(test_exponential_step_is_geometric);
+    RUN_TEST(test_exponential_alpha_sets_the_speed);
+    RUN_TEST(test_median_step_is_delayed_by_half_the_window);
+    RUN_TEST(test_median_rejects_isolated_spikes);
+    RUN_TEST(test_median_tracks_a_noisy_signal);
+    RUN_TEST(test_kalman_step_rises_without_overshoot);
+    RUN_TEST(test_kalman_noise_ratio_sets_the_speed);
+    RUN_TEST(test_chain_feeds_each_stage_into_the_next);
+    RUN_TEST(test_chain_stages_are_tunable);
+    RUN_TEST(test_update_cost);
+    return UNITY_END();
+}
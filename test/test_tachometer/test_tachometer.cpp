@@ -0,0 +1,195 @@
+/**
+ * @file test_tachometer.cpp
+ * @brief Tachometer driven by SimulatedTachSource, run with `pio test -e native`
+ *
+ * The firmware reads the estimator when a revolution event arrives, at
+ * most every Config::Fan::RPM::EVENT_INTERVAL_US, and once per
+ * Config::Fan::RPM::UPDATE_INTERVAL otherwise. readOnEvents() reproduces
+ * that cadence on a 1 ms time base.
+ */
+
+#include <unity.h>
+#include <cstdio>
+#include <cstdlib>
+#include "config.h"
+#include "tachometer.h"
+
+namespace {
+    constexpr uint32_t STEP_US = 1000;
+    constexpr uint32_t POLL_US = Config::Fan::RPM::UPDATE_INTERVAL * 1000UL;
+
+    SimulatedTachSource source;
+    Tachometer tachometer;
+    uint32_t nowUs;
+    uint32_t lastRevolutions;
+    uint32_t lastEventUs;
+
+    /**
+     * @brief Advance the time, reading the estimator like the fan task does
+     * @return Time in microseconds until the reading is within tolerance
+     *         of the expected RPM, or durationUs if it never is
+     */
+    uint32_t readOnEvents(uint32_t durationUs, uint16_t expected, uint16_t tolerance) {
+        uint32_t startUs = nowUs;
+        uint32_t reachedUs = durationUs;
+        uint32_t nextPollUs = nowUs + POLL_US;
+
+        for (uint32_t elapsed = 0; elapsed < durationUs; elapsed += STEP_US) {
+            nowUs += STEP_US;
+
+            bool read = false;
+            uint32_t revolutions = source.capture(nowUs).revolutions;
+            if (revolutions != lastRevolutions &&
+                nowUs - lastEventUs >= Config::Fan::RPM::EVENT_INTERVAL_US) {
+                lastEventUs = nowUs;
+                read = true;
+            }
+            lastRevolutions = revolutions;
+            if (static_cast<int32_t>(nowUs - nextPollUs) >= 0) {
+                nextPollUs += POLL_US;
+                read = true;
+            }
+
+            if (read) {
+                uint16_t rpm = tachometer.update(nowUs);
+                if (reachedUs == durationUs && abs(rpm - expected) <= tolerance) {
+                    reachedUs = nowUs - startUs;
+                }
+            }
+        }
+        return reachedUs;
+    }
+
+    void report(const char* scenario, uint32_t latencyUs) {
+        char message[96];
+        snprintf(message, sizeof(message), "%s: reading after %lu ms",
+                 scenario, static_cast<unsigned long>(latencyUs / 1000));
+        TEST_MESSAGE(message);
+    }
+}
+
+void setUp() {
+    source = SimulatedTachSource();
+    tachometer = Tachometer();
+    nowUs = 0;
+    lastRevolutions = 0;
+    lastEventUs = 0;
+    TEST_ASSERT_TRUE(tachometer.begin(&source));
+}
+
+void tearDown() {}
+
+/*******************************************************************************
+ * Resolution
+ ******************************************************************************/
+
+void test_reports_zero_without_revolutions() {
+    TEST_ASSERT_EQUAL_UINT16(0, tachometer.update(nowUs));
+    readOnEvents(3 * POLL_US, 0, 0);
+    TEST_ASSERT_EQUAL_UINT16(0, tachometer.getRPM());
+}
+
+void test_needs_two_revolutions_for_a_period() {
+    source.setRPM(600);
+    source.capture(nowUs);
+
+    // First revolution at 100 ms is only the reference
+    nowUs += 100000;
+    TEST_ASSERT_EQUAL_UINT16(0, tachometer.update(nowUs));
+    nowUs += 100000;
+    TEST_ASSERT_EQUAL_UINT16(600, tachometer.update(nowUs));
+}
+
+void test_low_speed_is_not_quantized() {
+    // A 1 s window of 2 pulses per revolution resolved only 30 RPM steps
+    const uint16_t speeds[] = {Config::Fan::RPM::MINIMUM, 217, 1234, Config::Fan::RPM::MAXIMUM};
+    for (uint16_t rpm : speeds) {
+        setUp();
+        source.setRPM(rpm);
+        readOnEvents(2 * POLL_US, rpm, 1);
+        TEST_ASSERT_UINT16_WITHIN(1, rpm, tachometer.getRPM());
+    }
+}
+
+void test_polling_averages_revolutions_between_reads() {
+    source.setRPM(1500);
+    source.capture(nowUs);
+    nowUs += 40000;
+    tachometer.update(nowUs);
+
+    // 37.5 revolutions in one poll interval, read once at the end
+    nowUs += POLL_US;
+    TEST_ASSERT_UINT16_WITHIN(1, 1500, tachometer.update(nowUs));
+}
+
+/*******************************************************************************
+ * Latency
+ ******************************************************************************/
+
+void test_speed_step_is_read_within_one_revolution() {
+    source.setRPM(1200);
+    readOnEvents(2 * POLL_US, 1200, 1);
+
+    // Slow fan: every revolution is an event, period 100 ms
+    source.setRPM(600);
+    uint32_t latencyUs = readOnEvents(POLL_US, 600, 6);
+    report("1200 -> 600 RPM", latencyUs);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(100000 + STEP_US, latencyUs);
+
+    // Fast fan: events are throttled, the reading lags by at most one interval
+    source.setRPM(3000);
+    latencyUs = readOnEvents(POLL_US, 3000, 30);
+    report("600 -> 3000 RPM", latencyUs);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(20000 + Config::Fan::RPM::EVENT_INTERVAL_US + STEP_US, latencyUs);
+}
+
+void test_stopping_fan_decays_to_zero() {
+    source.setRPM(1200);
+    readOnEvents(2 * POLL_US, 1200, 1);
+
+    // No revolution arrives: the polled reading falls with the elapsed
+    // time instead of holding the last period
+    source.setRPM(0);
+    nowUs += 500000;
+    uint16_t bounded = tachometer.update(nowUs);
+    TEST_ASSERT_LESS_THAN_UINT16(1200, bounded);
+    TEST_ASSERT_GREATER_THAN_UINT16(0, bounded);
+
+    uint32_t latencyUs = readOnEvents(2 * POLL_US, 0, 0) + 500000;
+    report("1200 -> 0 RPM", latencyUs);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(Config::Fan::RPM::TIMEOUT_MS * 1000UL + POLL_US, latencyUs);
+    TEST_ASSERT_EQUAL_UINT16(0, tachometer.getRPM());
+}
+
+void test_restarted_fan_is_read_again() {
+    source.setRPM(900);
+    readOnEvents(2 * POLL_US, 900, 1);
+    source.setRPM(0);
+    readOnEvents(2 * POLL_US, 0, 0);
+    TEST_ASSERT_EQUAL_UINT16(0, tachometer.getRPM());
+
+    source.setRPM(900);
+    readOnEvents(2 * POLL_US, 900, 1);
+    TEST_ASSERT_UINT16_WITHIN(1, 900, tachometer.getRPM());
+}
+
+void test_survives_timer_wraparound() {
+    nowUs = UINT32_MAX - 250000;
+    lastEventUs = nowUs;
+    source.setRPM(1800);
+    readOnEvents(2 * POLL_US, 1800, 1);
+    TEST_ASSERT_UINT16_WITHIN(1, 1800, tachometer.getRPM());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reports_zero_without_revolutions);
+    RUN_TEST(test_needs_two_revolutions_for_a_period);
+    RUN_TEST(test_low_speed_is_not_quantized);
+    RUN_TEST(test_polling_averages_revolutions_between_reads);
+    RUN_TEST(test_speed_step_is_read_within_one_revolution);
+    RUN_TEST(test_stopping_fan_decays_to_zero);
+    RUN_TEST(test_restarted_fan_is_read_again);
+    RUN_TEST(test_survives_timer_wraparound);
+    return UNITY_END();
+}
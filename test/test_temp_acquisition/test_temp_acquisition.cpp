@@ -0,0 +1,316 @@
+/**
+ * @file test_temp_acquisition.cpp
+ * @brief TempAcquisition against a fake probe bus, run with `pio test -e native`
+ *
+ * FakeBus stands in for SensorBus: it counts every bus transaction, holds
+ * scripted probe temperatures and completes a conversion after the time
+ * its power mode needs. FakeClock only moves when a test advances it.
+ */
+
+#include <unity.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
+#include "config.h"
+#include "clock.h"
+#include "temperature_source.h"
+#include "temp_acquisition.h"
+
+namespace {
+    using Phase = TempAcquisition::Phase;
+    namespace Resolution = Config::Temperature::Resolution;
+
+    class FakeClock : public Clock {
+    public:
+        uint32_t nowUs() const override { return now; }
+        void advanceMs(uint32_t ms) { now += ms * 1000; }
+
+        uint32_t now = 0;
+    };
+
+    class FakeBus : public TemperatureSource {
+    public:
+        explicit FakeBus(const FakeClock& timeSource) : clock(timeSource) {}
+
+        uint8_t begin() override {
+            for (uint8_t i = 0; i < count; i++) {
+                snprintf(readings[i].id, ID_LENGTH, "28FF0000000000%02X", i);
+            }
+            return count;
+        }
+
+        void requestConversion() override {
+            transactions++;
+            conversions++;
+            conversionStartUs = clock.nowUs();
+        }
+
+        bool isConversionComplete() override {
+            transactions++;
+            // Parasite powered probes hold the line low until the time is up
+            if (parasite) return false;
+            return clock.nowUs() - conversionStartUs >= completeAfterMs * 1000;
+        }
+
+        uint8_t readAll() override {
+            transactions++;
+            uint8_t valid = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                readings[i].valid = !failing[i];
+                if (readings[i].valid) {
+                    readings[i].tempC = tempC[i];
+                    readings[i].failures = 0;
+                    valid++;
+                } else {
+                    readings[i].failures++;
+                }
+            }
+            return valid;
+        }
+
+        bool setResolution(uint8_t value) override {
+            transactions++;
+            bits = clampBits(value);
+            return true;
+        }
+
+        uint8_t getResolution() const override { return bits; }
+        uint8_t getCount() const override { return count; }
+        const Reading& getReading(uint8_t index) const override { return readings[index]; }
+        const char* getName() const override { return "fake"; }
+
+        const FakeClock& clock;
+        uint8_t count = 3;
+        float tempC[MAX_SENSORS] = {};
+        bool failing[MAX_SENSORS] = {};
+        bool parasite = false;
+        uint32_t completeAfterMs = 100;
+        uint8_t bits = Resolution::DEFAULT_BITS;
+        uint32_t transactions = 0;
+        uint32_t conversions = 0;
+        uint32_t conversionStartUs = 0;
+        Reading readings[MAX_SENSORS] = {};
+    };
+
+    class Recorder : public TempAcquisition::Listener {
+    public:
+        void onSample(const TempAcquisition::Sample& sample) override {
+            last = sample;
+            samples++;
+        }
+
+        TempAcquisition::Sample last = {};
+        uint32_t samples = 0;
+    };
+
+    FakeClock* clock;
+    FakeBus* bus;
+    Recorder* recorder;
+    TempAcquisition* acquisition;
+
+    /**
+     * @brief Step the machine like the temperature task, sleeping as told
+     * @return Bus transactions of the busiest single step
+     */
+    uint32_t runUntilSample() {
+        uint32_t before = recorder->samples;
+        uint32_t busiest = 0;
+        for (int steps = 0; recorder->samples == before; steps++) {
+            TEST_ASSERT_TRUE_MESSAGE(steps < 10000, "no sample published");
+            uint32_t transactions = bus->transactions;
+            uint32_t delayMs = acquisition->step();
+            busiest = std::max(busiest, bus->transactions - transactions);
+            clock->advanceMs(delayMs);
+        }
+        return busiest;
+    }
+
+    void setProbes(float a, float b, float c) {
+        bus->tempC[0] = a;
+        bus->tempC[1] = b;
+        bus->tempC[2] = c;
+    }
+}
+
+void setUp() {
+    clock = new FakeClock();
+    bus = new FakeBus(*clock);
+    recorder = new Recorder();
+    acquisition = new TempAcquisition(*bus, *clock, *recorder);
+    bus->begin();
+    setProbes(24.0f, 26.5f, 25.0f);
+}
+
+void tearDown() {
+    delete acquisition;
+    delete recorder;
+    delete bus;
+    delete clock;
+}
+
+/*******************************************************************************
+ * Cycle
+ ******************************************************************************/
+
+void test_cycle_walks_every_phase() {
+    TEST_ASSERT_EQUAL(Phase::IDLE, acquisition->getPhase());
+    acquisition->step();
+    TEST_ASSERT_EQUAL(Phase::CONVERTING, acquisition->getPhase());
+    TEST_ASSERT_EQUAL_UINT32(1, bus->conversions);
+
+    clock->advanceMs(bus->completeAfterMs);
+    acquisition->step();
+    TEST_ASSERT_EQUAL(Phase::READING, acquisition->getPhase());
+    acquisition->step();
+    TEST_ASSERT_EQUAL(Phase::PUBLISH, acquisition->getPhase());
+    TEST_ASSERT_EQUAL_UINT32(0, recorder->samples);
+    acquisition->step();
+    TEST_ASSERT_EQUAL(Phase::IDLE, acquisition->getPhase());
+    TEST_ASSERT_EQUAL_UINT32(1, recorder->samples);
+}
+
+void test_each_step_is_at_most_one_transaction() {
+    for (int i = 0; i < 20; i++) {
+        setProbes(24.0f + i, 26.5f, 25.0f);
+        TEST_ASSERT_LESS_OR_EQUAL(1, runUntilSample());
+    }
+}
+
+void test_control_temperature_is_the_hottest_valid_probe() {
+    runUntilSample();
+    TEST_ASSERT_EQUAL_UINT8(3, recorder->last.validCount);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 26.5f, recorder->last.controlTemp);
+
+    bus->failing[1] = true;
+    runUntilSample();
+    TEST_ASSERT_EQUAL_UINT8(2, recorder->last.validCount);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 25.0f, recorder->last.controlTemp);
+}
+
+void test_all_probes_failing_publishes_no_valid_reading() {
+    bus->failing[0] = bus->failing[1] = bus->failing[2] = true;
+    runUntilSample();
+    TEST_ASSERT_EQUAL_UINT8(0, recorder->last.validCount);
+    TEST_ASSERT_EQUAL_FLOAT(-FLT_MAX, recorder->last.controlTemp);
+    TEST_ASSERT_EQUAL_UINT8(1, bus->getReading(0).failures);
+}
+
+/*******************************************************************************
+ * Conversion Timing
+ ******************************************************************************/
+
+void test_powered_probes_are_read_on_completion() {
+    bus->completeAfterMs = 120;
+    acquisition->step();
+    uint32_t startUs = clock->now;
+    runUntilSample();
+
+    // Polled every POLL_MS, read well before the 750 ms datasheet bound
+    uint32_t waitedMs = (recorder->last.timestampUs - startUs) / 1000;
+    TEST_ASSERT_GREATER_OR_EQUAL(bus->completeAfterMs, waitedMs);
+    TEST_ASSERT_LESS_THAN(bus->completeAfterMs + Resolution::POLL_MS + 1, waitedMs);
+}
+
+void test_parasite_probes_wait_for_the_datasheet_time() {
+    bus->parasite = true;
+    acquisition->step();
+    uint32_t startUs = clock->now;
+    runUntilSample();
+
+    uint32_t waitedMs = (recorder->last.timestampUs - startUs) / 1000;
+    TEST_ASSERT_GREATER_OR_EQUAL(TemperatureSource::conversionTimeMs(Resolution::DEFAULT_BITS), waitedMs);
+}
+
+void test_samples_follow_the_interval() {
+    runUntilSample();
+    uint32_t firstUs = recorder->last.timestampUs;
+    runUntilSample();
+
+    uint32_t periodMs = (recorder->last.timestampUs - firstUs) / 1000;
+    TEST_ASSERT_UINT32_WITHIN(Resolution::POLL_MS, acquisition->getSampleIntervalMs(), periodMs);
+}
+
+/*******************************************************************************
+ * Adaptive Resolution
+ ******************************************************************************/
+
+void test_transient_drops_to_coarse_and_fast() {
+    if (!Resolution::ADAPTIVE) TEST_IGNORE();
+
+    runUntilSample();
+    runUntilSample();
+    TEST_ASSERT_EQUAL_UINT8(Resolution::MAX_BITS, bus->getResolution());
+
+    // 5 °C in one 2 s period is far above FAST_RATE
+    setProbes(24.0f, 31.5f, 25.0f);
+    runUntilSample();
+    TEST_ASSERT_EQUAL_UINT8(Resolution::MIN_BITS, bus->getResolution());
+    TEST_ASSERT_EQUAL_UINT32(Config::Temperature::READ_INTERVAL_MS >> (Resolution::MAX_BITS - Resolution::MIN_BITS),
+                             acquisition->getSampleIntervalMs());
+}
+
+void test_stable_readings_step_back_up() {
+    if (!Resolution::ADAPTIVE) TEST_IGNORE();
+
+    runUntilSample();
+    setProbes(24.0f, 31.5f, 25.0f);
+    runUntilSample();
+    runUntilSample();
+    TEST_ASSERT_EQUAL_UINT8(Resolution::MIN_BITS, bus->getResolution());
+
+    // One bit per STABLE_SAMPLES steady samples
+    uint32_t samples = 0;
+    while (bus->getResolution() < Resolution::MAX_BITS && samples < 100) {
+        runUntilSample();
+        samples++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(Resolution::MAX_BITS, bus->getResolution());
+    TEST_ASSERT_EQUAL_UINT32((Resolution::MAX_BITS - Resolution::MIN_BITS) * Resolution::STABLE_SAMPLES - 1, samples);
+}
+
+/*******************************************************************************
+ * Phase Histogram
+ ******************************************************************************/
+
+void test_histogram_records_every_phase() {
+    for (int i = 0; i < 10; i++) runUntilSample();
+
+    const TempAcquisition::Histogram& converting = acquisition->getHistogram(Phase::CONVERTING);
+    TEST_ASSERT_EQUAL_UINT32(10, converting.count);
+    TEST_ASSERT_GREATER_OR_EQUAL(bus->completeAfterMs * 1000, converting.maxUs);
+    TEST_ASSERT_GREATER_OR_EQUAL(converting.maxUs, converting.percentileUs(100));
+
+    // Time never advances inside READING and PUBLISH
+    TEST_ASSERT_EQUAL_UINT32(10, acquisition->getHistogram(Phase::READING).count);
+    TEST_ASSERT_EQUAL_UINT32(0, acquisition->getHistogram(Phase::READING).maxUs);
+
+    // The wait before the first cycle is not a sample period
+    TEST_ASSERT_EQUAL_UINT32(9, acquisition->getHistogram(Phase::IDLE).count);
+}
+
+void test_clock_wraparound_keeps_the_interval() {
+    clock->now = UINT32_MAX - 1000000;
+    runUntilSample();
+    uint32_t firstUs = recorder->last.timestampUs;
+    runUntilSample();
+
+    uint32_t periodMs = (recorder->last.timestampUs - firstUs) / 1000;
+    TEST_ASSERT_UINT32_WITHIN(Resolution::POLL_MS, acquisition->getSampleIntervalMs(), periodMs);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_cycle_walks_every_phase);
+    RUN_TEST(test_each_step_is_at_most_one_transaction);
+    RUN_TEST(test_control_temperature_is_the_hottest_valid_probe);
+    RUN_TEST(test_all_probes_failing_publishes_no_valid_reading);
+    RUN_TEST(test_powered_probes_are_read_on_completion);
+    RUN_TEST(test_parasite_probes_wait_for_the_datasheet_time);
+    RUN_TEST(test_samples_follow_the_interval);
+    RUN_TEST(test_transient_drops_to_coarse_and_fast);
+    RUN_TEST(test_stable_readings_step_back_up);
+    RUN_TEST(test_histogram_records_every_phase);
+    RUN_TEST(test_clock_wraparound_keeps_the_interval);
+    return UNITY_END();
+}
@@ -0,0 +1,194 @@
+/**
+ * @file test_trend_estimator.cpp
+ * @brief TrendEstimator against a reference fit, run with `pio test -e native`
+ *
+ * The reference refits the same window from scratch in double precision,
+ * as the estimator did before it kept running sums.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include "config.h"
+#include "trend_estimator.h"
+
+namespace {
+    constexpr uint32_t WINDOW_MS = Config::Temperature::Trend::WINDOW_MS;
+    constexpr size_t CAPACITY = Config::Temperature::Trend::MAX_SAMPLES;
+    constexpr size_t MIN_SAMPLES = Config::Temperature::Trend::MIN_SAMPLES;
+
+    using Estimator = TrendEstimator<CAPACITY>;
+
+    /**
+     * @brief O(N) least-squares fit over the same window and capacity
+     */
+    class ReferenceFit {
+    public:
+        float update(uint32_t timestampUs, float value) {
+            samples.push_back({timestampUs, value});
+            if (samples.size() > CAPACITY) samples.pop_front();
+            while (samples.size() > 1 && timestampUs - samples.front().timeUs > WINDOW_MS * 1000UL) {
+                samples.pop_front();
+            }
+            if (samples.size() < MIN_SAMPLES) return 0.0f;
+
+            double meanT = 0.0;
+            double meanV = 0.0;
+            for (const Sample& sample : samples) {
+                meanT += -static_cast<double>(timestampUs - sample.timeUs) * 1e-6;
+                meanV += sample.value;
+            }
+            meanT /= samples.size();
+            meanV /= samples.size();
+
+            double covariance = 0.0;
+            double variance = 0.0;
+            for (const Sample& sample : samples) {
+                double dt = -static_cast<double>(timestampUs - sample.timeUs) * 1e-6 - meanT;
+                covariance += dt * (sample.value - meanV);
+                variance += dt * dt;
+            }
+            return variance > 0.0 ? static_cast<float>(covariance / variance) : 0.0f;
+        }
+
+        size_t size() const { return samples.size(); }
+
+    private:
+        struct Sample {
+            uint32_t timeUs;
+            float value;
+        };
+        std::deque<Sample> samples;
+    };
+
+    float noise(float amplitude) {
+        return amplitude * ((rand() % 2001) / 1000.0f - 1.0f);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+/*******************************************************************************
+ * Fit
+ ******************************************************************************/
+
+void test_no_slope_before_min_samples() {
+    Estimator trend(WINDOW_MS, MIN_SAMPLES);
+    for (size_t i = 0; i < MIN_SAMPLES - 1; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(0.0f, trend.update(i * 2000000UL, 25.0f + i));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, trend.update((MIN_SAMPLES - 1) * 2000000UL, 25.0f + MIN_SAMPLES - 1));
+}
+
+void test_ramp_slope_at_varying_rate() {
+    // 0.03 °C/s, sampled every 250 ms to 2 s like the adaptive resolution
+    Estimator trend(WINDOW_MS, MIN_SAMPLES);
+    const uint32_t periodsMs[] = {2000, 250, 500, 1000, 250, 2000};
+    uint32_t nowUs = 0;
+    float slope = 0.0f;
+    for (int i = 0; i < 600; i++) {
+        nowUs += periodsMs[(i / 50) % 6] * 1000UL;
+        slope = trend.update(nowUs, 25.0f + 0.03f * nowUs * 1e-6f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.03f, slope);
+}
+
+void test_constant_timestamps_report_no_slope() {
+    Estimator trend(WINDOW_MS, 2);
+    trend.update(1000000, 25.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, trend.update(1000000, 26.0f));
+}
+
+/*******************************************************************************
+ * Window
+ ******************************************************************************/
+
+void test_old_samples_expire() {
+    Estimator trend(WINDOW_MS, MIN_SAMPLES);
+    for (uint32_t i = 0; i < 10; i++) {
+        trend.update(i * 2000000UL, 25.0f);
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, trend.getCount());
+
+    // A gap longer than the window leaves only the newest sample
+    trend.update(60000000UL, 40.0f);
+    TEST_ASSERT_EQUAL_UINT32(1, trend.getCount());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, trend.getSlope());
+}
+
+void test_capacity_bounds_the_window() {
+    // 100 ms samples fill the buffer before the window
+    Estimator trend(WINDOW_MS, MIN_SAMPLES);
+    for (uint32_t i = 0; i < 3 * CAPACITY; i++) {
+        trend.update(i * 100000UL, 25.0f + (i >= 2 * CAPACITY ? 0.1f * i : 0.0f));
+    }
+    TEST_ASSERT_EQUAL_UINT32(CAPACITY, trend.getCount());
+
+    // Only the last CAPACITY samples, all on the ramp, are in the fit
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1.0f, trend.getSlope());
+}
+
+/*******************************************************************************
+ * Numerical Stability
+ ******************************************************************************/
+
+void test_matches_the_reference_over_a_long_run() {
+    Estimator trend(WINDOW_MS, MIN_SAMPLES);
+    ReferenceFit reference;
+    srand(4);
+
+    // Weeks of samples from near the 32 bit microsecond wraparound on, with
+    // a drifting level, noise at the 12 bit LSB and random sample periods
+    uint32_t nowUs = UINT32_MAX - 30000000UL;
+    float level = 25.0f;
+    float worst = 0.0f;
+    for (int i = 0; i < 1000000; i++) {
+        nowUs += (250 + rand() % 1750) * 1000UL;
+        level += noise(0.02f);
+        float value = roundf((level + noise(0.1f)) * 16.0f) / 16.0f;
+
+        float slope = trend.update(nowUs, value);
+        float expected = reference.update(nowUs, value);
+        worst = fmaxf(worst, fabsf(slope - expected));
+    }
+    TEST_ASSERT_EQUAL_UINT32(reference.size(), trend.getCount());
+
+    char message[96];
+    snprintf(message, sizeof(message), "Largest slope error over 1M updates: %.2e °C/s", worst);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_THAN(1e-4f, worst);
+}
+
+void test_update_cost() {
+    constexpr int SAMPLES = 1000000;
+    Estimator trend(WINDOW_MS, MIN_SAMPLES);
+    volatile float sink = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < SAMPLES; i++) {
+        sink = trend.update(i * 250000UL, 25.0f + (i & 15) * 0.0625f);
+    }
+    auto end = std::chrono::steady_clock::now();
+    (void)sink;
+
+    char message[96];
+    snprintf(message, sizeof(message), "update() with %u samples buffered: %.1f ns on the host",
+             static_cast<unsigned>(CAPACITY),
+             std::chrono::duration<double, std::nano>(end - start).count() / SAMPLES);
+    TEST_MESSAGE(message);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_slope_before_min_samples);
+    RUN_TEST(test_ramp_slope_at_varying_rate);
+    RUN_TEST(test_constant_timestamps_report_no_slope);
+    RUN_TEST(test_old_samples_expire);
+    RUN_TEST(test_capacity_bounds_the_window);
+    RUN_TEST(test_matches_the_reference_over_a_long_run);
+    RUN_TEST(test_update_cost);
+    return UNITY_END();
+}